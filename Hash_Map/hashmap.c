@@ -1,6 +1,229 @@
+/* strdup, write, mmap flags, syscall */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <limits.h>	   /* CHAR_BIT */
+#include <pthread.h>
+#include <stdatomic.h> /* snapshot slot bitmaps */
+#include <stdint.h>
+#include <unistd.h>
+
+#ifdef __linux__
+	#include <linux/mempolicy.h> /* MPOL_* */
+	#include <sys/mman.h>
+	#include <sys/syscall.h> /* SYS_mbind */
+#endif /* __linux__ */
+
 #include "hashmap.h"
 
-static size_t hash_djb2(str_literal str) ATTR_NONNULL;
+static int hm_writer_put(hm_writer *w, const void *data, size_t n);
+static void hm_retired_free(HashMap *hm);
+
+/* Smallest number of buckets allocated at once. */
+#define HM_SLAB_MIN ((size_t)64)
+
+/* Size and alignment of transparent huge pages. */
+#define HM_HUGEPAGE_SIZE ((size_t)1 << 21)
+
+/**
+ * struct bucket_slab - a block of buckets allocated at once.
+ * @next: the next slab of the hash map.
+ * @len: number of buckets in the slab.
+ * @mapped: non-zero if the slab was allocated with `hm_mem_alloc`'s mmap path.
+ * @buckets: the buckets.
+ */
+struct bucket_slab
+{
+	struct bucket_slab *next;
+	size_t len;
+	int mapped;
+	Bucket buckets[];
+};
+
+/* Ownership of a retired bucket's strings, see `struct hm_retired`. */
+#define HM_OWNS_KEY (1U << 0)
+#define HM_OWNS_VALUE (1U << 1)
+
+/**
+ * struct hm_retired - a bucket only reachable from snapshots.
+ * @bucket: the bucket, freed when the last snapshot is released.
+ * @owns: which of the bucket's strings are to be freed with it, the others
+ * were handed over to the bucket that replaced it.
+ */
+struct hm_retired
+{
+	Bucket *bucket;
+	unsigned int owns;
+};
+
+/**
+ * struct HashMapSnapshot - a frozen, read only view of a HashMap.
+ * @hm: the hash map.
+ * @next: next live snapshot of the same hash map.
+ * @count: number of elements at the time of the snapshot.
+ * @gen: generation of the hash map at the time of the snapshot.
+ * @preserved: bitmap of slots modified since the snapshot was taken.
+ * @saved: heads of the modified slots as they were at snapshot time.
+ *
+ * Slots not marked in `preserved` are read straight from the hash map, the
+ * writer saves a slot's head here before it first changes that slot.
+ */
+struct HashMapSnapshot
+{
+	HashMap *hm;
+	struct HashMapSnapshot *next;
+	size_t count;
+	unsigned long gen;
+	atomic_uchar *preserved;
+	Bucket **saved;
+};
+
+/**
+ * hm_mem_mapped - check if an allocation should bypass the heap.
+ * @opts: allocation options.
+ * @bytes: size of the allocation.
+ *
+ * Return: non-zero if `hm_mem_alloc` maps the memory itself.
+ */
+static int hm_mem_mapped(const hm_alloc_opts *opts, size_t bytes)
+{
+#ifdef __linux__
+	return (opts->flags != HM_ALLOC_HEAP && bytes >= HM_MMAP_THRESHOLD);
+#else
+	(void)opts;
+	(void)bytes;
+	return (0);
+#endif /* __linux__ */
+}
+
+/**
+ * hm_mem_alloc - allocate zeroed memory for a hash map table.
+ * @opts: allocation options.
+ * @bytes: size of the allocation.
+ *
+ * Return: pointer to the memory, NULL on failure.
+ */
+static void *hm_mem_alloc(const hm_alloc_opts *opts, size_t bytes)
+{
+	if (!hm_mem_mapped(opts, bytes))
+		return (calloc(1, bytes));
+
+#ifdef __linux__
+	const size_t len = (bytes + HM_HUGEPAGE_SIZE - 1) & ~(HM_HUGEPAGE_SIZE - 1);
+	const int prot = PROT_READ | PROT_WRITE;
+	const int map = MAP_PRIVATE | MAP_ANONYMOUS;
+	void *mem = MAP_FAILED;
+
+	if (opts->flags & HM_ALLOC_HUGETLB)
+		mem = mmap(NULL, len, prot, map | MAP_HUGETLB, -1, 0);
+
+	if (mem == MAP_FAILED)
+	{
+		mem = mmap(NULL, len, prot, map, -1, 0);
+		if (mem == MAP_FAILED)
+			return (NULL);
+
+		if (opts->flags & (HM_ALLOC_HUGEPAGE | HM_ALLOC_HUGETLB))
+			madvise(mem, len, MADV_HUGEPAGE);
+	}
+
+	if (opts->flags & (HM_ALLOC_NUMA_BIND | HM_ALLOC_NUMA_INTERLEAVE))
+	{
+		const int mode = (opts->flags & HM_ALLOC_NUMA_INTERLEAVE)
+							 ? MPOL_INTERLEAVE
+							 : MPOL_BIND;
+		unsigned long nodes = opts->numa_nodes;
+
+		/*
+		 * No pages have been touched yet, so all of them follow the policy.
+		 * Like huge pages, the policy is best effort: without NUMA support
+		 * or with offline nodes in the mask the pages are left unbound.
+		 */
+		(void)syscall(
+			SYS_mbind, mem, len, mode, &nodes, sizeof(nodes) * 8 + 1, 0
+		);
+	}
+
+	return (mem);
+#else
+	return (NULL);
+#endif /* __linux__ */
+}
+
+/**
+ * hm_mem_free - free memory allocated with `hm_mem_alloc`.
+ * @mem: pointer to the memory.
+ * @bytes: size that was requested from `hm_mem_alloc`.
+ * @mapped: the result of `hm_mem_mapped` for the allocation.
+ */
+static void hm_mem_free(void *mem, size_t bytes, int mapped)
+{
+	if (!mem)
+		return;
+
+	if (!mapped)
+	{
+		free(mem);
+		return;
+	}
+
+#ifdef __linux__
+	munmap(mem, (bytes + HM_HUGEPAGE_SIZE - 1) & ~(HM_HUGEPAGE_SIZE - 1));
+#else
+	(void)bytes;
+#endif /* __linux__ */
+}
+
+/**
+ * hm_array_free - free the slot array of a hash map.
+ * @hm: the hash map.
+ */
+static void hm_array_free(HashMap *hm)
+{
+	const size_t bytes = hm->size * sizeof(*hm->array);
+
+	hm_mem_free(hm->array, bytes, hm_mem_mapped(&hm->alloc, bytes));
+}
+
+/**
+ * hm_slot_get - get the first bucket of a slot from the writer's side.
+ * @hm: the hash map.
+ * @idx: index of the slot.
+ *
+ * Only the thread modifying the hash map may use this, snapshot readers go
+ * through `hm_snapshot_head`.
+ *
+ * Return: pointer to the first bucket of the slot, NULL if empty.
+ */
+static Bucket *hm_slot_get(const HashMap *hm, size_t idx)
+{
+	return (atomic_load_explicit(&hm->array[idx], memory_order_relaxed));
+}
+
+/**
+ * hm_slot_set - publish a new first bucket for a slot.
+ * @hm: the hash map.
+ * @idx: index of the slot.
+ * @b: the new first bucket, NULL to empty the slot.
+ *
+ * The release store pairs with the acquire load in `hm_snapshot_head`, so a
+ * reader that sees `b` also sees its contents and the preserved slot bit.
+ */
+static void hm_slot_set(HashMap *hm, size_t idx, Bucket *b)
+{
+	atomic_store_explicit(&hm->array[idx], b, memory_order_release);
+}
+
+/**
+ * hm_slab_free - free a slab of buckets.
+ * @slab: the slab.
+ */
+static void hm_slab_free(struct bucket_slab *slab)
+{
+	hm_mem_free(
+		slab, sizeof(*slab) + (sizeof(Bucket) * slab->len), slab->mapped
+	);
+}
 
 /**
  * hashmap_create - alloc memory for a hash map.
@@ -8,14 +231,40 @@ static size_t hash_djb2(str_literal str) ATTR_NONNULL;
  *
  * Return: pointer to the hash map success, NULL on failure.
  */
-HashMap *hashmap_create(size_t size)
+HashMap *hashmap_create(size_t size) { return (hashmap_create_ex(size, NULL)); }
+
+/**
+ * hashmap_create_ex - alloc memory for a hash map with allocation options.
+ * @size: size of the hash map.
+ * @opts: how to allocate the slot array and buckets, NULL for the heap.
+ *
+ * Return: pointer to the hash map success, NULL on failure or if a NUMA
+ * flag is given with an empty `numa_nodes` mask.
+ */
+HashMap *hashmap_create_ex(size_t size, const hm_alloc_opts *opts)
 {
-	HashMap *table = calloc(1, sizeof(*table));
+	HashMap *table = NULL;
+
+	if (opts &&
+		(opts->flags & (HM_ALLOC_NUMA_BIND | HM_ALLOC_NUMA_INTERLEAVE)) &&
+		!opts->numa_nodes)
+	{
+		errno = EINVAL;
+		perror("Failed to allocate memory for HashMap");
+		return (NULL);
+	}
+
+	table = calloc(1, sizeof(*table));
+	if (table && opts)
+		table->alloc = *opts;
 
 	if (table && size)
 	{
 		table->size = size;
-		table->array = calloc(size, sizeof(*(table->array)));
+		if (size <= SIZE_MAX / sizeof(*(table->array)))
+			table->array =
+				hm_mem_alloc(&table->alloc, size * sizeof(*(table->array)));
+
 		if (!table->array)
 		{
 			free(table);
@@ -35,29 +284,32 @@ HashMap *hashmap_create(size_t size)
  */
 void hashmap_delete(HashMap *hm)
 {
-	Bucket *front_foot = NULL, *back_foot = NULL;
+	Bucket *walk = NULL;
+	struct bucket_slab *slab = NULL;
 	size_t i = 0;
 
 	if (!hm)
 		return;
 
+	hm_retired_free(hm);
+	free(hm->retired);
 	for (i = 0; hm->array && i < hm->size; i++)
 	{
-		if (!hm->array[i])
-			continue;
-
-		front_foot = hm->array[i];
-		while (front_foot)
+		for (walk = hm_slot_get(hm, i); walk; walk = walk->next)
 		{
-			back_foot = front_foot;
-			front_foot = front_foot->next;
-			free(back_foot->key);
-			free(back_foot->value);
-			free(back_foot);
+			free(walk->key);
+			free(walk->value);
 		}
 	}
 
-	free(hm->array);
+	while (hm->slabs)
+	{
+		slab = hm->slabs;
+		hm->slabs = slab->next;
+		hm_slab_free(slab);
+	}
+
+	hm_array_free(hm);
 	free(hm);
 }
 
@@ -67,7 +319,7 @@ void hashmap_delete(HashMap *hm)
  *
  * Return: an int representing the hash.
  */
-static size_t hash_djb2(str_literal str)
+size_t hash_djb2(str_literal str)
 {
 	size_t hash = 5381;
 	int c;
@@ -93,6 +345,42 @@ size_t get_index(str_literal key, size_t size)
 	return (0);
 }
 
+/**
+ * keys_equal - compare two keys, either of which may be NULL
+ * @a: the first key
+ * @b: the second key
+ *
+ * Return: non-zero if the keys are equal
+ */
+static int keys_equal(const char *a, const char *b)
+{
+	if (!a || !b)
+		return (a == b);
+
+	return (!strcmp(a, b));
+}
+
+/**
+ * chain_find - find a key in the buckets of a slot
+ * @walk: first bucket of the slot
+ * @key: key to look for
+ * @hash: hash of the key
+ *
+ * Return: pointer to the bucket, NULL if not found
+ */
+static Bucket *chain_find(Bucket *walk, str_literal key, size_t hash)
+{
+	while (walk)
+	{
+		if (walk->hash == hash && keys_equal((const char *)key, walk->key))
+			return (walk);
+
+		walk = walk->next;
+	}
+
+	return (NULL);
+}
+
 /**
  * hashmap_get - retrieves the bucket associated with a key
  * @hm: a pointer to a hashmap struct
@@ -102,59 +390,275 @@ size_t get_index(str_literal key, size_t size)
  */
 Bucket *hashmap_get(const HashMap *hm, str_literal key)
 {
-	Bucket *walk = NULL;
-	size_t hash = 0;
-
-	if (!hm)
+	if (!hm || !hm->array)
 		return (NULL);
 
-	hash = key ? hash_djb2(key) : 0;
-	walk = hm->array[get_index(key, hm->size)];
-	while (walk)
+	return (chain_find(
+		hm_slot_get(hm, get_index(key, hm->size)), key, key ? hash_djb2(key) : 0
+	));
+}
+
+/**
+ * bucket_fill - set the key and value of a bucket to copies of the inputs.
+ * @b: the bucket.
+ * @key: the key, may be NULL.
+ * @val: the value, may be NULL.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int bucket_fill(Bucket *b, const char *key, const char *val)
+{
+	b->hash = key ? hash_djb2((str_literal)key) : 0;
+	b->key = key ? strdup(key) : NULL;
+	b->value = val ? strdup(val) : NULL;
+	if ((val && !b->value) || (key && !b->key))
 	{
-		if (walk->hash == hash)
-			if (!walk->key || !strcmp((const char *)key, walk->key))
-				return (walk);
+		free(b->value);
+		free(b->key);
+		b->value = NULL;
+		b->key = NULL;
+		return (0);
+	}
 
-		walk = walk->next;
+	return (1);
+}
+
+/**
+ * hashmap_add_slab - allocate a slab of unused buckets for a hash map.
+ * @hm: the hash map.
+ * @len: number of buckets in the slab.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int hashmap_add_slab(HashMap *hm, size_t len)
+{
+	struct bucket_slab *slab = NULL;
+	size_t i = 0, bytes = 0;
+
+	if (!len || len > (SIZE_MAX - sizeof(*slab)) / sizeof(Bucket))
+		return (0);
+
+	bytes = sizeof(*slab) + (sizeof(Bucket) * len);
+	slab = hm_mem_alloc(&hm->alloc, bytes);
+	if (!slab)
+		return (0);
+
+	slab->len = len;
+	slab->mapped = hm_mem_mapped(&hm->alloc, bytes);
+	slab->next = hm->slabs;
+	hm->slabs = slab;
+	for (i = len; i > 0; --i)
+	{
+		slab->buckets[i - 1].next = hm->spare;
+		hm->spare = &slab->buckets[i - 1];
 	}
 
-	return (NULL);
+	hm->capacity += len;
+	return (1);
 }
 
 /**
- * add_bucket_head - adds a new node to the beginning of a linked list
- * @h: address of the pointer to the first node
- * @val: data to be added
- * @key: more data
+ * hashmap_bucket_new - take an unused bucket from a hash map's slabs.
+ * @hm: the hash map.
+ *
+ * Slabs grow geometrically so that bulk inserts allocate O(log n) times.
  *
- * Return: pointer to the just created node
+ * Return: pointer to the bucket, NULL on failure.
  */
-void *add_bucket_head(Bucket **h, const char *key, const char *val)
+static Bucket *hashmap_bucket_new(HashMap *hm)
 {
-	Bucket *nw_node = NULL;
+	Bucket *b = NULL;
 
-	if (!h)
+	if (!hm->spare &&
+		!hashmap_add_slab(hm, hm->count > HM_SLAB_MIN ? hm->count : HM_SLAB_MIN))
 		return (NULL);
 
-	nw_node = calloc(1, sizeof(*nw_node));
-	if (!nw_node)
-		return (NULL);
+	b = hm->spare;
+	hm->spare = b->next;
+	*b = (Bucket){.gen = hm->gen};
+	return (b);
+}
+
+/**
+ * hm_bucket_frozen - check if a bucket may be visible to a snapshot.
+ * @hm: the hash map.
+ * @b: a bucket of the hash map.
+ *
+ * Return: non-zero if the bucket must not be modified in place.
+ */
+static int hm_bucket_frozen(const HashMap *hm, const Bucket *b)
+{
+	return (hm->snapshots && b->gen < hm->gen);
+}
+
+/**
+ * hm_slot_preserve - save a slot for the snapshots before modifying it.
+ * @hm: the hash map.
+ * @idx: index of the slot about to be modified.
+ */
+static void hm_slot_preserve(HashMap *hm, size_t idx)
+{
+	const unsigned char bit = 1U << (idx % CHAR_BIT);
+	HashMapSnapshot *snap = NULL;
 
-	nw_node->hash = key ? hash_djb2((str_literal)key) : 0;
-	nw_node->key = key ? strdup(key) : NULL;
-	nw_node->value = val ? strdup(val) : NULL;
-	if ((val && !nw_node->value) || (key && !nw_node->key))
+	for (snap = hm->snapshots; snap; snap = snap->next)
 	{
-		free(nw_node->value);
-		free(nw_node->key);
-		free(nw_node);
-		return (NULL);
+		atomic_uchar *const bits = &snap->preserved[idx / CHAR_BIT];
+
+		if (atomic_load_explicit(bits, memory_order_relaxed) & bit)
+			continue;
+
+		snap->saved[idx] = hm_slot_get(hm, idx);
+		atomic_fetch_or_explicit(bits, bit, memory_order_release);
+	}
+}
+
+/**
+ * hm_retired_reserve - make room to retire one more bucket.
+ * @hm: the hash map.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int hm_retired_reserve(HashMap *hm)
+{
+	struct hm_retired *r = NULL;
+	size_t cap = hm->retired_cap ? hm->retired_cap * 2 : HM_SLAB_MIN;
+
+	if (hm->retired_len < hm->retired_cap)
+		return (1);
+
+	r = realloc(hm->retired, cap * sizeof(*r));
+	if (!r)
+		return (0);
+
+	hm->retired = r;
+	hm->retired_cap = cap;
+	return (1);
+}
+
+/**
+ * hm_retire - keep a bucket alive until all snapshots are released.
+ * @hm: the hash map, `hm_retired_reserve` must have succeeded.
+ * @b: a bucket no longer reachable from the hash map.
+ * @owns: HM_OWNS_* flags of the strings to free with the bucket.
+ */
+static void hm_retire(HashMap *hm, Bucket *b, unsigned int owns)
+{
+	hm->retired[hm->retired_len++] = (struct hm_retired){b, owns};
+}
+
+/**
+ * hm_retired_free - free all retired buckets.
+ * @hm: the hash map, it must not have live snapshots.
+ */
+static void hm_retired_free(HashMap *hm)
+{
+	size_t i = 0;
+
+	for (i = 0; i < hm->retired_len; ++i)
+	{
+		Bucket *const b = hm->retired[i].bucket;
+
+		if (hm->retired[i].owns & HM_OWNS_KEY)
+			free(b->key);
+
+		if (hm->retired[i].owns & HM_OWNS_VALUE)
+			free(b->value);
+
+		b->next = hm->spare;
+		hm->spare = b;
+	}
+
+	hm->retired_len = 0;
+}
+
+/**
+ * hm_link_set - point the link in front of a bucket somewhere else.
+ * @hm: the hash map.
+ * @idx: slot of the link.
+ * @prev: the bucket holding the link, NULL for the head of the slot.
+ * @b: the new target of the link.
+ */
+static void hm_link_set(HashMap *hm, size_t idx, Bucket *prev, Bucket *b)
+{
+	if (prev)
+		prev->next = b;
+	else
+		hm_slot_set(hm, idx, b);
+}
+
+/**
+ * hm_cow_link - make the buckets in front of a bucket writable.
+ * @hm: the hash map.
+ * @idx: slot of the bucket.
+ * @target: the bucket, NULL to make the whole slot writable.
+ *
+ * Frozen buckets in front of `target` are replaced with copies, sharing
+ * their strings, and retired. Copies keep the generation of the original
+ * so that the shared strings are never freed in place.
+ *
+ * Return: 1 on success with the bucket in front of `target` in `*prev`,
+ * NULL if `target` is first in the slot. 0 on failure.
+ */
+static int hm_cow_link(
+	HashMap *hm, size_t idx, const Bucket *target, Bucket **prev
+)
+{
+	Bucket *walk = NULL, *clone = NULL;
+
+	*prev = NULL;
+	hm_slot_preserve(hm, idx);
+	while ((walk = *prev ? (*prev)->next : hm_slot_get(hm, idx)) != target)
+	{
+		if (hm_bucket_frozen(hm, walk))
+		{
+			if (!hm_retired_reserve(hm))
+				return (0);
+
+			clone = hashmap_bucket_new(hm);
+			if (!clone)
+				return (0);
+
+			*clone = *walk;
+			hm_retire(hm, walk, 0);
+			hm_link_set(hm, idx, *prev, clone);
+			walk = clone;
+		}
+
+		*prev = walk;
 	}
 
-	nw_node->next = *h;
-	*h = nw_node;
-	return (nw_node);
+	return (1);
+}
+
+/**
+ * hm_cow_unshare - get a bucket that can be modified in place.
+ * @hm: the hash map.
+ * @b: a bucket of the hash map.
+ * @owns: HM_OWNS_* flags of the strings the snapshots keep if `b` is frozen.
+ *
+ * Return: `b` if it was not frozen, otherwise its replacement, which holds
+ * the strings not in `owns`. NULL on failure.
+ */
+static Bucket *hm_cow_unshare(HashMap *hm, Bucket *b, unsigned int owns)
+{
+	Bucket *prev = NULL, *clone = NULL;
+	const size_t idx = b->hash % hm->size;
+
+	if (!hm_bucket_frozen(hm, b))
+		return (b);
+
+	if (!hm_cow_link(hm, idx, b, &prev) || !hm_retired_reserve(hm))
+		return (NULL);
+
+	clone = hashmap_bucket_new(hm);
+	if (!clone)
+		return (NULL);
+
+	*clone = *b;
+	hm_retire(hm, b, owns);
+	hm_link_set(hm, idx, prev, clone);
+	return (clone);
 }
 
 /**
@@ -176,71 +680,1109 @@ int hashmap_insert(HashMap *hm, const char *key, const char *value)
 	b = hashmap_get(hm, (str_literal)key);
 	if (b)
 	{
-		free(b->value);
-		b->value = value ? strdup(value) : NULL;
-		if (value && !b->value)
+		char *const new_value = value ? strdup(value) : NULL;
+		Bucket *const u = new_value || !value
+							  ? hm_cow_unshare(hm, b, HM_OWNS_VALUE)
+							  : NULL;
+
+		if (!u)
+		{
+			free(new_value);
 			return (0);
+		}
+
+		if (u == b)
+			free(b->value);
+
+		u->value = new_value;
 	}
 	else
 	{
-		id = get_index((str_literal)key, hm->size);
-		if (!add_bucket_head(&(hm->array[id]), key, value))
+		b = hashmap_bucket_new(hm);
+		if (!b)
+			return (0);
+
+		if (!bucket_fill(b, key, value))
+		{
+			b->next = hm->spare;
+			hm->spare = b;
 			return (0);
+		}
+
+		id = b->hash % hm->size;
+		hm_slot_preserve(hm, id);
+		b->next = hm_slot_get(hm, id);
+		hm_slot_set(hm, id, b);
+		++hm->count;
 	}
 
 	return (1);
 }
 
 /**
- * hashmap_print - prints out all key value pairs of a hash table
- * @hm: pointer to a struct containing information about the struct
+ * hashmap_remove - delete a key and its value from a hash table
+ * @hm: pointer to a hash table struct
+ * @key: key to delete
+ *
+ * The bucket is kept for reuse, see `hashmap_shrink_to_fit`.
+ *
+ * Return: 1 if the key was removed, 0 if it was not found or on failure
  */
-void hashmap_print(const HashMap *hm)
+int hashmap_remove(HashMap *hm, const char *key)
 {
-	Bucket *walk = NULL;
-	size_t i = 0;
-	char comma = '\0', space = '\0';
+	Bucket *prev = NULL, *walk = NULL;
+	size_t hash = 0, idx = 0;
 
-	if (!hm)
-		return;
+	if (!hm || !hm->array || !hm->size)
+		return (0);
 
-	printf("{");
-	for (i = 0; i < hm->size; ++i)
-	{
-		if (comma && space)
-			break;
+	hash = key ? hash_djb2((str_literal)key) : 0;
+	idx = hash % hm->size;
+	walk = chain_find(hm_slot_get(hm, idx), (str_literal)key, hash);
+	if (!walk)
+		return (0);
 
-		if (!hm->array[i])
-			continue;
+	if (!hm_cow_link(hm, idx, walk, &prev) ||
+		(hm_bucket_frozen(hm, walk) && !hm_retired_reserve(hm)))
+		return (0);
 
-		walk = hm->array[i];
-		while (walk)
-		{
-			if (comma && space)
-			{
-				putchar(comma);
-				putchar(space);
-			}
+	hm_link_set(hm, idx, prev, walk->next);
+	--hm->count;
+	if (hm_bucket_frozen(hm, walk))
+	{
+		hm_retire(hm, walk, HM_OWNS_KEY | HM_OWNS_VALUE);
+		return (1);
+	}
+
+	free(walk->key);
+	free(walk->value);
+	walk->next = hm->spare;
+	hm->spare = walk;
+	return (1);
+}
+
+/**
+ * hashmap_rebuild - move all buckets of a hash table into a new slot array.
+ * @hm: pointer to a hash table struct
+ * @size: number of slots in the new slot array, greater than 0
+ * @compact: if non-zero, also move the buckets into a single slab of
+ * exactly `count` buckets and release all other slabs
+ *
+ * Buckets are relinked in place, so this is refused while snapshots are live.
+ *
+ * Return: 1 on success, 0 on failure, the hash table is unchanged on failure
+ */
+static int hashmap_rebuild(HashMap *hm, size_t size, int compact)
+{
+	_Atomic(Bucket *) *array = NULL;
+	struct bucket_slab *old_slabs = hm->slabs, *slab = NULL;
+	Bucket *old_spare = hm->spare, *walk = NULL, *next = NULL, *b = NULL;
+	size_t old_capacity = hm->capacity, i = 0, used = 0;
+
+	if (hm->snapshots || size > SIZE_MAX / sizeof(*array))
+		return (0);
 
-			printf("'%s': '%s'", walk->key, walk->value);
-			comma = ',';
-			space = ' ';
-			walk = walk->next;
+	array = hm_mem_alloc(&hm->alloc, size * sizeof(*array));
+	if (!array)
+		return (0);
+
+	if (compact)
+	{
+		hm->slabs = NULL;
+		hm->spare = NULL;
+		hm->capacity = 0;
+		if (hm->count && !hashmap_add_slab(hm, hm->count))
+		{
+			hm->slabs = old_slabs;
+			hm->spare = old_spare;
+			hm->capacity = old_capacity;
+			hm_mem_free(
+				array, size * sizeof(*array),
+				hm_mem_mapped(&hm->alloc, size * sizeof(*array))
+			);
+			return (0);
+		}
+
+		/* The slab's free list is not needed, buckets are taken in order. */
+		hm->spare = NULL;
+	}
+
+	for (i = 0; hm->array && i < hm->size; ++i)
+	{
+		for (walk = hm_slot_get(hm, i); walk; walk = next)
+		{
+			next = walk->next;
+			b = compact ? &hm->slabs->buckets[used++] : walk;
+			*b = *walk;
+			/* Not published yet, the pointer swap below needs no snapshot. */
+			b->next = atomic_load_explicit(
+				&array[b->hash % size], memory_order_relaxed
+			);
+			atomic_store_explicit(
+				&array[b->hash % size], b, memory_order_relaxed
+			);
 		}
 	}
 
-	for (; i < hm->size; i++)
+	if (compact)
 	{
-		if (!hm->array[i])
+		while (old_slabs)
+		{
+			slab = old_slabs;
+			old_slabs = slab->next;
+			hm_slab_free(slab);
+		}
+	}
+
+	hm_array_free(hm);
+	hm->array = array;
+	hm->size = size;
+	return (1);
+}
+
+/**
+ * hashmap_reserve - prepare a hash table to hold at least `n` elements
+ * @hm: pointer to a hash table struct
+ * @n: number of elements expected
+ *
+ * The slot array is grown to at least `n` slots and enough buckets for
+ * `n` elements are allocated in a single block, so that inserting up to
+ * `n` elements needs no further bucket allocations. The slot array can not
+ * grow while snapshots of the hash table are live.
+ *
+ * Return: 1 on success, 0 on failure
+ */
+int hashmap_reserve(HashMap *hm, size_t n)
+{
+	if (!hm)
+		return (0);
+
+	if (n > hm->size && !hashmap_rebuild(hm, n, 0))
+		return (0);
+
+	if (n > hm->capacity && !hashmap_add_slab(hm, n - hm->capacity))
+		return (0);
+
+	return (1);
+}
+
+/**
+ * hashmap_shrink_to_fit - release memory not needed by the current elements
+ * @hm: pointer to a hash table struct
+ *
+ * The slot array is resized to one slot per element, and the buckets are
+ * packed into a single block. Fails while snapshots of the hash table are
+ * live.
+ *
+ * Return: 1 on success, 0 on failure
+ */
+int hashmap_shrink_to_fit(HashMap *hm)
+{
+	size_t size = 0;
+
+	if (!hm)
+		return (0);
+
+	size = hm->count ? hm->count : 1;
+	if (size == hm->size && hm->capacity == hm->count)
+		return (1);
+
+	return (hashmap_rebuild(hm, size, hm->capacity != hm->count));
+}
+
+/**
+ * hashmap_print - prints out all key value pairs of a hash table
+ * @hm: pointer to a struct containing information about the struct
+ */
+void hashmap_print(const HashMap *hm)
+{
+	hm_writer w;
+
+	if (!hm || !hm_writer_init_stream(&w, stdout, HM_FORMAT_TEXT))
+		return;
+
+	if (hashmap_write(hm, &w))
+		putchar('\n');
+
+	hm_writer_release(&w);
+}
+
+/**
+ * hm_writer_init - set up a writer with an empty staging buffer.
+ * @w: the writer to initialise.
+ * @stream: FILE sink, may be NULL.
+ * @fd: file descriptor sink, may be -1.
+ * @format: the output format.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int
+hm_writer_init(hm_writer *w, FILE *stream, int fd, enum hm_format format)
+{
+	if (!w)
+		return (0);
+
+	*w = (hm_writer){.stream = stream, .fd = fd, .format = format};
+	w->buf = malloc(HM_WRITER_BUFSIZE);
+	if (!w->buf)
+		return (0);
+
+	w->cap = HM_WRITER_BUFSIZE;
+	return (1);
+}
+
+/**
+ * hm_writer_init_stream - set up a writer that outputs to a FILE.
+ * @w: the writer to initialise.
+ * @stream: the FILE to write to.
+ * @format: the output format.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int hm_writer_init_stream(hm_writer *w, FILE *stream, enum hm_format format)
+{
+	if (!stream)
+		return (0);
+
+	return (hm_writer_init(w, stream, -1, format));
+}
+
+/**
+ * hm_writer_init_fd - set up a writer that outputs to a file descriptor.
+ * @w: the writer to initialise.
+ * @fd: the file descriptor to write to.
+ * @format: the output format.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int hm_writer_init_fd(hm_writer *w, int fd, enum hm_format format)
+{
+	if (fd < 0)
+		return (0);
+
+	return (hm_writer_init(w, NULL, fd, format));
+}
+
+/**
+ * hm_writer_init_mem - set up a writer that collects output in memory.
+ * @w: the writer to initialise.
+ * @format: the output format.
+ *
+ * The output is available in `w->buf` and is `w->len` bytes long.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int hm_writer_init_mem(hm_writer *w, enum hm_format format)
+{
+	return (hm_writer_init(w, NULL, -1, format));
+}
+
+/**
+ * write_all - write a whole buffer to a file descriptor.
+ * @fd: the file descriptor.
+ * @data: the bytes to write.
+ * @n: number of bytes to write.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int write_all(int fd, const char *data, size_t n)
+{
+	while (n)
+	{
+		ssize_t written = write(fd, data, n);
+
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			return (0);
+		}
+
+		data += written;
+		n -= written;
+	}
+
+	return (1);
+}
+
+/**
+ * hm_writer_sink - hand bytes directly to the sink of a writer.
+ * @w: the writer.
+ * @data: the bytes to output.
+ * @n: number of bytes.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int hm_writer_sink(hm_writer *w, const void *data, size_t n)
+{
+	if (w->stream)
+		return (fwrite(data, 1, n, w->stream) == n);
+
+	return (write_all(w->fd, data, n));
+}
+
+/**
+ * hm_writer_flush - push buffered output to the sink.
+ * @w: the writer.
+ *
+ * Memory sinks are left untouched.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int hm_writer_flush(hm_writer *w)
+{
+	if (!w)
+		return (0);
+
+	if (!w->stream && w->fd < 0)
+		return (1);
+
+	if (w->len && !hm_writer_sink(w, w->buf, w->len))
+		return (0);
+
+	w->len = 0;
+	if (w->stream && fflush(w->stream))
+		return (0);
+
+	return (1);
+}
+
+/**
+ * hm_writer_release - flush a writer and free its buffer.
+ * @w: the writer.
+ */
+void hm_writer_release(hm_writer *w)
+{
+	if (!w)
+		return;
+
+	hm_writer_flush(w);
+	free(w->buf);
+	*w = (hm_writer){.fd = -1};
+}
+
+/**
+ * hm_writer_put - append bytes to a writer.
+ * @w: the writer.
+ * @data: the bytes to append.
+ * @n: number of bytes.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int hm_writer_put(hm_writer *w, const void *data, size_t n)
+{
+	if (n <= w->cap - w->len)
+	{
+		memcpy(w->buf + w->len, data, n);
+		w->len += n;
+		return (1);
+	}
+
+	if (w->stream || w->fd >= 0)
+	{
+		if (!hm_writer_flush(w))
+			return (0);
+
+		/* Too big to be worth staging. */
+		if (n > w->cap)
+			return (hm_writer_sink(w, data, n));
+	}
+	else
+	{
+		size_t new_cap = w->cap ? w->cap : HM_WRITER_BUFSIZE;
+		char *new_buf = NULL;
+
+		while (new_cap - w->len < n)
+			new_cap *= 2;
+
+		new_buf = realloc(w->buf, new_cap);
+		if (!new_buf)
+			return (0);
+
+		w->buf = new_buf;
+		w->cap = new_cap;
+	}
+
+	memcpy(w->buf + w->len, data, n);
+	w->len += n;
+	return (1);
+}
+
+/**
+ * hm_writer_put_json_str - append a string as an escaped JSON string.
+ * @w: the writer.
+ * @str: the string, NULL is written as an empty string.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int hm_writer_put_json_str(hm_writer *w, const char *str)
+{
+	static const char hex[] = "0123456789abcdef";
+	const unsigned char *run = (const unsigned char *)(str ? str : "");
+	const unsigned char *c = run;
+
+	if (!hm_writer_put(w, "\"", 1))
+		return (0);
+
+	for (; *c; ++c)
+	{
+		char esc[6] = {'\\', 0, '0', '0', 0, 0};
+		size_t esc_len = 2;
+
+		if (*c >= 0x20 && *c != '"' && *c != '\\')
 			continue;
 
-		walk = hm->array[i];
-		while (walk)
+		switch (*c)
 		{
-			printf(", '%s': '%s'", walk->key, walk->value);
-			walk = walk->next;
+		case '"':
+		case '\\': esc[1] = *c; break;
+		case '\b': esc[1] = 'b'; break;
+		case '\f': esc[1] = 'f'; break;
+		case '\n': esc[1] = 'n'; break;
+		case '\r': esc[1] = 'r'; break;
+		case '\t': esc[1] = 't'; break;
+		default:
+			esc[1] = 'u';
+			esc[4] = hex[*c >> 4];
+			esc[5] = hex[*c & 0xF];
+			esc_len = sizeof(esc);
+			break;
 		}
+
+		if (!hm_writer_put(w, run, c - run) || !hm_writer_put(w, esc, esc_len))
+			return (0);
+
+		run = c + 1;
 	}
 
-	printf("}\n");
+	return (hm_writer_put(w, run, c - run) && hm_writer_put(w, "\"", 1));
+}
+
+/**
+ * hm_writer_put_binary_str - append a length prefixed string.
+ * @w: the writer.
+ * @str: the string, may be NULL.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int hm_writer_put_binary_str(hm_writer *w, const char *str)
+{
+	size_t len = str ? strlen(str) : 0;
+	uint32_t n = str ? (uint32_t)len : UINT32_MAX;
+	unsigned char prefix[4] = {n & 0xFF, (n >> 8) & 0xFF, (n >> 16) & 0xFF,
+							   (n >> 24) & 0xFF};
+
+	if (len >= UINT32_MAX)
+		return (0);
+
+	return (
+		hm_writer_put(w, prefix, sizeof(prefix)) &&
+		(!len || hm_writer_put(w, str, len))
+	);
+}
+
+/**
+ * hm_writer_put_text_str - append a string surrounded by single quotes.
+ * @w: the writer.
+ * @str: the string, NULL is written as "(null)".
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int hm_writer_put_text_str(hm_writer *w, const char *str)
+{
+	if (!str)
+		return (hm_writer_put(w, "'(null)'", sizeof("'(null)'") - 1));
+
+	return (
+		hm_writer_put(w, "'", 1) && hm_writer_put(w, str, strlen(str)) &&
+		hm_writer_put(w, "'", 1)
+	);
+}
+
+/**
+ * hm_writer_put_entry - append a key value pair.
+ * @w: the writer.
+ * @b: the bucket holding the pair.
+ * @first: non-zero if this is the first pair of the map.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int hm_writer_put_entry(hm_writer *w, const Bucket *b, int first)
+{
+	switch (w->format)
+	{
+	case HM_FORMAT_TEXT:
+		return (
+			(first || hm_writer_put(w, ", ", 2)) &&
+			hm_writer_put_text_str(w, b->key) && hm_writer_put(w, ": ", 2) &&
+			hm_writer_put_text_str(w, b->value)
+		);
+	case HM_FORMAT_JSON:
+		if (!(first || hm_writer_put(w, ", ", 2)) ||
+			!hm_writer_put_json_str(w, b->key) || !hm_writer_put(w, ": ", 2))
+			return (0);
+
+		if (!b->value)
+			return (hm_writer_put(w, "null", 4));
+
+		return (hm_writer_put_json_str(w, b->value));
+	case HM_FORMAT_BINARY:
+		return (
+			hm_writer_put_binary_str(w, b->key) &&
+			hm_writer_put_binary_str(w, b->value)
+		);
+	default:
+		return (0);
+	}
+}
+
+/**
+ * struct hm_merge_part - buckets of a merge bound for one range of slots.
+ * @dst: the destination hash map.
+ * @combine: function combining the values of duplicate keys, may be NULL.
+ * @in: lists of buckets bound for the range.
+ * @n_in: number of lists in `in`.
+ * @spare: buckets freed by merging duplicate keys.
+ * @added: number of buckets added to the destination.
+ */
+struct hm_merge_part
+{
+	HashMap *dst;
+	hm_combine *combine;
+	Bucket **in;
+	size_t n_in;
+	Bucket *spare;
+	size_t added;
+};
+
+/**
+ * hm_merge_bucket - move a bucket from another hash map into a hash map.
+ * @part: merge state of the slot range the bucket belongs to.
+ * @b: the bucket, its slot must be in `part`'s range.
+ */
+static void hm_merge_bucket(struct hm_merge_part *part, Bucket *b)
+{
+	HashMap *const dst = part->dst;
+	const size_t idx = b->hash % dst->size;
+	Bucket *const existing =
+		chain_find(hm_slot_get(dst, idx), (str_literal)b->key, b->hash);
+	char *value = NULL;
+
+	if (!existing)
+	{
+		b->gen = dst->gen;
+		b->next = hm_slot_get(dst, idx);
+		hm_slot_set(dst, idx, b);
+		++part->added;
+		return;
+	}
+
+	value = part->combine ? part->combine(existing->value, b->value)
+						  : b->value;
+	if (value != existing->value)
+		free(existing->value);
+
+	if (value != b->value)
+		free(b->value);
+
+	existing->value = value;
+	free(b->key);
+	b->next = part->spare;
+	part->spare = b;
+}
+
+/**
+ * hm_merge_part_run - merge the buckets bound for a range of slots.
+ * @arg: pointer to a `struct hm_merge_part`.
+ *
+ * Return: NULL always.
+ */
+static void *hm_merge_part_run(void *arg)
+{
+	struct hm_merge_part *const part = arg;
+	Bucket *b = NULL;
+	size_t i = 0;
+
+	for (i = 0; i < part->n_in; ++i)
+	{
+		while ((b = part->in[i]))
+		{
+			part->in[i] = b->next;
+			hm_merge_bucket(part, b);
+		}
+	}
+
+	return (NULL);
+}
+
+/**
+ * hm_merge_adopt - take over the storage of an emptied source hash map.
+ * @dst: the destination hash map.
+ * @src: the source hash map, all its buckets are already in `dst`.
+ * @parts: merge states holding the freed buckets.
+ * @n_parts: number of merge states.
+ */
+static void hm_merge_adopt(
+	HashMap *dst, HashMap *src, struct hm_merge_part *parts, size_t n_parts
+)
+{
+	struct bucket_slab **tail = &dst->slabs;
+	size_t i = 0;
+
+	for (i = 0; i < n_parts; ++i)
+	{
+		dst->count += parts[i].added;
+		while (parts[i].spare)
+		{
+			Bucket *const b = parts[i].spare;
+
+			parts[i].spare = b->next;
+			b->next = dst->spare;
+			dst->spare = b;
+		}
+	}
+
+	while (src->spare)
+	{
+		Bucket *const b = src->spare;
+
+		src->spare = b->next;
+		b->next = dst->spare;
+		dst->spare = b;
+	}
+
+	while (*tail)
+		tail = &(*tail)->next;
+
+	*tail = src->slabs;
+	dst->capacity += src->capacity;
+	src->slabs = NULL;
+	src->capacity = 0;
+	src->count = 0;
+	for (i = 0; src->array && i < src->size; ++i)
+		hm_slot_set(src, i, NULL);
+}
+
+/**
+ * hm_merge_check - check that two hash maps can be merged.
+ * @dst: the destination hash map.
+ * @src: the source hash map.
+ *
+ * Return: 1 if they can be merged, 0 otherwise.
+ */
+static int hm_merge_check(const HashMap *dst, const HashMap *src)
+{
+	return (
+		dst && src && dst != src && dst->array && dst->size &&
+		!dst->snapshots && !src->snapshots
+	);
+}
+
+/**
+ * hashmap_merge - move all elements of a hash map into another.
+ * @dst: the destination hash map.
+ * @src: the source hash map, it is left empty.
+ * @combine: function that combines the values of keys found in both maps,
+ * if NULL the value from `src` replaces the one in `dst`.
+ *
+ * Buckets are moved with their cached hashes and strings, nothing is copied
+ * or rehashed, and `dst` takes over the slabs of `src`. Neither map may have
+ * live snapshots.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int hashmap_merge(HashMap *dst, HashMap *src, hm_combine *combine)
+{
+	struct hm_merge_part part = {0};
+	Bucket *b = NULL;
+	size_t i = 0;
+
+	if (!hm_merge_check(dst, src))
+		return (0);
+
+	part = (struct hm_merge_part){.dst = dst, .combine = combine};
+	for (i = 0; src->array && i < src->size; ++i)
+	{
+		while ((b = hm_slot_get(src, i)))
+		{
+			hm_slot_set(src, i, b->next);
+			hm_merge_bucket(&part, b);
+		}
+	}
+
+	hm_merge_adopt(dst, src, &part, 1);
+	return (1);
+}
+
+/**
+ * struct hm_merge_split - distribution of source slots to merge ranges.
+ * @src: the source hash map.
+ * @begin: first source slot to distribute.
+ * @end: one past the last source slot to distribute.
+ * @dst_size: number of slots in the destination map.
+ * @range: number of destination slots in each range.
+ * @out: one list of buckets per range, `stride` pointers apart.
+ * @stride: distance between the lists in `out`.
+ */
+struct hm_merge_split
+{
+	HashMap *src;
+	size_t begin;
+	size_t end;
+	size_t dst_size;
+	size_t range;
+	Bucket **out;
+	size_t stride;
+};
+
+/**
+ * hm_merge_split_run - sort source buckets by destination range.
+ * @arg: pointer to a `struct hm_merge_split`.
+ *
+ * Return: NULL always.
+ */
+static void *hm_merge_split_run(void *arg)
+{
+	struct hm_merge_split *const split = arg;
+	Bucket *b = NULL;
+	size_t i = 0, r = 0;
+
+	for (i = split->begin; i < split->end; ++i)
+	{
+		while ((b = hm_slot_get(split->src, i)))
+		{
+			hm_slot_set(split->src, i, b->next);
+			r = ((b->hash % split->dst_size) / split->range) * split->stride;
+			b->next = split->out[r];
+			split->out[r] = b;
+		}
+	}
+
+	return (NULL);
+}
+
+/**
+ * hm_run_threads - run a function over an array of arguments in parallel.
+ * @run: the function.
+ * @args: the arguments.
+ * @arg_size: size of each argument.
+ * @n: number of arguments.
+ * @threads: space for `n` thread ids.
+ *
+ * Arguments whose thread can not be started are run by the calling thread.
+ */
+static void hm_run_threads(
+	void *(*run)(void *), void *args, size_t arg_size, size_t n,
+	pthread_t *threads
+)
+{
+	char *started = calloc(n, sizeof(*started));
+	size_t i = 0;
+
+	for (i = 0; i < n; ++i)
+	{
+		void *const arg = (char *)args + (arg_size * i);
+
+		if (started && !pthread_create(&threads[i], NULL, run, arg))
+			started[i] = 1;
+		else
+			run(arg);
+	}
+
+	for (i = 0; started && i < n; ++i)
+		if (started[i])
+			pthread_join(threads[i], NULL);
+
+	free(started);
+}
+
+/**
+ * hashmap_merge_parallel - move all elements of a hash map into another
+ * using several threads.
+ * @dst: the destination hash map.
+ * @src: the source hash map, it is left empty.
+ * @combine: as for `hashmap_merge`, it must be safe to call from several
+ * threads at once.
+ * @n_threads: number of threads to use, 0 for one per online processor.
+ *
+ * The slots of `dst` are split into one contiguous range per thread. The
+ * threads first sort slices of `src` by destination range, then each thread
+ * merges the buckets bound for its own range, so no locks are needed.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int hashmap_merge_parallel(
+	HashMap *dst, HashMap *src, hm_combine *combine, unsigned int n_threads
+)
+{
+	struct hm_merge_split *splits = NULL;
+	struct hm_merge_part *parts = NULL;
+	Bucket **lists = NULL;
+	pthread_t *threads = NULL;
+	size_t n = n_threads, t = 0, src_range = 0, dst_range = 0;
+
+	if (!hm_merge_check(dst, src))
+		return (0);
+
+	if (!n)
+	{
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+		n = online > 0 ? (size_t)online : 1;
+	}
+
+	if (n > dst->size)
+		n = dst->size;
+
+	if (n < 2 || !src->array)
+		return (hashmap_merge(dst, src, combine));
+
+	splits = calloc(n, sizeof(*splits));
+	parts = calloc(n, sizeof(*parts));
+	lists = calloc(n * n, sizeof(*lists));
+	threads = calloc(n, sizeof(*threads));
+	if (!splits || !parts || !lists || !threads)
+	{
+		free(splits);
+		free(parts);
+		free(lists);
+		free(threads);
+		return (hashmap_merge(dst, src, combine));
+	}
+
+	src_range = (src->size + n - 1) / n;
+	dst_range = (dst->size + n - 1) / n;
+	for (t = 0; t < n; ++t)
+	{
+		splits[t] = (struct hm_merge_split){
+			.src = src,
+			.begin = src_range * t < src->size ? src_range * t : src->size,
+			.end = src_range * (t + 1) < src->size ? src_range * (t + 1)
+												   : src->size,
+			.dst_size = dst->size,
+			.range = dst_range,
+			.out = &lists[t],
+			.stride = n,
+		};
+		parts[t] = (struct hm_merge_part){
+			.dst = dst, .combine = combine, .in = &lists[t * n], .n_in = n
+		};
+	}
+
+	hm_run_threads(hm_merge_split_run, splits, sizeof(*splits), n, threads);
+	hm_run_threads(hm_merge_part_run, parts, sizeof(*parts), n, threads);
+	hm_merge_adopt(dst, src, parts, n);
+	free(splits);
+	free(parts);
+	free(lists);
+	free(threads);
+	return (1);
+}
+
+/**
+ * hm_snapshot_head - get the first bucket of a slot as seen by a snapshot.
+ * @snap: the snapshot.
+ * @idx: index of the slot.
+ *
+ * Return: pointer to the first bucket of the slot, NULL if empty.
+ */
+static Bucket *hm_snapshot_head(const HashMapSnapshot *snap, size_t idx)
+{
+	/* Pairs with the release store in `hm_slot_set`. */
+	Bucket *head =
+		atomic_load_explicit(&snap->hm->array[idx], memory_order_acquire);
+
+	if (atomic_load_explicit(
+			&snap->preserved[idx / CHAR_BIT], memory_order_acquire
+		) &
+		(1U << (idx % CHAR_BIT)))
+		head = snap->saved[idx];
+
+	return (head);
+}
+
+/**
+ * hm_write_map - serialise the key value pairs of a hash table or snapshot.
+ * @w: an initialised writer.
+ * @hm: pointer to the hash table.
+ * @snap: snapshot of `hm` to serialise instead of its current contents,
+ * may be NULL.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int
+hm_write_map(hm_writer *w, const HashMap *hm, const HashMapSnapshot *snap)
+{
+	const Bucket *walk = NULL;
+	size_t i = 0;
+	int first = 1;
+
+	if (w->format == HM_FORMAT_BINARY)
+	{
+		if (!hm_writer_put(w, "HMB\1", 4))
+			return (0);
+	}
+	else if (!hm_writer_put(w, "{", 1))
+		return (0);
+
+	for (i = 0; hm->array && i < hm->size; ++i)
+	{
+		walk = snap ? hm_snapshot_head(snap, i) : hm_slot_get(hm, i);
+		for (; walk; walk = walk->next)
+		{
+			if (!hm_writer_put_entry(w, walk, first))
+				return (0);
+
+			first = 0;
+		}
+	}
+
+	if (w->format != HM_FORMAT_BINARY && !hm_writer_put(w, "}", 1))
+		return (0);
+
+	return (hm_writer_flush(w));
+}
+
+/**
+ * hashmap_write - serialise all key value pairs of a hash table.
+ * @hm: pointer to the hash table.
+ * @w: an initialised writer, it can be reused for several maps.
+ *
+ * Output is staged in the writer's buffer and flushed to its sink before
+ * returning. JSON output writes NULL keys as empty strings and NULL values
+ * as `null`.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int hashmap_write(const HashMap *hm, hm_writer *w)
+{
+	if (!hm || !w || !w->buf)
+		return (0);
+
+	return (hm_write_map(w, hm, NULL));
+}
+
+/**
+ * hashmap_snapshot - take a read only snapshot of a hash table.
+ * @hm: pointer to the hash table.
+ *
+ * No elements are copied. Until the snapshot is released, the first change
+ * to a slot saves that slot's head for the snapshot, and buckets that
+ * existed when the snapshot was taken are copied instead of being modified.
+ * Snapshots can be read from other threads while the hash table is being
+ * modified, but taking and releasing them must be serialised with writers.
+ * All snapshots must be released before the hash table is deleted.
+ *
+ * Return: pointer to the snapshot, NULL on failure.
+ */
+HashMapSnapshot *hashmap_snapshot(HashMap *hm)
+{
+	HashMapSnapshot *snap = NULL;
+
+	if (!hm)
+		return (NULL);
+
+	snap = calloc(1, sizeof(*snap));
+	if (!snap)
+		return (NULL);
+
+	if (hm->size)
+	{
+		/* Large zeroed allocations are mapped lazily by the allocator. */
+		snap->preserved = calloc(
+			(hm->size + CHAR_BIT - 1) / CHAR_BIT, sizeof(*snap->preserved)
+		);
+		snap->saved = calloc(hm->size, sizeof(*snap->saved));
+		if (!snap->preserved || !snap->saved)
+		{
+			free(snap->preserved);
+			free(snap->saved);
+			free(snap);
+			return (NULL);
+		}
+	}
+
+	snap->hm = hm;
+	snap->count = hm->count;
+	snap->gen = hm->gen++;
+	snap->next = hm->snapshots;
+	hm->snapshots = snap;
+	return (snap);
+}
+
+/**
+ * hashmap_snapshot_release - free a snapshot.
+ * @snap: pointer to the snapshot.
+ *
+ * Buckets replaced while snapshots were live are freed with the last one.
+ */
+void hashmap_snapshot_release(HashMapSnapshot *snap)
+{
+	HashMapSnapshot **link = NULL;
+
+	if (!snap)
+		return;
+
+	for (link = &snap->hm->snapshots; *link; link = &(*link)->next)
+	{
+		if (*link == snap)
+		{
+			*link = snap->next;
+			break;
+		}
+	}
+
+	if (!snap->hm->snapshots)
+		hm_retired_free(snap->hm);
+
+	free(snap->preserved);
+	free(snap->saved);
+	free(snap);
+}
+
+/**
+ * hashmap_snapshot_count - number of elements in a snapshot.
+ * @snap: pointer to the snapshot.
+ *
+ * Return: the number of elements.
+ */
+size_t hashmap_snapshot_count(const HashMapSnapshot *snap)
+{
+	return (snap ? snap->count : 0);
+}
+
+/**
+ * hashmap_snapshot_get - retrieves the bucket associated with a key as it
+ * was when the snapshot was taken
+ * @snap: pointer to the snapshot
+ * @key: key of the value
+ *
+ * Return: pointer to the bucket, NULL if not found
+ */
+const Bucket *
+hashmap_snapshot_get(const HashMapSnapshot *snap, str_literal key)
+{
+	if (!snap || !snap->hm->array)
+		return (NULL);
+
+	return (chain_find(
+		hm_snapshot_head(snap, get_index(key, snap->hm->size)), key,
+		key ? hash_djb2(key) : 0
+	));
+}
+
+/**
+ * hashmap_snapshot_write - serialise the key value pairs of a snapshot.
+ * @snap: pointer to the snapshot.
+ * @w: an initialised writer.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int hashmap_snapshot_write(const HashMapSnapshot *snap, hm_writer *w)
+{
+	if (!snap || !w || !w->buf)
+		return (0);
+
+	return (hm_write_map(w, snap->hm, snap));
 }
@@ -1,6 +1,7 @@
 #ifndef HASHMAP_H
 #define HASHMAP_H
 
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -16,7 +17,11 @@ typedef const unsigned char *str_literal;
 
 /**
  * struct Bucket - bucket of a hash table
- * @key:
+ * @hash: hash of the key
+ * @key: the key
+ * @value: the value
+ * @next: next bucket in the same slot
+ * @gen: generation of the hash table the bucket was created in
  */
 typedef struct Bucket
 {
@@ -24,25 +29,167 @@ typedef struct Bucket
 	char *key;
 	char *value;
 	struct Bucket *next;
+	unsigned long gen;
 } Bucket;
 
+/**
+ * enum hm_alloc_flags - where the memory of a HashMap's tables comes from.
+ * @HM_ALLOC_HEAP: the C library allocator.
+ * @HM_ALLOC_HUGEPAGE: anonymous mappings advised to use transparent huge
+ * pages.
+ * @HM_ALLOC_HUGETLB: explicit huge pages, falls back to HM_ALLOC_HUGEPAGE
+ * when none are available.
+ * @HM_ALLOC_NUMA_BIND: place memory only on the nodes in `numa_nodes`.
+ * @HM_ALLOC_NUMA_INTERLEAVE: spread memory across the nodes in `numa_nodes`.
+ *
+ * The non heap options only apply to tables of at least HM_MMAP_THRESHOLD
+ * bytes on Linux, smaller tables always come from the heap.
+ *
+ * The NUMA flags need a non-empty `numa_nodes` mask, `hashmap_create_ex`
+ * fails otherwise. Past that they are a hint like the huge page flags: if
+ * the kernel lacks NUMA support or the mask names offline nodes, the memory
+ * is allocated without a policy instead of failing.
+ */
+enum hm_alloc_flags
+{
+	HM_ALLOC_HEAP = 0,
+	HM_ALLOC_HUGEPAGE = 1 << 0,
+	HM_ALLOC_HUGETLB = 1 << 1,
+	HM_ALLOC_NUMA_BIND = 1 << 2,
+	HM_ALLOC_NUMA_INTERLEAVE = 1 << 3,
+};
+
+#define HM_MMAP_THRESHOLD ((size_t)1 << 21)
+
+/**
+ * struct hm_alloc_opts - allocation options of a HashMap.
+ * @flags: bitwise OR of `enum hm_alloc_flags`.
+ * @numa_nodes: bit mask of NUMA nodes for the NUMA flags.
+ */
+typedef struct hm_alloc_opts
+{
+	unsigned int flags;
+	unsigned long numa_nodes;
+} hm_alloc_opts;
+
 /**
  * struct HashMap - a hash table
  * @size: number of slots in the hash table
- * @array: the hash table
+ * @array: the hash table, slots are read by snapshots on other threads
+ * @count: number of key value pairs in the hash table
+ * @capacity: number of buckets allocated in slabs, used or not
+ * @spare: list of allocated but unused buckets
+ * @slabs: blocks of memory the buckets are carved from
+ * @alloc: how the slot array and slabs are allocated
+ * @gen: current generation, advanced by every snapshot
+ * @snapshots: live snapshots of the hash table
+ * @retired: buckets replaced while snapshots were live
+ * @retired_len: number of retired buckets
+ * @retired_cap: size of the retired array
  */
 typedef struct HashMap
 {
 	size_t size;
-	Bucket **array;
+	_Atomic(Bucket *) *array;
+	size_t count;
+	size_t capacity;
+	Bucket *spare;
+	struct bucket_slab *slabs;
+	hm_alloc_opts alloc;
+	unsigned long gen;
+	struct HashMapSnapshot *snapshots;
+	struct hm_retired *retired;
+	size_t retired_len;
+	size_t retired_cap;
 } HashMap;
 
+typedef struct HashMapSnapshot HashMapSnapshot;
+
+/**
+ * hm_combine - combine the values of a key found in two hash maps.
+ * @dst_value: value in the destination map, may be NULL.
+ * @src_value: value in the source map, may be NULL.
+ *
+ * Return: the value to keep, either of the inputs or a new string. Inputs
+ * that are not returned are freed by the caller.
+ */
+typedef char *(hm_combine)(char *dst_value, char *src_value);
+
+/**
+ * hm_hash - hash a NUL terminated key.
+ * @key: the key.
+ *
+ * Return: the hash of the key.
+ */
+typedef size_t(hm_hash)(str_literal key);
+
+/**
+ * enum hm_format - output formats understood by `hashmap_write`.
+ * @HM_FORMAT_TEXT: human readable `{'key': 'value', ...}`, no escaping.
+ * @HM_FORMAT_JSON: a JSON object with escaped keys and values.
+ * @HM_FORMAT_BINARY: a "HMB\1" header followed by records of a 32 bit
+ * little endian key length, the key, a 32 bit value length and the value.
+ * NULL strings have a length of 0xFFFFFFFF.
+ */
+enum hm_format
+{
+	HM_FORMAT_TEXT,
+	HM_FORMAT_JSON,
+	HM_FORMAT_BINARY,
+};
+
+#define HM_WRITER_BUFSIZE ((size_t)1 << 16)
+
+/**
+ * struct hm_writer - a buffered sink for serialised HashMaps.
+ * @buf: staging buffer, also holds the output of memory sinks.
+ * @len: number of bytes currently in the buffer.
+ * @cap: size of the buffer.
+ * @stream: FILE sink, NULL if not writing to a FILE.
+ * @fd: file descriptor sink, -1 if not writing to a file descriptor.
+ * @format: the output format.
+ *
+ * A writer with neither a stream nor a file descriptor is a memory sink,
+ * its buffer grows instead of being flushed.
+ */
+typedef struct hm_writer
+{
+	char *buf;
+	size_t len;
+	size_t cap;
+	FILE *stream;
+	int fd;
+	enum hm_format format;
+} hm_writer;
+
 HashMap *hashmap_create(size_t size);
+HashMap *hashmap_create_ex(size_t size, const hm_alloc_opts *opts);
 void hashmap_delete(HashMap *ht);
+size_t hash_djb2(str_literal str) ATTR_NONNULL;
 size_t get_index(str_literal key, size_t size);
 Bucket *hashmap_get(const HashMap *ht, str_literal key);
-void *add_bucket_head(Bucket **h, const char *key, const char *val);
 int hashmap_insert(HashMap *ht, const char *key, const char *value);
+int hashmap_remove(HashMap *hm, const char *key);
+int hashmap_reserve(HashMap *hm, size_t n);
+int hashmap_shrink_to_fit(HashMap *hm);
+int hashmap_merge(HashMap *dst, HashMap *src, hm_combine *combine);
+int hashmap_merge_parallel(
+	HashMap *dst, HashMap *src, hm_combine *combine, unsigned int n_threads
+);
 void hashmap_print(const HashMap *ht);
 
+int hm_writer_init_stream(hm_writer *w, FILE *stream, enum hm_format format);
+int hm_writer_init_fd(hm_writer *w, int fd, enum hm_format format);
+int hm_writer_init_mem(hm_writer *w, enum hm_format format);
+int hm_writer_flush(hm_writer *w);
+void hm_writer_release(hm_writer *w);
+int hashmap_write(const HashMap *hm, hm_writer *w);
+
+HashMapSnapshot *hashmap_snapshot(HashMap *hm);
+void hashmap_snapshot_release(HashMapSnapshot *snap);
+size_t hashmap_snapshot_count(const HashMapSnapshot *snap);
+const Bucket *
+hashmap_snapshot_get(const HashMapSnapshot *snap, str_literal key);
+int hashmap_snapshot_write(const HashMapSnapshot *snap, hm_writer *w);
+
 #endif /* HASHMAP_H */
@@ -0,0 +1,560 @@
+/* mmap, madvise */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif /* __SSE2__ */
+
+#include "json_strlist.h"
+
+/**
+ * struct json_strlist - cursor over a memory mapped JSON array of strings.
+ * @map: start of the mapping.
+ * @map_len: size of the mapping in bytes.
+ * @pos: next byte to scan.
+ * @end: one past the last byte of the mapping.
+ * @scratch: buffer receiving strings that contain escapes.
+ * @scratch_cap: size of `scratch` in bytes.
+ * @state: 0 before the opening bracket, 1 inside the array, 2 at the end.
+ */
+struct json_strlist
+{
+	const char *map;
+	size_t map_len;
+	const char *pos;
+	const char *end;
+	char *scratch;
+	size_t scratch_cap;
+	int state;
+};
+
+/**
+ * skip_space - skip JSON whitespace.
+ * @p: the position to start at.
+ * @end: end of the input.
+ *
+ * Return: the first non whitespace position, `end` if there is none.
+ */
+static const char *skip_space(const char *p, const char *end)
+{
+	while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+		p++;
+
+	return (p);
+}
+
+/**
+ * find_quote_or_escape - find the end of the plain run of a string.
+ * @p: a position inside a string.
+ * @end: end of the input.
+ *
+ * Return: the first `"` or `\` at or after `p`, `end` if there is none.
+ */
+static const char *find_quote_or_escape(const char *p, const char *end)
+{
+#ifdef __SSE2__
+	const __m128i quote = _mm_set1_epi8('"'), escape = _mm_set1_epi8('\\');
+
+	for (; end - p >= 16; p += 16)
+	{
+		const __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+		const unsigned int mask = (unsigned int)_mm_movemask_epi8(
+			_mm_or_si128(
+				_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, escape)
+			)
+		);
+
+		if (mask)
+			return (p + __builtin_ctz(mask));
+	}
+#endif /* __SSE2__ */
+
+	while (p < end && *p != '"' && *p != '\\')
+		p++;
+
+	return (p);
+}
+
+/**
+ * hex4 - parse the 4 hex digits of a \u escape.
+ * @p: the first digit.
+ *
+ * Return: the code unit, -1 if a digit is invalid.
+ */
+static long int hex4(const char *p)
+{
+	long int unit = 0;
+	int i = 0;
+
+	for (i = 0; i < 4; i++)
+	{
+		unit <<= 4;
+		if (p[i] >= '0' && p[i] <= '9')
+			unit |= p[i] - '0';
+		else if (p[i] >= 'a' && p[i] <= 'f')
+			unit |= p[i] - 'a' + 10;
+		else if (p[i] >= 'A' && p[i] <= 'F')
+			unit |= p[i] - 'A' + 10;
+		else
+			return (-1);
+	}
+
+	return (unit);
+}
+
+/**
+ * put_utf8 - encode a code point as UTF-8.
+ * @out: buffer with room for at least 4 bytes.
+ * @cp: the code point.
+ *
+ * Return: number of bytes written.
+ */
+static size_t put_utf8(char *out, unsigned long int cp)
+{
+	if (cp < 0x80)
+	{
+		out[0] = (char)cp;
+		return (1);
+	}
+
+	if (cp < 0x800)
+	{
+		out[0] = (char)(0xC0 | (cp >> 6));
+		out[1] = (char)(0x80 | (cp & 0x3F));
+		return (2);
+	}
+
+	if (cp < 0x10000)
+	{
+		out[0] = (char)(0xE0 | (cp >> 12));
+		out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+		out[2] = (char)(0x80 | (cp & 0x3F));
+		return (3);
+	}
+
+	out[0] = (char)(0xF0 | (cp >> 18));
+	out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+	out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+	out[3] = (char)(0x80 | (cp & 0x3F));
+	return (4);
+}
+
+/**
+ * unescape - decode the string at the cursor into the scratch buffer.
+ * @list: the cursor, positioned on the first escape of the string.
+ * @start: the first byte of the string's contents.
+ * @len: out parameter for the length of the decoded string.
+ *
+ * A decoded string is never longer than its encoded form, so the scratch
+ * buffer is sized from the encoded length before decoding.
+ *
+ * Return: 0 on success, -1 on malformed input or allocation failure.
+ */
+static int unescape(json_strlist *list, const char *start, size_t *len)
+{
+	const char *p = list->pos, *close = NULL;
+	char *out = NULL;
+	long int unit = 0, low = 0;
+
+	for (close = p; close < list->end && *close != '"'; close++)
+	{
+		if (*close == '\\' && ++close == list->end)
+			return (-1);
+	}
+
+	if (close == list->end)
+		return (-1);
+
+	if ((size_t)(close - start) + 1 > list->scratch_cap)
+	{
+		out = realloc(list->scratch, (size_t)(close - start) + 1);
+		if (!out)
+			return (-1);
+
+		list->scratch = out;
+		list->scratch_cap = (size_t)(close - start) + 1;
+	}
+
+	memcpy(list->scratch, start, (size_t)(p - start));
+	out = list->scratch + (p - start);
+	while (p < close)
+	{
+		if (*p != '\\')
+		{
+			const char *run = find_quote_or_escape(p, close);
+
+			memcpy(out, p, (size_t)(run - p));
+			out += run - p;
+			p = run;
+			continue;
+		}
+
+		p++;
+		switch (*p++)
+		{
+		case '"':
+			*out++ = '"';
+			break;
+		case '\\':
+			*out++ = '\\';
+			break;
+		case '/':
+			*out++ = '/';
+			break;
+		case 'b':
+			*out++ = '\b';
+			break;
+		case 'f':
+			*out++ = '\f';
+			break;
+		case 'n':
+			*out++ = '\n';
+			break;
+		case 'r':
+			*out++ = '\r';
+			break;
+		case 't':
+			*out++ = '\t';
+			break;
+		case 'u':
+			if (close - p < 4 || (unit = hex4(p)) < 0)
+				return (-1);
+
+			p += 4;
+			if (unit >= 0xD800 && unit <= 0xDBFF && close - p >= 6 &&
+				p[0] == '\\' && p[1] == 'u' && (low = hex4(p + 2)) >= 0xDC00 &&
+				low <= 0xDFFF)
+			{
+				unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+				p += 6;
+			}
+
+			out += put_utf8(out, (unsigned long int)unit);
+			break;
+		default:
+			return (-1);
+		}
+	}
+
+	*out = '\0';
+	*len = (size_t)(out - list->scratch);
+	list->pos = close + 1;
+	return (0);
+}
+
+/**
+ * skip_value - skip a non string element of the array.
+ * @p: the first byte of the element.
+ * @end: end of the input.
+ *
+ * Return: the first byte after the element, NULL on malformed input.
+ */
+static const char *skip_value(const char *p, const char *end)
+{
+	size_t depth = 0;
+
+	while (p < end)
+	{
+		if (*p == '"')
+		{
+			p++;
+			while (p < end && *p != '"')
+			{
+				p = find_quote_or_escape(p, end);
+				if (p < end && *p == '\\' && ++p < end)
+					p++;
+			}
+
+			if (p >= end)
+				return (NULL);
+		}
+		else if (*p == '[' || *p == '{')
+			depth++;
+		else if (*p == ']' || *p == '}')
+		{
+			if (!depth)
+				return (p);
+
+			depth--;
+		}
+		else if (*p == ',' && !depth)
+			return (p);
+
+		p++;
+	}
+
+	return (NULL);
+}
+
+/**
+ * json_strlist_open - map a file holding a JSON array of strings.
+ * @path: path to the file.
+ *
+ * Return: a cursor over the array, NULL on error with errno set.
+ */
+json_strlist *json_strlist_open(const char *path)
+{
+	json_strlist *list = NULL;
+	struct stat st;
+	void *map = NULL;
+	int fd = -1;
+
+	if (!path)
+	{
+		errno = EINVAL;
+		return (NULL);
+	}
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return (NULL);
+
+	if (fstat(fd, &st))
+	{
+		close(fd);
+		return (NULL);
+	}
+
+	if (st.st_size <= 0)
+	{
+		close(fd);
+		errno = EINVAL;
+		return (NULL);
+	}
+
+	map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return (NULL);
+
+	madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+	list = calloc(1, sizeof(*list));
+	if (!list)
+	{
+		munmap(map, (size_t)st.st_size);
+		return (NULL);
+	}
+
+	list->map = map;
+	list->map_len = (size_t)st.st_size;
+	list->pos = list->map;
+	list->end = list->map + list->map_len;
+	return (list);
+}
+
+/**
+ * json_strlist_close - unmap the file and free the cursor.
+ * @list: the cursor, may be NULL.
+ */
+void json_strlist_close(json_strlist *list)
+{
+	if (!list)
+		return;
+
+	munmap((void *)list->map, list->map_len);
+	free(list->scratch);
+	free(list);
+}
+
+/**
+ * json_strlist_next - get the next string of the array.
+ * @list: the cursor.
+ * @str: out parameter for the string.
+ * @len: out parameter for the length of the string.
+ *
+ * Strings without escapes point into the mapped file and are not NUL
+ * terminated, strings with escapes are decoded into a buffer owned by the
+ * cursor and are NUL terminated. Either way `*str` stays valid only until the
+ * next call. Elements that are not strings are skipped.
+ *
+ * Return: 1 if a string was read, 0 at the end of the array, -1 on malformed
+ * input or allocation failure.
+ */
+int json_strlist_next(json_strlist *list, const char **str, size_t *len)
+{
+	const char *p = NULL, *start = NULL;
+
+	if (!list || !str || !len)
+		return (-1);
+
+	while (list->state < 2)
+	{
+		p = skip_space(list->pos, list->end);
+		if (p >= list->end)
+			return (-1);
+
+		if (list->state == 0)
+		{
+			if (*p != '[')
+				return (-1);
+
+			list->state = 1;
+			list->pos = p + 1;
+			continue;
+		}
+
+		if (*p == ']')
+		{
+			list->state = 2;
+			list->pos = p + 1;
+			break;
+		}
+
+		if (*p == ',')
+		{
+			list->pos = p + 1;
+			continue;
+		}
+
+		if (*p != '"')
+		{
+			p = skip_value(p, list->end);
+			if (!p)
+				return (-1);
+
+			list->pos = p;
+			continue;
+		}
+
+		start = p + 1;
+		p = find_quote_or_escape(start, list->end);
+		if (p >= list->end)
+			return (-1);
+
+		list->pos = p;
+		if (*p == '\\')
+		{
+			if (unescape(list, start, len))
+				return (-1);
+
+			*str = list->scratch;
+			return (1);
+		}
+
+		*str = start;
+		*len = (size_t)(p - start);
+		list->pos = p + 1;
+		return (1);
+	}
+
+	return (0);
+}
+
+/**
+ * json_strlist_foreach - pass every string of a JSON array to a function.
+ * @path: path to the file holding the array.
+ * @f: function to call, see `json_str_func`.
+ * @ctx: passed through to `f`.
+ *
+ * Return: number of strings passed to `f`, -1 on error.
+ */
+ssize_t json_strlist_foreach(const char *path, json_str_func *f, void *ctx)
+{
+	json_strlist *list = NULL;
+	const char *str = NULL;
+	size_t len = 0;
+	ssize_t n = 0;
+	int status = 0;
+
+	if (!f)
+		return (-1);
+
+	list = json_strlist_open(path);
+	if (!list)
+		return (-1);
+
+	while ((status = json_strlist_next(list, &str, &len)) > 0)
+	{
+		n++;
+		if (f(str, len, ctx))
+			break;
+	}
+
+	json_strlist_close(list);
+	return (status < 0 ? -1 : n);
+}
+
+/**
+ * cstr - NUL terminate a string in a reusable buffer.
+ * @buf: pointer to the buffer, grown as needed.
+ * @cap: pointer to the size of the buffer.
+ * @str: the string.
+ * @len: length of the string.
+ *
+ * Return: the terminated string, NULL on allocation failure.
+ */
+static char *cstr(char **buf, size_t *cap, const char *str, size_t len)
+{
+	char *tmp = NULL;
+
+	if (len + 1 > *cap)
+	{
+		tmp = realloc(*buf, len + 1);
+		if (!tmp)
+			return (NULL);
+
+		*buf = tmp;
+		*cap = len + 1;
+	}
+
+	memcpy(*buf, str, len);
+	(*buf)[len] = '\0';
+	return (*buf);
+}
+
+/**
+ * hashmap_load_json - insert pairs read from two JSON arrays of strings.
+ * @hm: the hash map.
+ * @keys_path: file holding the keys.
+ * @values_path: file holding the values, paired with the keys by position.
+ *
+ * Pairs are read until either array runs out. Only the hash map's own copies
+ * of each string are allocated, the files are streamed from their mappings.
+ *
+ * Return: number of pairs inserted, -1 on error.
+ */
+ssize_t hashmap_load_json(
+	HashMap *hm, const char *keys_path, const char *values_path
+)
+{
+	json_strlist *keys = NULL, *values = NULL;
+	const char *k = NULL, *v = NULL;
+	char *kbuf = NULL, *vbuf = NULL;
+	size_t klen = 0, vlen = 0, kcap = 0, vcap = 0;
+	ssize_t n = 0;
+	int ks = 0, vs = 0;
+
+	if (!hm)
+		return (-1);
+
+	keys = json_strlist_open(keys_path);
+	values = json_strlist_open(values_path);
+	if (!keys || !values)
+		n = -1;
+
+	while (n >= 0 && (ks = json_strlist_next(keys, &k, &klen)) > 0 &&
+		   (vs = json_strlist_next(values, &v, &vlen)) > 0)
+	{
+		if (!cstr(&kbuf, &kcap, k, klen) || !cstr(&vbuf, &vcap, v, vlen) ||
+			!hashmap_insert(hm, kbuf, vbuf))
+			n = -1;
+		else
+			n++;
+	}
+
+	if (ks < 0 || vs < 0)
+		n = -1;
+
+	free(kbuf);
+	free(vbuf);
+	json_strlist_close(keys);
+	json_strlist_close(values);
+	return (n);
+}
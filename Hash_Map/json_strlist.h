@@ -0,0 +1,28 @@
+#ifndef JSON_STRLIST_H
+#define JSON_STRLIST_H
+
+#include <sys/types.h> /* ssize_t */
+
+#include "hashmap.h"
+
+typedef struct json_strlist json_strlist;
+
+/**
+ * json_str_func - receives the strings of a JSON array.
+ * @str: the string, not NUL terminated, valid until the function returns.
+ * @len: length of the string in bytes.
+ * @ctx: pointer passed through by the caller.
+ *
+ * Return: 0 to continue, non-zero to stop.
+ */
+typedef int(json_str_func)(const char *str, size_t len, void *ctx);
+
+json_strlist *json_strlist_open(const char *path);
+void json_strlist_close(json_strlist *list);
+int json_strlist_next(json_strlist *list, const char **str, size_t *len);
+ssize_t json_strlist_foreach(const char *path, json_str_func *f, void *ctx);
+ssize_t hashmap_load_json(
+	HashMap *hm, const char *keys_path, const char *values_path
+);
+
+#endif /* JSON_STRLIST_H */
@@ -1,104 +1,162 @@
-#define _POSIX_C_SOURCE 200809L
-#include "hashmap.h"
-#include <json-c/json.h>
-#define STR_ARRAY_SIZE (2048)
+#define _GNU_SOURCE
+#include "json_strlist.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#define TLB_BENCH_KEYS ((size_t)1 << 22)
+#define TLB_BENCH_LOOKUPS ((size_t)1 << 22)
+#define KEYS_JSON \
+	"/home/line/Github_Repositories/World_of_C/Hash_Map/random_strings0.json"
+#define VALUES_JSON \
+	"/home/line/Github_Repositories/World_of_C/Hash_Map/random_strings1.json"
 
 /**
- * struct str_list - array of strings
- * @len: number of strings in the array
- * @array: an array of strings
+ * dtlb_counter_open - start counting data TLB load misses of this thread.
+ *
+ * Return: a perf event file descriptor, -1 if the counter is unavailable.
  */
-struct str_list
+static int dtlb_counter_open(void)
 {
-	size_t len;
-	char *array[STR_ARRAY_SIZE];
-};
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HW_CACHE;
+	attr.config = PERF_COUNT_HW_CACHE_DTLB |
+				  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+				  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return ((int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
 
 /**
- * parse_json_list - p
- * @json_file: path to a json file
- * @list: a struct of an array to populate with strings
- *
- * Return: number of strings parsed, -1 on error.
+ * bench_lookups - time random lookups in a large hash map.
+ * @label: name of the allocation strategy to report.
+ * @opts: allocation options of the hash map.
  */
-ssize_t parse_json_list(const char *json_file, struct str_list *list)
+static void bench_lookups(const char *label, const hm_alloc_opts *opts)
 {
-	json_object *node = NULL, *root = json_object_from_file(json_file);
-	size_t n = 0, i = 0;
+	HashMap *hm = hashmap_create_ex(TLB_BENCH_KEYS, opts);
+	struct timespec start, end;
+	long long misses = -1;
+	size_t i = 0, found = 0, x = 88172645463325252ULL;
+	char key[32];
+	int fd = -1;
+
+	if (!hm || !hashmap_reserve(hm, TLB_BENCH_KEYS))
+	{
+		hashmap_delete(hm);
+		return;
+	}
 
-	if (!root || !json_object_is_type(root, json_type_array))
-		return (-1);
+	for (i = 0; i < TLB_BENCH_KEYS; i++)
+	{
+		sprintf(key, "key-%zu", i);
+		hashmap_insert(hm, key, NULL);
+	}
 
-	n = json_object_array_length(root);
-	list->len = 0;
-	for (i = 0; i < n && i < STR_ARRAY_SIZE; i++)
+	fd = dtlb_counter_open();
+	if (fd >= 0)
 	{
-		node = json_object_array_get_idx(root, i);
-		if (!node)
-		{
-			json_object_put(root);
-			return (-1);
-		}
-
-		if (json_object_is_type(node, json_type_string))
-		{
-			list->array[list->len] = strdup(json_object_get_string(node));
-			if (!list->array[list->len])
-			{
-				perror("Failed to copy string.");
-				json_object_put(root);
-				return (-1);
-			}
-
-			list->len++;
-		}
+		ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
 	}
 
-	json_object_put(root);
-	return ((ssize_t)list->len);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < TLB_BENCH_LOOKUPS; i++)
+	{
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		sprintf(key, "key-%zu", x % TLB_BENCH_KEYS);
+		found += hashmap_get(hm, (str_literal)key) != NULL;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	if (fd >= 0)
+	{
+		ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(fd, &misses, sizeof(misses)) != sizeof(misses))
+			misses = -1;
+
+		close(fd);
+	}
+
+	printf(
+		"%-9s: %zu/%zu found, %.3fs, dTLB load misses: ", label, found,
+		TLB_BENCH_LOOKUPS,
+		(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9
+	);
+	if (misses < 0)
+		printf("n/a\n");
+	else
+		printf("%lld\n", misses);
+
+	hashmap_delete(hm);
 }
 
 /**
- * main - entry
+ * print_lengths - print the lengths of a key and its value.
+ * @str: the key.
+ * @len: length of the key.
+ * @ctx: the hash map holding the key.
  *
- * Return: 0
+ * Return: 0 to keep going, 1 if the key could not be copied.
  */
-int main(void)
+static int print_lengths(const char *str, size_t len, void *ctx)
 {
-	struct str_list keys = {STR_ARRAY_SIZE, {NULL}}, values = {STR_ARRAY_SIZE, {NULL}};
+	static size_t i;
+	char *key = strndup(str, len);
 	Bucket *b = NULL;
-	size_t i = 0;
-	HashMap *hm = hashmap_create(1024);
-
-	parse_json_list(
-		"/home/line/Github_Repositories/World_of_C/Hash_Map/random_strings0.json",
-		&keys);
-	parse_json_list(
-		"/home/line/Github_Repositories/World_of_C/Hash_Map/random_strings1.json",
-		&values);
 
-	for (i = 0; i < keys.len && i < values.len && i < STR_ARRAY_SIZE; i++)
-		hashmap_insert(hm, keys.array[i], values.array[i]);
+	if (!key)
+		return (1);
 
-	for (i = 0; i < keys.len && i < values.len && i < STR_ARRAY_SIZE; i++)
+	b = hashmap_get(ctx, (str_literal)key);
+	if (b)
 	{
-		b = hashmap_get(hm, (str_literal)keys.array[i]);
-		printf("key[%ld]: strlen=%ld, ", i, strlen(b->key));
-		printf("value[%ld]: strlen=%ld\n", i, strlen(b->value));
+		printf("key[%zu]: strlen=%zu, ", i, strlen(b->key));
+		printf("value[%zu]: strlen=%zu\n", i, strlen(b->value));
 	}
 
-	hashmap_delete(hm);
-	for (i = 0; i < keys.len; i++)
-	{
-		free(keys.array[i]);
-		keys.array[i] = NULL;
-	}
+	free(key);
+	i++;
+	return (0);
+}
 
-	for (i = 0; i < values.len; i++)
-	{
-		free(values.array[i]);
-		values.array[i] = NULL;
-	}
+/**
+ * main - entry
+ * @argc: number of arguments.
+ * @argv: optional paths to JSON arrays of keys and values.
+ *
+ * Return: 0
+ */
+int main(int argc, char **argv)
+{
+	const char *keys = argc > 2 ? argv[1] : KEYS_JSON;
+	const char *values = argc > 2 ? argv[2] : VALUES_JSON;
+	struct timespec start, end;
+	HashMap *hm = hashmap_create(1024);
+	ssize_t n = 0;
 
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	n = hashmap_load_json(hm, keys, values);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	if (n < 0)
+		perror("Failed to load the JSON files");
+	else
+		json_strlist_foreach(keys, print_lengths, hm);
+
+	printf(
+		"loaded %zd pairs in %.3fs\n", n,
+		(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9
+	);
+	hashmap_delete(hm);
+	bench_lookups("heap", &(hm_alloc_opts){.flags = HM_ALLOC_HEAP});
+	bench_lookups("hugepage", &(hm_alloc_opts){.flags = HM_ALLOC_HUGEPAGE});
 	return (0);
 }
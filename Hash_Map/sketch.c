@@ -0,0 +1,601 @@
+/* strdup */
+#define _GNU_SOURCE
+
+#include <stdint.h>
+
+#include "sketch.h"
+
+/* Euler's number, the base of the count-min error bounds. */
+#define SKETCH_E 2.718281828459045
+
+/**
+ * mix - spread the bits of a hash so rows can be derived from it.
+ * @h: the hash.
+ *
+ * Return: the mixed hash.
+ */
+static uint64_t mix(uint64_t h)
+{
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBULL;
+	h ^= h >> 31;
+	return (h);
+}
+
+/**
+ * key_hash - hash a key that may be NULL.
+ * @hash: the hash function.
+ * @key: the key.
+ *
+ * Return: the hash of the key, 0 for NULL.
+ */
+static size_t key_hash(hm_hash *hash, const char *key)
+{
+	return (key ? hash((str_literal)key) : 0);
+}
+
+/**
+ * keys_equal - compare two keys, either of which may be NULL
+ * @a: the first key
+ * @b: the second key
+ *
+ * Return: non-zero if the keys are equal
+ */
+static int keys_equal(const char *a, const char *b)
+{
+	if (!a || !b)
+		return (a == b);
+
+	return (!strcmp(a, b));
+}
+
+/**
+ * add_sat - add two counts without wrapping around.
+ * @a: the first count.
+ * @b: the second count.
+ *
+ * Return: the sum, SIZE_MAX if it does not fit.
+ */
+static size_t add_sat(size_t a, size_t b)
+{
+	return (a > SIZE_MAX - b ? SIZE_MAX : a + b);
+}
+
+/**
+ * cms_create - allocate a count-min sketch.
+ * @width: counters per row, rounded up to a power of 2.
+ * @depth: number of rows.
+ * @hash: hash function for the keys, NULL for `hash_djb2`.
+ *
+ * Return: the sketch, NULL on invalid dimensions or allocation failure.
+ */
+CountMinSketch *cms_create(size_t width, size_t depth, hm_hash *hash)
+{
+	CountMinSketch *cms = NULL;
+	size_t w = 1;
+
+	if (!width || !depth)
+		return (NULL);
+
+	while (w < width && w <= SIZE_MAX / 2)
+		w <<= 1;
+
+	if (w < width || depth > SIZE_MAX / sizeof(size_t) / w)
+		return (NULL);
+
+	cms = calloc(1, sizeof(*cms));
+	if (!cms)
+		return (NULL);
+
+	cms->counters = calloc(w * depth, sizeof(*cms->counters));
+	if (!cms->counters)
+	{
+		free(cms);
+		return (NULL);
+	}
+
+	cms->width = w;
+	cms->depth = depth;
+	cms->hash = hash ? hash : hash_djb2;
+	return (cms);
+}
+
+/**
+ * cms_create_bounded - allocate a count-min sketch for an error bound.
+ * @epsilon: overcount allowed, as a fraction of the total count.
+ * @delta: probability of exceeding the allowed overcount.
+ * @hash: hash function for the keys, NULL for `hash_djb2`.
+ *
+ * Return: the sketch, NULL on invalid bounds or allocation failure.
+ */
+CountMinSketch *cms_create_bounded(double epsilon, double delta, hm_hash *hash)
+{
+	double width = 0, p = 1;
+	size_t depth = 0;
+
+	if (!(epsilon > 0 && epsilon < 1 && delta > 0 && delta < 1))
+		return (NULL);
+
+	width = SKETCH_E / epsilon;
+	if (width >= (double)(SIZE_MAX / 2))
+		return (NULL);
+
+	for (depth = 0; p > delta; depth++)
+		p /= SKETCH_E;
+
+	return (cms_create((size_t)width + ((size_t)width < width), depth, hash));
+}
+
+/**
+ * cms_delete - free a count-min sketch.
+ * @cms: the sketch, may be NULL.
+ */
+void cms_delete(CountMinSketch *cms)
+{
+	if (!cms)
+		return;
+
+	free(cms->counters);
+	free(cms);
+}
+
+/**
+ * cms_clear - reset all counts of a count-min sketch to 0.
+ * @cms: the sketch.
+ */
+void cms_clear(CountMinSketch *cms)
+{
+	if (!cms)
+		return;
+
+	memset(cms->counters, 0, cms->width * cms->depth * sizeof(*cms->counters));
+	cms->total = 0;
+}
+
+/**
+ * cms_add - count occurrences of a key.
+ * @cms: the sketch.
+ * @key: the key, may be NULL.
+ * @n: number of occurrences.
+ *
+ * Uses conservative update: counters are only raised as far as the new
+ * estimate of the key, which keeps keys sharing a counter from inflating
+ * each other.
+ *
+ * Return: the new estimate of the key's count.
+ */
+size_t cms_add(CountMinSketch *cms, const char *key, size_t n)
+{
+	uint64_t h1 = 0, h2 = 0;
+	size_t i = 0, est = SIZE_MAX, *c = NULL;
+
+	if (!cms)
+		return (0);
+
+	h1 = mix(key_hash(cms->hash, key));
+	h2 = mix(h1) | 1;
+	for (i = 0; i < cms->depth; i++)
+	{
+		c = &cms->counters[i * cms->width + ((h1 + i * h2) & (cms->width - 1))];
+		if (*c < est)
+			est = *c;
+	}
+
+	est = add_sat(est, n);
+	for (i = 0; i < cms->depth; i++)
+	{
+		c = &cms->counters[i * cms->width + ((h1 + i * h2) & (cms->width - 1))];
+		if (*c < est)
+			*c = est;
+	}
+
+	cms->total = add_sat(cms->total, n);
+	return (est);
+}
+
+/**
+ * cms_estimate - estimate how many times a key was counted.
+ * @cms: the sketch.
+ * @key: the key, may be NULL.
+ *
+ * Return: an upper bound of the key's count.
+ */
+size_t cms_estimate(const CountMinSketch *cms, const char *key)
+{
+	uint64_t h1 = 0, h2 = 0;
+	size_t i = 0, est = SIZE_MAX, c = 0;
+
+	if (!cms)
+		return (0);
+
+	h1 = mix(key_hash(cms->hash, key));
+	h2 = mix(h1) | 1;
+	for (i = 0; i < cms->depth; i++)
+	{
+		c = cms->counters[i * cms->width + ((h1 + i * h2) & (cms->width - 1))];
+		if (c < est)
+			est = c;
+	}
+
+	return (est);
+}
+
+/**
+ * cms_merge - add the counts of one count-min sketch to another.
+ * @dst: the sketch to add to.
+ * @src: the sketch to add, must have the same dimensions and hash function.
+ *
+ * The merged sketch still never undercounts, though conservative update of
+ * the inputs makes it no tighter than a plain count-min sketch would be.
+ *
+ * Return: 1 on success, 0 if the sketches are incompatible.
+ */
+int cms_merge(CountMinSketch *dst, const CountMinSketch *src)
+{
+	size_t i = 0;
+
+	if (!dst || !src || dst == src || dst->width != src->width ||
+		dst->depth != src->depth || dst->hash != src->hash)
+		return (0);
+
+	for (i = 0; i < dst->width * dst->depth; i++)
+		dst->counters[i] = add_sat(dst->counters[i], src->counters[i]);
+
+	dst->total = add_sat(dst->total, src->total);
+	return (1);
+}
+
+/**
+ * topk_find - find the index slot of a key.
+ * @tk: the tracker.
+ * @key: the key.
+ * @hash: hash of the key.
+ *
+ * Return: the slot holding the key, or the empty slot it would go in.
+ */
+static size_t *topk_find(const TopK *tk, const char *key, size_t hash)
+{
+	size_t s = hash & tk->index_mask;
+	const TopKEntry *e = NULL;
+
+	for (; tk->index[s]; s = (s + 1) & tk->index_mask)
+	{
+		e = &tk->heap[tk->index[s] - 1];
+		if (e->hash == hash && keys_equal(e->key, key))
+			break;
+	}
+
+	return (&tk->index[s]);
+}
+
+/**
+ * topk_slot_of - find the index slot pointing at a heap position.
+ * @tk: the tracker.
+ * @pos: the heap position.
+ *
+ * Return: the slot.
+ */
+static size_t *topk_slot_of(const TopK *tk, size_t pos)
+{
+	size_t s = tk->heap[pos].hash & tk->index_mask;
+
+	while (tk->index[s] != pos + 1)
+		s = (s + 1) & tk->index_mask;
+
+	return (&tk->index[s]);
+}
+
+/**
+ * topk_unindex - remove a slot from the index.
+ * @tk: the tracker.
+ * @slot: the slot.
+ *
+ * Later slots of the probe sequence are shifted back so lookups never stop
+ * at the hole.
+ */
+static void topk_unindex(TopK *tk, size_t *slot)
+{
+	size_t i = (size_t)(slot - tk->index), j = i, home = 0;
+
+	for (j = (j + 1) & tk->index_mask; tk->index[j];
+		 j = (j + 1) & tk->index_mask)
+	{
+		home = tk->heap[tk->index[j] - 1].hash & tk->index_mask;
+		if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+			continue;
+
+		tk->index[i] = tk->index[j];
+		i = j;
+	}
+
+	tk->index[i] = 0;
+}
+
+/**
+ * topk_swap - swap two heap entries, keeping the index in sync.
+ * @tk: the tracker.
+ * @a: the first heap position.
+ * @b: the second heap position.
+ */
+static void topk_swap(TopK *tk, size_t a, size_t b)
+{
+	size_t *sa = topk_slot_of(tk, a), *sb = topk_slot_of(tk, b);
+	TopKEntry tmp = tk->heap[a];
+
+	tk->heap[a] = tk->heap[b];
+	tk->heap[b] = tmp;
+	*sa = b + 1;
+	*sb = a + 1;
+}
+
+/**
+ * topk_sift_up - restore the heap after an entry's count decreased.
+ * @tk: the tracker.
+ * @pos: position of the entry.
+ */
+static void topk_sift_up(TopK *tk, size_t pos)
+{
+	while (pos && tk->heap[pos].count < tk->heap[(pos - 1) / 2].count)
+	{
+		topk_swap(tk, pos, (pos - 1) / 2);
+		pos = (pos - 1) / 2;
+	}
+}
+
+/**
+ * topk_sift_down - restore the heap after an entry's count increased.
+ * @tk: the tracker.
+ * @pos: position of the entry.
+ */
+static void topk_sift_down(TopK *tk, size_t pos)
+{
+	size_t min = pos, child = 0;
+
+	while (1)
+	{
+		child = 2 * pos + 1;
+		if (child < tk->len && tk->heap[child].count < tk->heap[min].count)
+			min = child;
+
+		if (child + 1 < tk->len &&
+			tk->heap[child + 1].count < tk->heap[min].count)
+			min = child + 1;
+
+		if (min == pos)
+			return;
+
+		topk_swap(tk, pos, min);
+		pos = min;
+	}
+}
+
+/**
+ * topk_create - allocate a space-saving top-K tracker.
+ * @k: number of keys to track.
+ * @hash: hash function for the keys, NULL for `hash_djb2`.
+ *
+ * Return: the tracker, NULL on invalid size or allocation failure.
+ */
+TopK *topk_create(size_t k, hm_hash *hash)
+{
+	TopK *tk = NULL;
+	size_t slots = 2;
+
+	if (!k || k > SIZE_MAX / 4 / sizeof(TopKEntry))
+		return (NULL);
+
+	while (slots < 2 * k)
+		slots <<= 1;
+
+	tk = calloc(1, sizeof(*tk));
+	if (!tk)
+		return (NULL);
+
+	tk->heap = calloc(k, sizeof(*tk->heap));
+	tk->index = calloc(slots, sizeof(*tk->index));
+	if (!tk->heap || !tk->index)
+	{
+		free(tk->heap);
+		free(tk->index);
+		free(tk);
+		return (NULL);
+	}
+
+	tk->k = k;
+	tk->index_mask = slots - 1;
+	tk->hash = hash ? hash : hash_djb2;
+	return (tk);
+}
+
+/**
+ * topk_delete - free a top-K tracker and its keys.
+ * @tk: the tracker, may be NULL.
+ */
+void topk_delete(TopK *tk)
+{
+	size_t i = 0;
+
+	if (!tk)
+		return;
+
+	for (i = 0; i < tk->len; i++)
+		free(tk->heap[i].key);
+
+	free(tk->heap);
+	free(tk->index);
+	free(tk);
+}
+
+/**
+ * topk_add - count occurrences of a key.
+ * @tk: the tracker.
+ * @key: the key, may be NULL.
+ * @n: number of occurrences.
+ *
+ * An untracked key arriving at a full tracker replaces the key with the
+ * lowest count and inherits that count as its error.
+ *
+ * Return: 1 on success, 0 on allocation failure.
+ */
+int topk_add(TopK *tk, const char *key, size_t n)
+{
+	size_t hash = 0, *slot = NULL, min = 0;
+	char *dup = NULL;
+
+	if (!tk)
+		return (0);
+
+	hash = key_hash(tk->hash, key);
+	slot = topk_find(tk, key, hash);
+	if (*slot)
+	{
+		tk->heap[*slot - 1].count = add_sat(tk->heap[*slot - 1].count, n);
+		topk_sift_down(tk, *slot - 1);
+		return (1);
+	}
+
+	dup = key ? strdup(key) : NULL;
+	if (key && !dup)
+		return (0);
+
+	if (tk->len < tk->k)
+	{
+		tk->heap[tk->len] = (TopKEntry){dup, hash, n, 0};
+		*slot = ++tk->len;
+		topk_sift_up(tk, tk->len - 1);
+		return (1);
+	}
+
+	min = tk->heap[0].count;
+	topk_unindex(tk, topk_slot_of(tk, 0));
+	free(tk->heap[0].key);
+	tk->heap[0] = (TopKEntry){dup, hash, add_sat(min, n), min};
+	*topk_find(tk, key, hash) = 1;
+	topk_sift_down(tk, 0);
+	return (1);
+}
+
+/**
+ * topk_get - look up a tracked key.
+ * @tk: the tracker.
+ * @key: the key, may be NULL.
+ *
+ * Return: the key's entry, NULL if the key is not tracked.
+ */
+const TopKEntry *topk_get(const TopK *tk, const char *key)
+{
+	size_t *slot = NULL;
+
+	if (!tk)
+		return (NULL);
+
+	slot = topk_find(tk, key, key_hash(tk->hash, key));
+	return (*slot ? &tk->heap[*slot - 1] : NULL);
+}
+
+/**
+ * entry_cmp_desc - order entries by descending count.
+ * @a: the first entry.
+ * @b: the second entry.
+ *
+ * Return: negative if `a` sorts first, positive if `b` does, else 0.
+ */
+static int entry_cmp_desc(const void *a, const void *b)
+{
+	const TopKEntry *x = a, *y = b;
+
+	return ((x->count < y->count) - (x->count > y->count));
+}
+
+/**
+ * topk_list - copy the tracked keys by descending count.
+ * @tk: the tracker.
+ * @out: array with room for `tk->len` entries, the keys stay owned by `tk`.
+ *
+ * Return: number of entries copied.
+ */
+size_t topk_list(const TopK *tk, TopKEntry *out)
+{
+	if (!tk || !out)
+		return (0);
+
+	memcpy(out, tk->heap, tk->len * sizeof(*out));
+	qsort(out, tk->len, sizeof(*out), entry_cmp_desc);
+	return (tk->len);
+}
+
+/**
+ * topk_merge - add the counts of one top-K tracker to another.
+ * @dst: the tracker to add to.
+ * @src: the tracker to add, must have the same `k` and hash function.
+ *
+ * A key missing from a full tracker may still have been counted up to that
+ * tracker's lowest count, which is added to the key's count and error. The
+ * `k` highest merged counts are kept. `dst` is unchanged on failure.
+ *
+ * Return: 1 on success, 0 if the trackers are incompatible or on allocation
+ * failure.
+ */
+int topk_merge(TopK *dst, const TopK *src)
+{
+	TopKEntry *all = NULL;
+	const TopKEntry *other = NULL;
+	size_t dmin = 0, smin = 0, n = 0, i = 0;
+
+	if (!dst || !src || dst == src || dst->k != src->k ||
+		dst->hash != src->hash)
+		return (0);
+
+	all = malloc((dst->len + src->len + 1) * sizeof(*all));
+	if (!all)
+		return (0);
+
+	dmin = dst->len == dst->k ? dst->heap[0].count : 0;
+	smin = src->len == src->k ? src->heap[0].count : 0;
+	for (i = 0; i < src->len; i++)
+	{
+		if (topk_get(dst, src->heap[i].key))
+			continue;
+
+		all[n] = src->heap[i];
+		all[n].key = src->heap[i].key ? strdup(src->heap[i].key) : NULL;
+		if (src->heap[i].key && !all[n].key)
+		{
+			while (n--)
+				free(all[n].key);
+
+			free(all);
+			return (0);
+		}
+
+		all[n].count = add_sat(all[n].count, dmin);
+		all[n].error = add_sat(all[n].error, dmin);
+		n++;
+	}
+
+	for (i = 0; i < dst->len; i++, n++)
+	{
+		all[n] = dst->heap[i];
+		other = topk_get(src, all[n].key);
+		all[n].count = add_sat(all[n].count, other ? other->count : smin);
+		all[n].error = add_sat(all[n].error, other ? other->error : smin);
+	}
+
+	qsort(all, n, sizeof(*all), entry_cmp_desc);
+	for (i = dst->k; i < n; i++)
+		free(all[i].key);
+
+	/* Ascending counts are already a valid min heap. */
+	dst->len = n < dst->k ? n : dst->k;
+	memset(dst->index, 0, (dst->index_mask + 1) * sizeof(*dst->index));
+	for (i = 0; i < dst->len; i++)
+	{
+		dst->heap[i] = all[dst->len - 1 - i];
+		*topk_find(dst, dst->heap[i].key, dst->heap[i].hash) = i + 1;
+	}
+
+	free(all);
+	return (1);
+}
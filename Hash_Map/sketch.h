@@ -0,0 +1,77 @@
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include "hashmap.h"
+
+/**
+ * struct CountMinSketch - approximate counts of keys in fixed memory.
+ * @width: counters per row, a power of 2.
+ * @depth: number of rows.
+ * @total: sum of all counts added.
+ * @hash: hash function applied to the keys.
+ * @counters: `depth` rows of `width` counters.
+ *
+ * Estimates never undercount and overcount by at most `total * e / width`
+ * with probability `1 - exp(-depth)`.
+ */
+typedef struct CountMinSketch
+{
+	size_t width;
+	size_t depth;
+	size_t total;
+	hm_hash *hash;
+	size_t *counters;
+} CountMinSketch;
+
+/**
+ * struct TopKEntry - a key tracked by a TopK.
+ * @key: the key, NULL keys are allowed.
+ * @hash: hash of the key.
+ * @count: upper bound of the key's count.
+ * @error: how much of `count` may have been inherited from evicted keys.
+ */
+typedef struct TopKEntry
+{
+	char *key;
+	size_t hash;
+	size_t count;
+	size_t error;
+} TopKEntry;
+
+/**
+ * struct TopK - space-saving tracker of the most frequent keys.
+ * @k: maximum number of keys tracked.
+ * @len: number of keys tracked.
+ * @hash: hash function applied to the keys.
+ * @heap: the tracked keys in a min heap ordered by count.
+ * @index: open addressing table of `heap` positions plus 1, 0 if empty.
+ * @index_mask: size of `index` minus 1, the size is a power of 2.
+ *
+ * Any key counted more than `total / k` times is guaranteed to be tracked.
+ */
+typedef struct TopK
+{
+	size_t k;
+	size_t len;
+	hm_hash *hash;
+	TopKEntry *heap;
+	size_t *index;
+	size_t index_mask;
+} TopK;
+
+CountMinSketch *cms_create(size_t width, size_t depth, hm_hash *hash);
+CountMinSketch *cms_create_bounded(double epsilon, double delta, hm_hash *hash);
+void cms_delete(CountMinSketch *cms);
+void cms_clear(CountMinSketch *cms);
+size_t cms_add(CountMinSketch *cms, const char *key, size_t n);
+size_t cms_estimate(const CountMinSketch *cms, const char *key);
+int cms_merge(CountMinSketch *dst, const CountMinSketch *src);
+
+TopK *topk_create(size_t k, hm_hash *hash);
+void topk_delete(TopK *tk);
+int topk_add(TopK *tk, const char *key, size_t n);
+const TopKEntry *topk_get(const TopK *tk, const char *key);
+size_t topk_list(const TopK *tk, TopKEntry *out);
+int topk_merge(TopK *dst, const TopK *src);
+
+#endif /* SKETCH_H */
@@ -4,6 +4,23 @@
 
 HashMap *hm = NULL;
 
+/**
+ * sum_counts - combine two decimal counts by adding them.
+ * @dst_value: count in the destination map.
+ * @src_value: count in the source map.
+ *
+ * Return: a new string with the sum.
+ */
+static char *sum_counts(char *dst_value, char *src_value)
+{
+	char *sum = malloc(24);
+
+	if (sum)
+		sprintf(sum, "%ld", atol(dst_value) + atol(src_value));
+
+	return (sum);
+}
+
 /**
  * setup - initialise some variables
  */
@@ -154,3 +171,338 @@ Test(long_inputs, test_insert_longvalue,
 	cr_assert(eq(str, b->value, value));
 	free(value);
 }
+
+TestSuite(writing, .init = setup, .fini = teardown);
+
+Test(writing, test_write_json_escapes,
+	 .description = "write(JSON) escapes strings", .timeout = 0)
+{
+	hm_writer w;
+
+	hashmap_insert(hm, "a\"b", "line\nbreak\\\x01");
+	cr_assert(hm_writer_init_mem(&w, HM_FORMAT_JSON));
+	cr_assert(hashmap_write(hm, &w));
+	cr_assert(eq(sz, w.len, sizeof("{\"a\\\"b\": \"line\\nbreak\\\\\\u0001\"}") - 1));
+	cr_assert(zero(int, memcmp(w.buf, "{\"a\\\"b\": \"line\\nbreak\\\\\\u0001\"}", w.len)));
+	hm_writer_release(&w);
+}
+
+Test(writing, test_write_json_nulls,
+	 .description = "write(JSON) with NULL key and value", .timeout = 0)
+{
+	hm_writer w;
+
+	hashmap_insert(hm, NULL, NULL);
+	cr_assert(hm_writer_init_mem(&w, HM_FORMAT_JSON));
+	cr_assert(hashmap_write(hm, &w));
+	cr_assert(eq(sz, w.len, sizeof("{\"\": null}") - 1));
+	cr_assert(zero(int, memcmp(w.buf, "{\"\": null}", w.len)));
+	hm_writer_release(&w);
+}
+
+Test(writing, test_write_binary,
+	 .description = "write(BINARY) length prefixes", .timeout = 0)
+{
+	hm_writer w;
+	const char expected[] = "HMB\1\2\0\0\0ab\xFF\xFF\xFF\xFF";
+
+	hashmap_insert(hm, "ab", NULL);
+	cr_assert(hm_writer_init_mem(&w, HM_FORMAT_BINARY));
+	cr_assert(hashmap_write(hm, &w));
+	cr_assert(eq(sz, w.len, sizeof(expected) - 1));
+	cr_assert(zero(int, memcmp(w.buf, expected, w.len)));
+	hm_writer_release(&w);
+}
+
+Test(writing, test_write_stream_reuses_buffer,
+	 .description = "write(TEXT) to a FILE twice", .timeout = 0)
+{
+	hm_writer w;
+	char out[64] = {0};
+	FILE *f = tmpfile();
+
+	cr_assert(f);
+	hashmap_insert(hm, "Hello", "World");
+	cr_assert(hm_writer_init_stream(&w, f, HM_FORMAT_TEXT));
+	cr_assert(hashmap_write(hm, &w));
+	cr_assert(hashmap_write(hm, &w));
+	cr_assert(zero(sz, w.len));
+	hm_writer_release(&w);
+
+	rewind(f);
+	cr_assert(fgets(out, sizeof(out), f));
+	fclose(f);
+	cr_assert(eq(str, out, "{'Hello': 'World'}{'Hello': 'World'}"));
+}
+
+TestSuite(sizing, .init = setup, .fini = teardown);
+
+Test(sizing, test_count_tracks_insert_and_remove,
+	 .description = "count after insert/remove", .timeout = 0)
+{
+	hashmap_insert(hm, "one", "1");
+	hashmap_insert(hm, "two", "2");
+	hashmap_insert(hm, "two", "deux");
+	cr_assert(eq(sz, hm->count, 2));
+
+	cr_assert(eq(int, hashmap_remove(hm, "one"), 1));
+	cr_assert(eq(int, hashmap_remove(hm, "one"), 0));
+	cr_assert(eq(sz, hm->count, 1));
+	cr_assert(zero(ptr, hashmap_get(hm, (str_literal) "one")));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "two")->value, "deux"));
+}
+
+Test(sizing, test_reserve_presizes,
+	 .description = "reserve(1000)", .timeout = 0)
+{
+	char key[16];
+	size_t i = 0;
+
+	cr_assert(hashmap_reserve(hm, 1000));
+	cr_assert(ge(sz, hm->size, 1000));
+	cr_assert(ge(sz, hm->capacity, 1000));
+
+	for (i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "k%zu", i);
+		cr_assert(hashmap_insert(hm, key, key));
+	}
+
+	cr_assert(eq(sz, hm->count, 1000));
+	cr_assert(eq(sz, hm->capacity, 1000));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "k999")->value, "k999"));
+}
+
+Test(sizing, test_shrink_to_fit_after_removal,
+	 .description = "shrink_to_fit() after mass removal", .timeout = 0)
+{
+	char key[16];
+	size_t i = 0;
+
+	for (i = 0; i < 500; ++i)
+	{
+		sprintf(key, "k%zu", i);
+		hashmap_insert(hm, key, key);
+	}
+
+	for (i = 0; i < 490; ++i)
+	{
+		sprintf(key, "k%zu", i);
+		hashmap_remove(hm, key);
+	}
+
+	cr_assert(hashmap_shrink_to_fit(hm));
+	cr_assert(eq(sz, hm->count, 10));
+	cr_assert(eq(sz, hm->capacity, 10));
+	cr_assert(eq(sz, hm->size, 10));
+	for (i = 490; i < 500; ++i)
+	{
+		sprintf(key, "k%zu", i);
+		cr_assert(eq(str, hashmap_get(hm, (str_literal)key)->value, key));
+	}
+
+	cr_assert(hashmap_insert(hm, "new", "value"));
+	cr_assert(eq(sz, hm->count, 11));
+}
+
+Test(sizing, test_reserve_zero_sized_hashmap,
+	 .description = "reserve() on create(0)", .timeout = 0)
+{
+	hashmap_delete(hm);
+	hm = hashmap_create(0);
+
+	cr_assert(zero(int, hashmap_insert(hm, "a", "b")));
+	cr_assert(hashmap_reserve(hm, 4));
+	cr_assert(hashmap_insert(hm, "a", "b"));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "a")->value, "b"));
+}
+
+TestSuite(allocation);
+
+Test(allocation, test_create_hugepage_hashmap,
+	 .description = "create_ex(HUGEPAGE)", .timeout = 0)
+{
+	const hm_alloc_opts opts = {.flags = HM_ALLOC_HUGEPAGE};
+	const size_t slots = (HM_MMAP_THRESHOLD / sizeof(Bucket *)) * 2;
+	HashMap *big = hashmap_create_ex(slots, &opts);
+	char key[16];
+	size_t i = 0;
+
+	cr_assert(big);
+	cr_assert(hashmap_reserve(big, slots));
+	for (i = 0; i < 1000; ++i)
+	{
+		sprintf(key, "k%zu", i);
+		cr_assert(hashmap_insert(big, key, key));
+	}
+
+	cr_assert(eq(str, hashmap_get(big, (str_literal) "k500")->value, "k500"));
+	cr_assert(hashmap_shrink_to_fit(big));
+	cr_assert(eq(str, hashmap_get(big, (str_literal) "k999")->value, "k999"));
+	hashmap_delete(big);
+}
+
+Test(allocation, test_create_numa_hashmap,
+	 .description = "create_ex(NUMA_*)", .timeout = 0)
+{
+	const size_t slots = (HM_MMAP_THRESHOLD / sizeof(Bucket *)) * 2;
+	const hm_alloc_opts empty = {.flags = HM_ALLOC_NUMA_BIND};
+	/* Node 0 always exists, the high bit names a node that does not. */
+	const hm_alloc_opts opts[] = {
+		{.flags = HM_ALLOC_NUMA_BIND, .numa_nodes = 1},
+		{.flags = HM_ALLOC_NUMA_INTERLEAVE, .numa_nodes = 1},
+		{.flags = HM_ALLOC_NUMA_BIND, .numa_nodes = 1UL << 31},
+	};
+	HashMap *big = NULL;
+	size_t i = 0;
+
+	cr_assert(zero(ptr, hashmap_create_ex(slots, &empty)));
+	cr_assert(zero(ptr, hashmap_create_ex(0, &empty)));
+	for (i = 0; i < sizeof(opts) / sizeof(*opts); ++i)
+	{
+		big = hashmap_create_ex(slots, &opts[i]);
+		cr_assert(big);
+		cr_assert(hashmap_reserve(big, slots));
+		cr_assert(hashmap_insert(big, "key", "value"));
+		cr_assert(
+			eq(str, hashmap_get(big, (str_literal) "key")->value, "value")
+		);
+		hashmap_delete(big);
+	}
+}
+
+TestSuite(snapshots, .init = setup, .fini = teardown);
+
+Test(snapshots, test_snapshot_is_frozen,
+	 .description = "snapshot() ignores later writes", .timeout = 0)
+{
+	HashMapSnapshot *snap = NULL;
+
+	hashmap_insert(hm, "one", "1");
+	hashmap_insert(hm, "two", "2");
+	hashmap_insert(hm, "three", "3");
+	snap = hashmap_snapshot(hm);
+	cr_assert(snap);
+
+	hashmap_insert(hm, "two", "deux");
+	hashmap_remove(hm, "three");
+	hashmap_insert(hm, "four", "4");
+
+	cr_assert(eq(sz, hashmap_snapshot_count(snap), 3));
+	cr_assert(eq(str, hashmap_snapshot_get(snap, (str_literal) "two")->value, "2"));
+	cr_assert(eq(str, hashmap_snapshot_get(snap, (str_literal) "three")->value, "3"));
+	cr_assert(zero(ptr, hashmap_snapshot_get(snap, (str_literal) "four")));
+
+	cr_assert(eq(sz, hm->count, 3));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "two")->value, "deux"));
+	cr_assert(zero(ptr, hashmap_get(hm, (str_literal) "three")));
+	hashmap_snapshot_release(snap);
+
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "two")->value, "deux"));
+}
+
+Test(snapshots, test_snapshot_single_slot_chain,
+	 .description = "snapshot() with every key in one slot", .timeout = 0)
+{
+	HashMapSnapshot *s1 = NULL, *s2 = NULL;
+	hm_writer w;
+
+	hashmap_delete(hm);
+	hm = hashmap_create(1);
+	hashmap_insert(hm, "a", "1");
+	hashmap_insert(hm, "b", "2");
+	hashmap_insert(hm, "c", "3");
+	s1 = hashmap_snapshot(hm);
+
+	hashmap_insert(hm, "a", "10");
+	hashmap_remove(hm, "b");
+	s2 = hashmap_snapshot(hm);
+	hashmap_insert(hm, "a", "100");
+	hashmap_remove(hm, "c");
+	hashmap_remove(hm, "a");
+
+	cr_assert(hm_writer_init_mem(&w, HM_FORMAT_JSON));
+	cr_assert(hashmap_snapshot_write(s1, &w));
+	cr_assert(eq(sz, w.len, sizeof("{\"c\": \"3\", \"b\": \"2\", \"a\": \"1\"}") - 1));
+	cr_assert(zero(int, memcmp(w.buf, "{\"c\": \"3\", \"b\": \"2\", \"a\": \"1\"}", w.len)));
+	w.len = 0;
+	cr_assert(hashmap_snapshot_write(s2, &w));
+	cr_assert(eq(sz, w.len, sizeof("{\"c\": \"3\", \"a\": \"10\"}") - 1));
+	cr_assert(zero(int, memcmp(w.buf, "{\"c\": \"3\", \"a\": \"10\"}", w.len)));
+	hm_writer_release(&w);
+
+	cr_assert(zero(int, hashmap_shrink_to_fit(hm)));
+	hashmap_snapshot_release(s1);
+	hashmap_snapshot_release(s2);
+	cr_assert(zero(sz, hm->count));
+	cr_assert(hashmap_shrink_to_fit(hm));
+}
+
+TestSuite(merging, .init = setup, .fini = teardown);
+
+Test(merging, test_merge_combines_duplicates,
+	 .description = "merge(dst, src, sum)", .timeout = 0)
+{
+	HashMap *src = hashmap_create(3);
+
+	hashmap_insert(hm, "apple", "2");
+	hashmap_insert(hm, "pear", "1");
+	hashmap_insert(src, "apple", "5");
+	hashmap_insert(src, "plum", "7");
+
+	cr_assert(hashmap_merge(hm, src, sum_counts));
+	cr_assert(eq(sz, hm->count, 3));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "apple")->value, "7"));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "pear")->value, "1"));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "plum")->value, "7"));
+
+	cr_assert(zero(sz, src->count));
+	cr_assert(zero(ptr, hashmap_get(src, (str_literal) "plum")));
+	cr_assert(hashmap_insert(src, "plum", "8"));
+	hashmap_delete(src);
+}
+
+Test(merging, test_merge_without_combine_replaces,
+	 .description = "merge(dst, src, NULL)", .timeout = 0)
+{
+	HashMap *src = hashmap_create(10);
+
+	hashmap_insert(hm, "apple", "2");
+	hashmap_insert(src, "apple", "5");
+	cr_assert(hashmap_merge(hm, src, NULL));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "apple")->value, "5"));
+	cr_assert(zero(int, hashmap_merge(hm, hm, NULL)));
+	hashmap_delete(src);
+}
+
+Test(merging, test_merge_parallel,
+	 .description = "merge_parallel(dst, src, sum, 4)", .timeout = 0)
+{
+	HashMap *src = hashmap_create(997);
+	char key[16];
+	size_t i = 0;
+
+	hashmap_delete(hm);
+	hm = hashmap_create(1024);
+	for (i = 0; i < 5000; ++i)
+	{
+		sprintf(key, "k%zu", i);
+		hashmap_insert(hm, key, "1");
+		sprintf(key, "k%zu", i + 2500);
+		hashmap_insert(src, key, "2");
+	}
+
+	cr_assert(hashmap_merge_parallel(hm, src, sum_counts, 4));
+	cr_assert(eq(sz, hm->count, 7500));
+	cr_assert(zero(sz, src->count));
+	for (i = 0; i < 7500; ++i)
+	{
+		sprintf(key, "k%zu", i);
+		cr_assert(eq(
+			str, hashmap_get(hm, (str_literal)key)->value,
+			i < 2500 ? "1" : (i < 5000 ? "3" : "2")
+		));
+	}
+
+	hashmap_delete(src);
+}
@@ -0,0 +1,134 @@
+#include "json_strlist.h"
+#include <criterion/criterion.h>
+#include <criterion/new/assert.h>
+#include <unistd.h>
+
+static char path[2][32];
+
+/**
+ * write_json - write text to one of the temporary files.
+ * @i: index of the file.
+ * @text: contents of the file.
+ *
+ * Return: path to the file, NULL on error.
+ */
+static const char *write_json(int i, const char *text)
+{
+	int fd = -1;
+	size_t len = strlen(text);
+	ssize_t written = 0;
+
+	strcpy(path[i], "/tmp/test_jsonXXXXXX");
+	fd = mkstemp(path[i]);
+	if (fd < 0)
+		return (NULL);
+
+	written = write(fd, text, len);
+	close(fd);
+	return (written == (ssize_t)len ? path[i] : NULL);
+}
+
+/**
+ * count_until - count strings, stopping at the string "stop".
+ * @str: the string.
+ * @len: length of the string.
+ * @ctx: pointer to the count.
+ *
+ * Return: non-zero if `str` is "stop".
+ */
+static int count_until(const char *str, size_t len, void *ctx)
+{
+	(*(size_t *)ctx)++;
+	return (len == 4 && !memcmp(str, "stop", 4));
+}
+
+/**
+ * teardown - remove the temporary files
+ */
+void teardown(void)
+{
+	int i = 0;
+
+	for (i = 0; i < 2; i++)
+	{
+		if (path[i][0])
+			unlink(path[i]);
+
+		path[i][0] = '\0';
+	}
+}
+
+TestSuite(streaming, .fini = teardown);
+
+Test(streaming, test_next_plain_and_escaped,
+	 .description = "next() returns plain and escaped strings", .timeout = 0)
+{
+	json_strlist *list = json_strlist_open(write_json(
+		0, " [\"a string longer than sixteen bytes\", 42, {\"k\": [\"]\"]},"
+		   "\"tab\\there \\\"quoted\\\" \\u00e9\\ud83d\\ude00\", null]\n"
+	));
+	const char *s = NULL;
+	size_t len = 0;
+
+	cr_assert(list);
+	cr_assert(eq(int, json_strlist_next(list, &s, &len), 1));
+	cr_assert(eq(sz, len, strlen("a string longer than sixteen bytes")));
+	cr_assert(zero(int, memcmp(s, "a string longer than sixteen bytes", len)));
+	cr_assert(eq(int, json_strlist_next(list, &s, &len), 1));
+	cr_assert(eq(str, (char *)s, "tab\there \"quoted\" \xC3\xA9\xF0\x9F\x98\x80"));
+	cr_assert(eq(sz, len, strlen(s)));
+	cr_assert(zero(int, json_strlist_next(list, &s, &len)));
+	cr_assert(zero(int, json_strlist_next(list, &s, &len)));
+	json_strlist_close(list);
+}
+
+Test(streaming, test_next_malformed,
+	 .description = "next() rejects malformed input", .timeout = 0)
+{
+	json_strlist *list = json_strlist_open(write_json(0, "[\"unterminated\\\""));
+	const char *s = NULL;
+	size_t len = 0;
+
+	cr_assert(list);
+	cr_assert(eq(int, json_strlist_next(list, &s, &len), -1));
+	json_strlist_close(list);
+
+	list = json_strlist_open(write_json(1, "{\"not\": \"an array\"}"));
+	cr_assert(list);
+	cr_assert(eq(int, json_strlist_next(list, &s, &len), -1));
+	json_strlist_close(list);
+}
+
+Test(streaming, test_open_empty_file,
+	 .description = "open() of an empty file fails", .timeout = 0)
+{
+	cr_assert(zero(ptr, json_strlist_open(write_json(0, ""))));
+	cr_assert(zero(ptr, json_strlist_open(NULL)));
+}
+
+Test(streaming, test_foreach_stops,
+	 .description = "foreach() stops when the callback asks", .timeout = 0)
+{
+	size_t n = 0;
+
+	cr_assert(write_json(0, "[\"a\", \"b\", \"stop\", \"c\"]"));
+	cr_assert(eq(int, (int)json_strlist_foreach(path[0], count_until, &n), 3));
+	cr_assert(eq(sz, n, 3));
+}
+
+Test(streaming, test_load_json_pairs,
+	 .description = "load_json() pairs keys and values by position",
+	 .timeout = 0)
+{
+	HashMap *hm = hashmap_create(8);
+
+	cr_assert(hm);
+	cr_assert(write_json(0, "[\"one\", \"t\\u0077o\", \"three\"]"));
+	cr_assert(write_json(1, "[\"1\", \"2\"]"));
+	cr_assert(eq(int, (int)hashmap_load_json(hm, path[0], path[1]), 2));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "one")->value, "1"));
+	cr_assert(eq(str, hashmap_get(hm, (str_literal) "two")->value, "2"));
+	cr_assert(zero(ptr, hashmap_get(hm, (str_literal) "three")));
+	cr_assert(eq(int, (int)hashmap_load_json(hm, path[0], "/nonexistent"), -1));
+	hashmap_delete(hm);
+}
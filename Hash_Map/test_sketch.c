@@ -0,0 +1,158 @@
+#include "sketch.h"
+#include <criterion/criterion.h>
+#include <criterion/new/assert.h>
+
+/**
+ * bad_hash - hash every key to the same value.
+ * @key: the key.
+ *
+ * Return: 7
+ */
+static size_t bad_hash(str_literal key)
+{
+	(void)key;
+	return (7);
+}
+
+TestSuite(count_min);
+
+Test(count_min, test_cms_never_undercounts,
+	 .description = "estimates are upper bounds of the counts", .timeout = 0)
+{
+	CountMinSketch *cms = cms_create(64, 4, NULL);
+	char key[16];
+	size_t i = 0;
+
+	cr_assert(cms);
+	cr_assert(eq(sz, cms->width, 64));
+	for (i = 0; i < 1000; i++)
+	{
+		sprintf(key, "k%zu", i % 100);
+		cms_add(cms, key, i % 100 + 1);
+	}
+
+	for (i = 0; i < 100; i++)
+	{
+		sprintf(key, "k%zu", i);
+		cr_assert(ge(sz, cms_estimate(cms, key), 10 * (i + 1)));
+	}
+
+	cr_assert(eq(sz, cms_estimate(cms, NULL), 0));
+	cms_delete(cms);
+}
+
+Test(count_min, test_cms_exact_when_sparse,
+	 .description = "a wide sketch counts few keys exactly", .timeout = 0)
+{
+	CountMinSketch *cms = cms_create_bounded(0.001, 0.01, NULL);
+
+	cr_assert(cms);
+	cr_assert(eq(sz, cms->depth, 5));
+	cr_assert(ge(sz, cms->width, 2719));
+	cr_assert(eq(sz, cms_add(cms, "a", 3), 3));
+	cr_assert(eq(sz, cms_add(cms, "a", 2), 5));
+	cr_assert(eq(sz, cms_add(cms, NULL, 1), 1));
+	cr_assert(eq(sz, cms_estimate(cms, "a"), 5));
+	cr_assert(eq(sz, cms->total, 6));
+	cms_clear(cms);
+	cr_assert(zero(sz, cms_estimate(cms, "a")));
+	cms_delete(cms);
+}
+
+Test(count_min, test_cms_merge,
+	 .description = "merge() adds counts of compatible sketches", .timeout = 0)
+{
+	CountMinSketch *a = cms_create(256, 3, NULL), *b = cms_create(256, 3, NULL);
+	CountMinSketch *c = cms_create(128, 3, NULL);
+
+	cr_assert(a && b && c);
+	cms_add(a, "x", 4);
+	cms_add(b, "x", 5);
+	cms_add(b, "y", 1);
+	cr_assert(cms_merge(a, b));
+	cr_assert(eq(sz, cms_estimate(a, "x"), 9));
+	cr_assert(ge(sz, cms_estimate(a, "y"), 1));
+	cr_assert(eq(sz, a->total, 10));
+	cr_assert(zero(int, cms_merge(a, c)));
+	cr_assert(zero(int, cms_merge(a, a)));
+	cms_delete(a);
+	cms_delete(b);
+	cms_delete(c);
+}
+
+TestSuite(top_k);
+
+Test(top_k, test_topk_tracks_heavy_hitters,
+	 .description = "keys above total / k are tracked", .timeout = 0)
+{
+	TopK *tk = topk_create(4, NULL);
+	TopKEntry out[4];
+	char key[16];
+	size_t i = 0;
+
+	cr_assert(tk);
+	for (i = 0; i < 2000; i++)
+	{
+		sprintf(key, "noise%zu", i);
+		cr_assert(topk_add(tk, key, 1));
+		cr_assert(topk_add(tk, "heavy", 2));
+		if (i % 2)
+			cr_assert(topk_add(tk, NULL, 1));
+	}
+
+	cr_assert(topk_get(tk, "heavy"));
+	cr_assert(ge(sz, topk_get(tk, "heavy")->count, 4000));
+	cr_assert(topk_get(tk, NULL));
+	cr_assert(ge(sz, topk_get(tk, NULL)->count, 1000));
+	cr_assert(eq(sz, topk_list(tk, out), 4));
+	cr_assert(eq(str, out[0].key, "heavy"));
+	for (i = 1; i < 4; i++)
+		cr_assert(ge(sz, out[i - 1].count, out[i].count));
+
+	topk_delete(tk);
+}
+
+Test(top_k, test_topk_collisions,
+	 .description = "keys sharing a hash stay distinct", .timeout = 0)
+{
+	TopK *tk = topk_create(3, bad_hash);
+	char key[16];
+	size_t i = 0;
+
+	cr_assert(tk);
+	for (i = 0; i < 50; i++)
+	{
+		sprintf(key, "k%zu", i % 5);
+		cr_assert(topk_add(tk, key, i % 5 == 0 ? 10 : 1));
+	}
+
+	cr_assert(eq(sz, tk->len, 3));
+	cr_assert(topk_get(tk, "k0"));
+	cr_assert(eq(sz, topk_get(tk, "k0")->count, 100));
+	cr_assert(eq(sz, topk_get(tk, "k0")->error, 0));
+	topk_delete(tk);
+}
+
+Test(top_k, test_topk_merge,
+	 .description = "merge() keeps the k highest combined counts",
+	 .timeout = 0)
+{
+	TopK *a = topk_create(2, NULL), *b = topk_create(2, NULL);
+	TopK *c = topk_create(3, NULL);
+
+	cr_assert(a && b && c);
+	topk_add(a, "x", 10);
+	topk_add(a, "y", 3);
+	topk_add(b, "x", 1);
+	topk_add(b, "z", 8);
+	cr_assert(topk_merge(a, b));
+	cr_assert(eq(sz, a->len, 2));
+	cr_assert(eq(sz, topk_get(a, "x")->count, 11));
+	cr_assert(eq(sz, topk_get(a, "z")->count, 11));
+	cr_assert(eq(sz, topk_get(a, "z")->error, 3));
+	cr_assert(zero(ptr, topk_get(a, "y")));
+	cr_assert(zero(int, topk_merge(a, c)));
+	topk_delete(a);
+	topk_delete(b);
+	topk_delete(c);
+}
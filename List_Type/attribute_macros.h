@@ -52,6 +52,20 @@
 
 #endif /* defined __has_attribute */
 
+#define PREFETCH(addr) ((void)(addr))
+
+/* https://gcc.gnu.org/onlinedocs/cpp/_005f_005fhas_005fbuiltin.html */
+#if defined __has_builtin
+
+	/* https://gcc.gnu.org/onlinedocs/gcc/Other-Builtins.html */
+	#if __has_builtin(__builtin_prefetch)
+		#undef PREFETCH
+		/* INFO: only a hint, never faults, not even on NULL. */
+		#define PREFETCH(addr) __builtin_prefetch(addr)
+	#endif /* __has_builtin(__builtin_prefetch) */
+
+#endif /* defined __has_builtin */
+
 /* program_invocation_name */
 #ifndef _GNU_SOURCE
 	#define _GNU_SOURCE
@@ -0,0 +1,309 @@
+#include <stdlib.h> /* *alloc */
+#include <string.h> /* memmove */
+
+#include "block_deque.h"
+#include "list_type_structs.h"
+
+/* Number of map entries allocated with the first block. */
+#define BDQ_MAP_MIN ((size_t)8)
+
+/**
+ * bdq_slot - get the slot at a position of a `block_deque`.
+ * @bdq: the `block_deque`.
+ * @pos: the position, its block must be allocated.
+ *
+ * Return: pointer to the slot.
+ */
+static void **bdq_slot(const block_deque *const restrict bdq, const size_t pos)
+{
+	return (&bdq->map[pos / BDQ_BLOCK_LEN][pos % BDQ_BLOCK_LEN]);
+}
+
+/**
+ * bdq_block_get - make sure the block holding a position is allocated.
+ * @bdq: the `block_deque`.
+ * @pos: the position.
+ *
+ * Return: 1 on success, 0 on allocation failure.
+ */
+static int bdq_block_get(block_deque *const restrict bdq, const size_t pos)
+{
+	void ***const entry = &bdq->map[pos / BDQ_BLOCK_LEN];
+
+	if (*entry)
+		return (1);
+
+	if (bdq->spare)
+	{
+		*entry = bdq->spare;
+		bdq->spare = NULL;
+		return (1);
+	}
+
+	*entry = malloc(sizeof(**entry) * BDQ_BLOCK_LEN);
+	return (*entry != NULL);
+}
+
+/**
+ * bdq_block_put - release the block holding a position.
+ * @bdq: the `block_deque`.
+ * @pos: the position.
+ *
+ * One released block is kept so that a deque oscillating across a block
+ * boundary does not allocate on every push.
+ */
+static void bdq_block_put(block_deque *const restrict bdq, const size_t pos)
+{
+	void ***const entry = &bdq->map[pos / BDQ_BLOCK_LEN];
+
+	if (bdq->spare)
+		free(*entry);
+	else
+		bdq->spare = *entry;
+
+	*entry = NULL;
+}
+
+/**
+ * bdq_map_recentre - make room in the map on both sides of the used blocks.
+ * @bdq: the `block_deque`.
+ *
+ * The used block pointers are moved to the middle of the map, which is
+ * doubled first if they fill half of it or more. Blocks themselves never
+ * move, so slots stay valid until their element is popped.
+ *
+ * Return: 1 on success, 0 on allocation failure.
+ */
+static int bdq_map_recentre(block_deque *const restrict bdq)
+{
+	const size_t first = bdq->head / BDQ_BLOCK_LEN;
+	const size_t used =
+		bdq->len ? ((bdq->head + (size_t)bdq->len - 1) / BDQ_BLOCK_LEN) -
+					   first + 1
+				 : 0;
+	size_t map_len = bdq->map_len;
+	void ***map = bdq->map;
+
+	if (map_len < BDQ_MAP_MIN || used * 2 >= map_len)
+	{
+		map_len = map_len < BDQ_MAP_MIN ? BDQ_MAP_MIN : map_len * 2;
+		if (map_len > SIZE_MAX / sizeof(*map) / BDQ_BLOCK_LEN)
+			return (0);
+
+		map = realloc(map, sizeof(*map) * map_len);
+		if (!map)
+			return (0);
+
+		memset(map + bdq->map_len, 0, sizeof(*map) * (map_len - bdq->map_len));
+	}
+
+	const size_t new_first = (map_len - used) / 2;
+
+	memmove(map + new_first, map + first, sizeof(*map) * used);
+	if (new_first > first)
+		memset(map + first, 0, sizeof(*map) * (new_first - first));
+	else
+		memset(map + new_first + used, 0, sizeof(*map) * (first - new_first));
+
+	bdq->map = map;
+	bdq->map_len = map_len;
+	bdq->head = new_first * BDQ_BLOCK_LEN + bdq->head % BDQ_BLOCK_LEN;
+	if (!used)
+		bdq->head = (map_len / 2) * BDQ_BLOCK_LEN + BDQ_BLOCK_LEN / 2;
+
+	return (1);
+}
+
+/**
+ * bdq_new - allocate and initialise memory for a `block_deque`.
+ *
+ * Return: pointer to the new deque.
+ */
+block_deque *bdq_new(void) { return (calloc(1, sizeof(block_deque))); }
+
+/**
+ * bdq_clear - remove all the elements of a `block_deque`.
+ * @bdq: the `block_deque` to operate on.
+ * @free_data: pointer to a function that will be called to free the data.
+ *
+ * The map and one block are kept for reuse.
+ */
+void bdq_clear(block_deque *const restrict bdq, free_func *free_data)
+{
+	if (!bdq || !bdq->len)
+		return;
+
+	const size_t end = bdq->head + (size_t)bdq->len;
+
+	for (size_t pos = bdq->head; pos < end; ++pos)
+	{
+		if (free_data)
+			free_data(*bdq_slot(bdq, pos));
+
+		if ((pos + 1) % BDQ_BLOCK_LEN == 0 || pos + 1 == end)
+			bdq_block_put(bdq, pos);
+	}
+
+	bdq->len = 0;
+}
+
+/**
+ * bdq_del - free a `block_deque` from memory.
+ * @bdq: pointer to the `block_deque` to delete.
+ * @free_data: pointer to a function that can free data in the deque.
+ *
+ * Return: NULL always.
+ */
+void *bdq_del(block_deque *const restrict bdq, free_func *free_data)
+{
+	if (!bdq)
+		return (NULL);
+
+	bdq_clear(bdq, free_data);
+	free(bdq->spare);
+	free(bdq->map);
+	free(bdq);
+	return (NULL);
+}
+
+/**
+ * bdq_push_head - add an element to the head of a `block_deque`.
+ * @bdq: the `block_deque` to operate on.
+ * @data: data of the element.
+ * @copy_data: function that returns a separate copy of data,
+ * if NULL a simple copy of the pointer to data is done.
+ *
+ * Return: pointer to the element's slot, valid until the element is popped,
+ * NULL on failure.
+ */
+void **bdq_push_head(
+	block_deque *const restrict bdq, void *const data, dup_func *copy_data
+)
+{
+	if (!bdq)
+		return (NULL);
+
+	if (bdq->head == 0 && !bdq_map_recentre(bdq))
+		return (NULL);
+
+	if (!bdq_block_get(bdq, bdq->head - 1))
+		return (NULL);
+
+	void *const d = copy_data ? copy_data(data) : data;
+
+	if (!d && data)
+	{
+		if (!bdq->len || bdq->head % BDQ_BLOCK_LEN == 0)
+			bdq_block_put(bdq, bdq->head - 1);
+
+		return (NULL);
+	}
+
+	--(bdq->head);
+	++(bdq->len);
+	*bdq_slot(bdq, bdq->head) = d;
+	return (bdq_slot(bdq, bdq->head));
+}
+
+/**
+ * bdq_push_tail - add an element to the tail of a `block_deque`.
+ * @bdq: the `block_deque` to operate on.
+ * @data: data of the element.
+ * @copy_data: function that returns a separate copy of data,
+ * if NULL a simple copy of the pointer to data is done.
+ *
+ * Return: pointer to the element's slot, valid until the element is popped,
+ * NULL on failure.
+ */
+void **bdq_push_tail(
+	block_deque *const restrict bdq, void *const data, dup_func *copy_data
+)
+{
+	if (!bdq)
+		return (NULL);
+
+	if (!bdq->map_len ||
+		(bdq->head + (size_t)bdq->len) / BDQ_BLOCK_LEN >= bdq->map_len)
+	{
+		if (!bdq_map_recentre(bdq))
+			return (NULL);
+	}
+
+	const size_t pos = bdq->head + (size_t)bdq->len;
+
+	if (!bdq_block_get(bdq, pos))
+		return (NULL);
+
+	void *const d = copy_data ? copy_data(data) : data;
+
+	if (!d && data)
+	{
+		if (!bdq->len || pos % BDQ_BLOCK_LEN == 0)
+			bdq_block_put(bdq, pos);
+
+		return (NULL);
+	}
+
+	++(bdq->len);
+	*bdq_slot(bdq, pos) = d;
+	return (bdq_slot(bdq, pos));
+}
+
+/**
+ * bdq_pop_head - pop the head element of a `block_deque`.
+ * @bdq: the `block_deque` to operate on.
+ *
+ * Return: the data of the popped element, NULL if the deque is empty.
+ */
+void *bdq_pop_head(block_deque *const restrict bdq)
+{
+	if (!bdq || bdq->len < 1)
+		return (NULL);
+
+	const size_t pos = bdq->head;
+	void *const d = *bdq_slot(bdq, pos);
+
+	++(bdq->head);
+	--(bdq->len);
+	if (bdq->head % BDQ_BLOCK_LEN == 0 || !bdq->len)
+		bdq_block_put(bdq, pos);
+
+	return (d);
+}
+
+/**
+ * bdq_pop_tail - pop the tail element of a `block_deque`.
+ * @bdq: the `block_deque` to operate on.
+ *
+ * Return: the data of the popped element, NULL if the deque is empty.
+ */
+void *bdq_pop_tail(block_deque *const restrict bdq)
+{
+	if (!bdq || bdq->len < 1)
+		return (NULL);
+
+	const size_t pos = bdq->head + (size_t)bdq->len - 1;
+	void *const d = *bdq_slot(bdq, pos);
+
+	--(bdq->len);
+	if (pos % BDQ_BLOCK_LEN == 0 || !bdq->len)
+		bdq_block_put(bdq, pos);
+
+	return (d);
+}
+
+/**
+ * bdq_get - get the data of an element of a `block_deque` in O(1).
+ * @bdq: the `block_deque`.
+ * @i: index of the element from the head, negative indices count back from
+ * the tail with -1 being the tail.
+ *
+ * Return: the data of the element, NULL if the index is out of range.
+ */
+void *bdq_get(const block_deque *const restrict bdq, const intmax_t i)
+{
+	if (!bdq || i >= bdq->len || i < -bdq->len)
+		return (NULL);
+
+	return (*bdq_slot(bdq, bdq->head + (size_t)(i < 0 ? bdq->len + i : i)));
+}
@@ -0,0 +1,30 @@
+#ifndef DS_BLOCK_DEQUE_TYPE_H
+#define DS_BLOCK_DEQUE_TYPE_H
+
+#include <stdint.h> /* intmax_t */
+
+#include "attribute_macros.h"
+#include "list_type_typedefs.h"
+
+/* alloc and free */
+
+void *bdq_del(block_deque *const restrict bdq, free_func *free_data);
+block_deque *bdq_new(void) ATTR_MALLOC ATTR_MALLOC_FREE(bdq_del);
+
+/* manipulate */
+
+void **bdq_push_head(
+	block_deque *const restrict bdq, void *const data, dup_func *copy_data
+);
+void **bdq_push_tail(
+	block_deque *const restrict bdq, void *const data, dup_func *copy_data
+);
+void *bdq_pop_head(block_deque *const restrict bdq);
+void *bdq_pop_tail(block_deque *const restrict bdq);
+void bdq_clear(block_deque *const restrict bdq, free_func *free_data);
+
+/* access */
+
+void *bdq_get(const block_deque *const restrict bdq, const intmax_t i);
+
+#endif /* DS_BLOCK_DEQUE_TYPE_H */
@@ -1,9 +1,45 @@
-#include <string.h> /* strcpy */
+#include <inttypes.h> /* imaxabs */
+#include <string.h>   /* memcpy, strcpy */
 
 #include "deque.h"
 #include "list_node.h"
 #include "list_type_structs.h"
 #include "matrix.h"
+#include "node_pool.h"
+#include "str_buf.h"
+
+/**
+ * dq_node_new - allocate a node for a `deque`.
+ * @dq: the `deque` the node is for.
+ * @data: data that the node will hold.
+ * @copy_data: function that will be called to duplicate `data`.
+ *
+ * Return: pointer to the new node, NULL on failure.
+ */
+static list_node *
+dq_node_new(const deque *const restrict dq, void *data, dup_func *copy_data)
+{
+	if (dq->pool)
+		return (ndpool_alloc(dq->pool, data, copy_data));
+
+	return (lstnode_new(data, copy_data));
+}
+
+/**
+ * dq_node_del - unlink and free a node of a `deque`.
+ * @dq: the `deque` the node belongs to.
+ * @node: the node.
+ *
+ * Return: pointer to the data in the node.
+ */
+static void *
+dq_node_del(const deque *const restrict dq, list_node *const restrict node)
+{
+	if (dq->pool)
+		return (ndpool_free(dq->pool, node));
+
+	return (lstnode_del(node));
+}
 
 /**
  * dq_new - allocate and initialise memory for a `deque`.
@@ -13,31 +49,200 @@
 deque *dq_new(void) { return (calloc(1, sizeof(deque))); }
 
 /**
- * dq_clear - free all the nodes of a `deque`.
- * @dq: the `deque` to operate on.
+ * dq_pool_release - give up a deque's share of the pool it owns.
+ * @dq: the `deque`.
+ *
+ * The pool is freed when its last owner releases it. `dq->pool` is left to
+ * the caller.
+ */
+static void dq_pool_release(deque *const restrict dq)
+{
+	if (!dq->owns_pool)
+		return;
+
+	dq->owns_pool = 0;
+	if (--(dq->pool->n_owners) == 0)
+		ndpool_del(dq->pool);
+}
+
+/**
+ * dq_set_pool - take the nodes of a `deque` from a `node_pool`.
+ * @dq: the `deque`, must be empty.
+ * @pool: the pool, NULL to go back to malloc'd nodes. A pool may be shared
+ * by deques used from the same thread, and must outlive them.
+ *
+ * Nodes of a pooled deque belong to the pool, they must be released with the
+ * deque's functions and never with `lstnode_del`. A pool the deque created
+ * itself, see `dq_from_array`, is released when it is replaced.
+ *
+ * Return: 1 on success, 0 if the deque is NULL or not empty.
+ */
+int dq_set_pool(deque *const restrict dq, node_pool *const pool)
+{
+	if (!dq || dq->head)
+		return (0);
+
+	if (dq->pool != pool)
+		dq_pool_release(dq);
+
+	dq->pool = pool;
+	return (1);
+}
+
+/**
+ * dq_free_data - `data_action` adapter calling a `free_func`.
+ * @data: the data to free.
+ * @free_data: pointer to a `free_func` pointer.
+ */
+static void dq_free_data(void *const data, void *const free_data)
+{
+	(*(free_func **)free_data)(data);
+}
+
+/**
+ * dq_chain_del - free a detached chain of nodes of a `deque`.
+ * @dq: the `deque` the nodes belong to.
+ * @head: the first node, nothing may link to it.
+ * @tail: the last node, nothing may follow it.
+ * @n: number of nodes from `head` to `tail`.
  * @free_data: pointer to a function that will be called to free data in nodes.
+ *
+ * The nodes of a pooled deque are handed back to the pool in one step, the
+ * chain is only walked if there is data to free.
  */
-void dq_clear(deque *const restrict dq, free_func *free_data)
+static void dq_chain_del(
+	const deque *const restrict dq, list_node *const head,
+	list_node *const tail, const size_t n, free_func *free_data
+)
 {
-	if (!dq || !dq->head)
+	if (!dq->pool)
+	{
+		linked_list_del(head, free_data);
 		return;
+	}
 
-	list_node *next_node = lstnode_get_next(dq->head);
+	if (free_data)
+		linked_list_foreach(head, dq_free_data, &free_data);
 
-	while (dq->head)
+	ndpool_free_chain(dq->pool, head, tail, n);
+}
+
+/**
+ * dq_chain_new - allocate a chain of nodes for an array of data.
+ * @dq: the `deque` the nodes are for.
+ * @data: the array of data.
+ * @n: number of items in `data`, must be at least 1.
+ * @reverse: whether to link the items from the last to the first.
+ * @copy_data: function that will be called to duplicate the data.
+ * @free_data: function that will be called to free copies on failure,
+ * unused if `copy_data` is NULL as the data is then borrowed from `data`.
+ * @tail: out parameter for the last node of the chain.
+ *
+ * A pooled deque reserves all the nodes with a single allocation.
+ *
+ * Return: pointer to the first node of the chain, NULL on failure, in which
+ * case nothing is left allocated.
+ */
+static list_node *dq_chain_new(
+	const deque *const restrict dq, void *const *const restrict data,
+	const size_t n, const int reverse, dup_func *copy_data,
+	free_func *free_data, list_node **const restrict tail
+)
+{
+	if (dq->pool && !ndpool_reserve(dq->pool, n))
+		return (NULL);
+
+	list_node *head = NULL, *last = NULL;
+
+	for (size_t i = 0; i < n; ++i)
 	{
-		void *d = lstnode_del(dq->head);
+		list_node *const nw =
+			dq_node_new(dq, data[reverse ? n - 1 - i : i], copy_data);
 
-		if (free_data)
-			free_data(d);
+		if (!nw)
+		{
+			if (head)
+				dq_chain_del(
+					dq, head, last, i, copy_data ? free_data : NULL
+				);
+
+			return (NULL);
+		}
+
+		nw->prev = last;
+		if (last)
+			last->next = nw;
+		else
+			head = nw;
+
+		last = nw;
+	}
+
+	*tail = last;
+	return (head);
+}
+
+/**
+ * dq_chain_copy - allocate a chain of nodes holding the data of another
+ * chain.
+ * @dq: the `deque` the new nodes are for.
+ * @node: the first node of the chain to copy.
+ * @n: number of nodes to copy, must be at least 1.
+ * @tail: out parameter for the last node of the new chain.
+ *
+ * Return: pointer to the first node of the new chain, NULL on failure, in
+ * which case nothing is left allocated.
+ */
+static list_node *dq_chain_copy(
+	const deque *const restrict dq, list_node const *node, const size_t n,
+	list_node **const restrict tail
+)
+{
+	if (dq->pool && !ndpool_reserve(dq->pool, n))
+		return (NULL);
+
+	list_node *head = NULL, *last = NULL;
 
-		dq->head = next_node;
-		next_node = dq->head ? lstnode_get_next(dq->head) : NULL;
+	for (size_t i = 0; i < n; ++i, node = node->next)
+	{
+		list_node *const nw = dq_node_new(dq, node->data, NULL);
+
+		if (!nw)
+		{
+			if (head)
+				dq_chain_del(dq, head, last, i, NULL);
+
+			return (NULL);
+		}
+
+		nw->prev = last;
+		if (last)
+			last->next = nw;
+		else
+			head = nw;
+
+		last = nw;
 	}
 
+	*tail = last;
+	return (head);
+}
+
+/**
+ * dq_clear - free all the nodes of a `deque`.
+ * @dq: the `deque` to operate on.
+ * @free_data: pointer to a function that will be called to free data in nodes.
+ */
+void dq_clear(deque *const restrict dq, free_func *free_data)
+{
+	if (!dq || !dq->head)
+		return;
+
+	dq_chain_del(dq, dq->head, dq->tail, (size_t)dq->len, free_data);
 	dq->head = NULL;
 	dq->tail = NULL;
 	dq->len = 0;
+	dq->finger = NULL;
 }
 
 /**
@@ -50,6 +255,9 @@ void dq_clear(deque *const restrict dq, free_func *free_data)
 void *dq_del(deque *const restrict dq, free_func *free_data)
 {
 	dq_clear(dq, free_data);
+	if (dq)
+		dq_pool_release(dq);
+
 	free(dq);
 	return (NULL);
 }
@@ -68,7 +276,7 @@ dq_push_head(deque *const restrict dq, void *const data, dup_func *copy_data)
 	if (!dq)
 		return (NULL);
 
-	list_node *const restrict nw = lstnode_new(data, copy_data);
+	list_node *const restrict nw = dq_node_new(dq, data, copy_data);
 
 	if (!nw)
 		return (NULL);
@@ -78,6 +286,7 @@ dq_push_head(deque *const restrict dq, void *const data, dup_func *copy_data)
 		dq->tail = nw;
 
 	++(dq->len);
+	++(dq->finger_i);
 	return (nw);
 }
 
@@ -97,7 +306,7 @@ list_node *dq_push_tail(
 	if (!dq)
 		return (NULL);
 
-	list_node *const restrict nw = lstnode_new(data, copy_data);
+	list_node *const restrict nw = dq_node_new(dq, data, copy_data);
 	if (!nw)
 		return (NULL);
 
@@ -123,8 +332,12 @@ void *dq_pop_head(deque *const restrict dq)
 	list_node *const node = dq->head;
 
 	dq->head = lstnode_get_next(node);
-	void *const d = lstnode_del(node);
+	void *const d = dq_node_del(dq, node);
+
+	if (dq->finger == node)
+		dq->finger = NULL;
 
+	--(dq->finger_i);
 	if (!dq->head)
 		dq->tail = NULL;
 
@@ -148,7 +361,10 @@ void *dq_pop_tail(deque *const restrict dq)
 	list_node *node = dq->tail;
 
 	dq->tail = lstnode_get_prev(node);
-	void *const d = lstnode_del(node);
+	void *const d = dq_node_del(dq, node);
+
+	if (dq->finger == node)
+		dq->finger = NULL;
 
 	if (!dq->tail)
 		dq->head = NULL;
@@ -159,6 +375,592 @@ void *dq_pop_tail(deque *const restrict dq)
 	return (d);
 }
 
+/**
+ * dq_node_at - find the node at an index of a `deque`.
+ * @dq: the `deque`.
+ * @i: the index, negative indices count from the tail.
+ *
+ * The walk starts from the closest of the head, the tail and the node last
+ * reached by index, which is remembered for the next call. Accesses near the
+ * previous one, like a sliding window, cost O(1).
+ *
+ * Return: pointer to the node, NULL if `i` is out of range.
+ */
+static list_node *dq_node_at(deque *const restrict dq, intmax_t i)
+{
+	if (i < 0)
+		i += dq->len;
+
+	if (i < 0 || i >= dq->len)
+		return (NULL);
+
+	list_node *node = dq->head;
+	intmax_t at = 0;
+
+	if (dq->len - 1 - i < i)
+	{
+		node = dq->tail;
+		at = dq->len - 1;
+	}
+
+	if (dq->finger && imaxabs(dq->finger_i - i) < imaxabs(at - i))
+	{
+		node = dq->finger;
+		at = dq->finger_i;
+	}
+
+	for (; at < i; ++at)
+		node = node->next;
+
+	for (; at > i; --at)
+		node = node->prev;
+
+	dq->finger = node;
+	dq->finger_i = i;
+	return (node);
+}
+
+/**
+ * dq_get - get the data at an index of a `deque`.
+ * @dq: the `deque`.
+ * @i: the index, negative indices count from the tail.
+ *
+ * Return: pointer to the data, NULL if `i` is out of range.
+ */
+void *dq_get(deque *const restrict dq, const intmax_t i)
+{
+	if (!dq)
+		return (NULL);
+
+	list_node *const node = dq_node_at(dq, i);
+
+	return (node ? node->data : NULL);
+}
+
+/**
+ * dq_insert_at - insert a new node at an index of a `deque`.
+ * @dq: the `deque` to operate on.
+ * @i: index the new node will have, from 0 to `dq->len`, negative indices
+ * count from past the tail, so -1 appends.
+ * @data: data that the new node will hold.
+ * @copy_data: function that will be called to duplicate `data`.
+ *
+ * Return: pointer to the new node, NULL on failure or if `i` is out of range.
+ */
+list_node *dq_insert_at(
+	deque *const restrict dq, intmax_t i, void *const data,
+	dup_func *copy_data
+)
+{
+	if (!dq)
+		return (NULL);
+
+	if (i < 0)
+		i += dq->len + 1;
+
+	if (i == 0)
+		return (dq_push_head(dq, data, copy_data));
+
+	if (i == dq->len)
+		return (dq_push_tail(dq, data, copy_data));
+
+	list_node *const next = dq_node_at(dq, i);
+
+	if (!next)
+		return (NULL);
+
+	list_node *const nw = dq_node_new(dq, data, copy_data);
+
+	if (!nw)
+		return (NULL);
+
+	lstnode_insert_before(next, nw);
+	++(dq->len);
+	dq->finger = nw;
+	return (nw);
+}
+
+/**
+ * dq_remove_at - remove the node at an index of a `deque`.
+ * @dq: the `deque` to operate on.
+ * @i: the index, negative indices count from the tail.
+ *
+ * Return: pointer to the data that was in the node, NULL if `i` is out of
+ * range.
+ */
+void *dq_remove_at(deque *const restrict dq, intmax_t i)
+{
+	if (!dq)
+		return (NULL);
+
+	list_node *const node = dq_node_at(dq, i);
+
+	if (!node)
+		return (NULL);
+
+	if (node == dq->head)
+		return (dq_pop_head(dq));
+
+	if (node == dq->tail)
+		return (dq_pop_tail(dq));
+
+	dq->finger = node->next;
+	--(dq->len);
+	return (dq_node_del(dq, node));
+}
+
+/**
+ * dq_foreach - call a function on the data of every node of a `deque`, from
+ * head to tail.
+ * @dq: the `deque`.
+ * @action: the function, it must not add or remove nodes.
+ * @arg: argument passed to every call of `action`.
+ *
+ * The walk prefetches nodes ahead, see `linked_list_foreach`.
+ */
+void dq_foreach(
+	deque const *const restrict dq, data_action *action, void *const arg
+)
+{
+	if (dq)
+		linked_list_foreach(dq->head, action, arg);
+}
+
+/**
+ * dq_map - replace the data of every node of a `deque` by a function of it.
+ * @dq: the `deque`.
+ * @map: the function, the data it is given is left to it.
+ * @arg: argument passed to every call of `map`.
+ */
+void dq_map(deque *const restrict dq, data_map *map, void *const arg)
+{
+	if (!dq || !map)
+		return;
+
+	for (list_node *node = dq->head; node; node = node->next)
+		node->data = map(node->data, arg);
+}
+
+/**
+ * dq_filter - remove the nodes of a `deque` whose data fails a test.
+ * @dq: the `deque`.
+ * @keep: the test, nodes for which it returns 0 are removed.
+ * @arg: argument passed to every call of `keep`.
+ * @free_data: function that will be called on the data of removed nodes.
+ *
+ * Return: number of nodes removed.
+ */
+size_t dq_filter(
+	deque *const restrict dq, data_pred *keep, void *const arg,
+	free_func *free_data
+)
+{
+	if (!dq || !keep)
+		return (0);
+
+	size_t removed = 0;
+
+	for (list_node *node = dq->head, *next = NULL; node; node = next)
+	{
+		next = node->next;
+		if (keep(node->data, arg))
+			continue;
+
+		if (node == dq->head)
+			dq->head = next;
+
+		if (node == dq->tail)
+			dq->tail = node->prev;
+
+		void *const data = dq_node_del(dq, node);
+
+		if (free_data)
+			free_data(data);
+
+		++removed;
+	}
+
+	if (removed > 0)
+	{
+		dq->len -= (intmax_t)removed;
+		dq->finger = NULL;
+	}
+
+	return (removed);
+}
+
+/**
+ * struct dq_fold_arg - arguments of `dq_fold_data`.
+ * @fold: the function folding data.
+ * @acc: the accumulator.
+ * @arg: argument passed to every call of `fold`.
+ */
+struct dq_fold_arg
+{
+	data_fold *fold;
+	void *acc;
+	void *arg;
+};
+
+/**
+ * dq_fold_data - `data_action` adapter calling a `data_fold`.
+ * @data: the data to fold.
+ * @fold_arg: pointer to a `struct dq_fold_arg`.
+ */
+static void dq_fold_data(void *const data, void *const fold_arg)
+{
+	struct dq_fold_arg const *const f = fold_arg;
+
+	f->fold(f->acc, data, f->arg);
+}
+
+/**
+ * dq_reduce - fold the data of every node of a `deque`, from head to tail,
+ * into an accumulator.
+ * @dq: the `deque`.
+ * @acc: the accumulator, holding the initial value.
+ * @fold: function folding data into `acc`.
+ * @arg: argument passed to every call of `fold`.
+ */
+void dq_reduce(
+	deque const *const restrict dq, void *const acc, data_fold *fold,
+	void *const arg
+)
+{
+	if (!dq || !acc || !fold)
+		return;
+
+	struct dq_fold_arg f = {fold, acc, arg};
+
+	linked_list_foreach(dq->head, dq_fold_data, &f);
+}
+
+/**
+ * dq_sort - sort a `deque` in place.
+ * @dq: the `deque` to sort.
+ * @cmp: function comparing the data of two nodes.
+ *
+ * The sort is a stable bottom-up merge sort that relinks the nodes, so
+ * pointers to nodes stay valid and nothing is allocated.
+ */
+void dq_sort(deque *const restrict dq, data_cmp *cmp)
+{
+	if (!dq || !cmp || dq->len < 2)
+		return;
+
+	dq->head = linked_list_sort(dq->head, cmp, &dq->tail);
+	dq->finger = NULL;
+}
+
+/**
+ * dq_splice - move all the nodes of a `deque` into another.
+ * @dst: the `deque` receiving the nodes.
+ * @pos: a node of `dst` after which the nodes go, NULL for the head.
+ * @src: the `deque` giving its nodes, left empty.
+ *
+ * When both deques take their nodes from the same place, malloc or the same
+ * `node_pool`, the nodes are relinked in O(1) and a pool owned by `src` is
+ * handed over to `dst`. Otherwise nodes must go back where they came from,
+ * so the data is moved into new nodes of `dst` one by one.
+ *
+ * Return: 1 on success, 0 if an argument is NULL or on allocation failure,
+ * in which case both deques are left unchanged.
+ */
+int dq_splice(
+	deque *const restrict dst, list_node *const pos, deque *const restrict src
+)
+{
+	if (!dst || !src)
+		return (0);
+
+	if (!src->head)
+		return (1);
+
+	list_node *first = src->head, *last = src->tail;
+
+	if (dst->pool != src->pool)
+	{
+		first = dq_chain_copy(dst, src->head, (size_t)src->len, &last);
+		if (!first)
+			return (0);
+
+		dq_chain_del(src, src->head, src->tail, (size_t)src->len, NULL);
+	}
+	else if (src->owns_pool)
+	{
+		if (dst->owns_pool)
+			dq_pool_release(src);
+		else
+		{
+			dst->owns_pool = 1;
+			src->owns_pool = 0;
+		}
+
+		src->pool = NULL;
+	}
+
+	list_node *const next = pos ? pos->next : dst->head;
+
+	first->prev = pos;
+	last->next = next;
+	if (pos)
+		pos->next = first;
+	else
+		dst->head = first;
+
+	if (next)
+	{
+		next->prev = last;
+		dst->finger = NULL;
+	}
+	else
+		dst->tail = last;
+
+	dst->len += src->len;
+	src->head = NULL;
+	src->tail = NULL;
+	src->len = 0;
+	src->finger = NULL;
+	return (1);
+}
+
+/**
+ * dq_concat - move all the nodes of a `deque` to the tail of another.
+ * @dst: the `deque` receiving the nodes.
+ * @src: the `deque` giving its nodes, left empty.
+ *
+ * Return: 1 on success, 0 if an argument is NULL or on allocation failure,
+ * see `dq_splice`.
+ */
+int dq_concat(deque *const restrict dst, deque *const restrict src)
+{
+	return (dq_splice(dst, dst ? dst->tail : NULL, src));
+}
+
+/**
+ * dq_split_at - move the nodes from a node to the tail into a new `deque`.
+ * @dq: the `deque` to split.
+ * @node: a node of `dq`, it becomes the head of the new deque.
+ *
+ * The nodes are relinked, not copied. The new deque takes its nodes from the
+ * same pool as `dq`, and shares its ownership if `dq` owns it.
+ * The moved nodes are counted walking from `node` towards both ends at once,
+ * which costs the length of the shorter part.
+ *
+ * Return: pointer to the new deque, NULL on failure.
+ */
+deque *dq_split_at(deque *const restrict dq, list_node *const node)
+{
+	if (!dq || !node || !dq->head)
+		return (NULL);
+
+	deque *const split = dq_new();
+
+	if (!split)
+		return (NULL);
+
+	list_node const *fwd = node, *back = node->prev;
+	intmax_t steps = 0;
+
+	while (fwd && back)
+	{
+		fwd = fwd->next;
+		back = back->prev;
+		++steps;
+	}
+
+	split->len = fwd ? dq->len - steps : steps;
+	split->head = node;
+	split->tail = dq->tail;
+	split->pool = dq->pool;
+	if (dq->owns_pool)
+	{
+		split->owns_pool = 1;
+		++(dq->pool->n_owners);
+	}
+
+	dq->len -= split->len;
+	dq->tail = node->prev;
+	if (dq->tail)
+		dq->tail->next = NULL;
+	else
+		dq->head = NULL;
+
+	node->prev = NULL;
+	if (dq->finger_i >= dq->len)
+		dq->finger = NULL;
+
+	return (split);
+}
+
+/**
+ * dq_push_head_n - add an array of data to the head of a `deque`.
+ * @dq: the `deque` to operate on.
+ * @data: the array of data.
+ * @n: number of items in `data`.
+ * @copy_data: function that will be called to duplicate the data.
+ * @free_data: function that will be called to free copies on failure, must
+ * be provided if `copy_data` is.
+ *
+ * Same as calling `dq_push_head` on each item in order, so the last item
+ * ends up at the head, but the nodes are allocated in one batch and linked
+ * in one pass.
+ *
+ * Return: 1 on success, 0 on failure, in which case the `deque` is unchanged.
+ */
+int dq_push_head_n(
+	deque *const restrict dq, void *const *const restrict data,
+	const size_t n, dup_func *copy_data, free_func *free_data
+)
+{
+	if (!dq || (!data && n) || (copy_data && !free_data))
+		return (0);
+
+	if (!n)
+		return (1);
+
+	list_node *tail = NULL;
+	list_node *const head =
+		dq_chain_new(dq, data, n, 1, copy_data, free_data, &tail);
+
+	if (!head)
+		return (0);
+
+	tail->next = dq->head;
+	if (dq->head)
+		dq->head->prev = tail;
+	else
+		dq->tail = tail;
+
+	dq->head = head;
+	dq->len += (intmax_t)n;
+	dq->finger_i += (intmax_t)n;
+	return (1);
+}
+
+/**
+ * dq_push_tail_n - add an array of data to the tail of a `deque`.
+ * @dq: the `deque` to operate on.
+ * @data: the array of data.
+ * @n: number of items in `data`.
+ * @copy_data: function that will be called to duplicate the data.
+ * @free_data: function that will be called to free copies on failure, must
+ * be provided if `copy_data` is.
+ *
+ * Same as calling `dq_push_tail` on each item in order, but the nodes are
+ * allocated in one batch and linked in one pass.
+ *
+ * Return: 1 on success, 0 on failure, in which case the `deque` is unchanged.
+ */
+int dq_push_tail_n(
+	deque *const restrict dq, void *const *const restrict data,
+	const size_t n, dup_func *copy_data, free_func *free_data
+)
+{
+	if (!dq || (!data && n) || (copy_data && !free_data))
+		return (0);
+
+	if (!n)
+		return (1);
+
+	list_node *tail = NULL;
+	list_node *const head =
+		dq_chain_new(dq, data, n, 0, copy_data, free_data, &tail);
+
+	if (!head)
+		return (0);
+
+	head->prev = dq->tail;
+	if (dq->tail)
+		dq->tail->next = head;
+	else
+		dq->head = head;
+
+	dq->tail = tail;
+	dq->len += (intmax_t)n;
+	return (1);
+}
+
+/**
+ * dq_pop_head_n - pop several nodes from the head of a `deque`.
+ * @dq: the `deque` to operate on.
+ * @data: array receiving the data of the popped nodes, head first.
+ * @n: size of `data`.
+ *
+ * The popped nodes are unlinked together and freed in one batch.
+ *
+ * Return: number of nodes popped.
+ */
+size_t dq_pop_head_n(
+	deque *const restrict dq, void **const restrict data, const size_t n
+)
+{
+	if (!dq || !data || !dq->head || !n)
+		return (0);
+
+	list_node *const head = dq->head, *tail = head;
+	size_t count = 1;
+
+	data[0] = head->data;
+	for (; count < n && tail->next; ++count)
+	{
+		tail = tail->next;
+		data[count] = tail->data;
+	}
+
+	dq->head = tail->next;
+	if (dq->head)
+		dq->head->prev = NULL;
+	else
+		dq->tail = NULL;
+
+	tail->next = NULL;
+	dq->len -= (intmax_t)count;
+	dq->finger = NULL;
+	dq_chain_del(dq, head, tail, count, NULL);
+	return (count);
+}
+
+/**
+ * dq_pop_tail_n - pop several nodes from the tail of a `deque`.
+ * @dq: the `deque` to operate on.
+ * @data: array receiving the data of the popped nodes, tail first.
+ * @n: size of `data`.
+ *
+ * The popped nodes are unlinked together and freed in one batch.
+ *
+ * Return: number of nodes popped.
+ */
+size_t dq_pop_tail_n(
+	deque *const restrict dq, void **const restrict data, const size_t n
+)
+{
+	if (!dq || !data || !dq->tail || !n)
+		return (0);
+
+	list_node *const tail = dq->tail, *head = tail;
+	size_t count = 1;
+
+	data[0] = tail->data;
+	for (; count < n && head->prev; ++count)
+	{
+		head = head->prev;
+		data[count] = head->data;
+	}
+
+	dq->tail = head->prev;
+	if (dq->tail)
+		dq->tail->next = NULL;
+	else
+		dq->head = NULL;
+
+	head->prev = NULL;
+	dq->len -= (intmax_t)count;
+	dq->finger = NULL;
+	dq_chain_del(dq, head, tail, count, NULL);
+	return (count);
+}
+
 /**
  * dq_from_array - create a new `deque` from an array of objects.
  * @data_array: the array of objects.
@@ -167,6 +969,10 @@ void *dq_pop_tail(deque *const restrict dq)
  * @copy_data: function that will be used to copy the objects.
  * @delete_data: function that will be used to delete objects.
  *
+ * All the nodes are carved from one block, in list order, by a `node_pool`
+ * that belongs to the new `deque`. Deques split from it share the pool, which
+ * is freed with the last of them.
+ *
  * Return: pointer to the new `deque`, NULL on failure.
  */
 deque *dq_from_array(
@@ -186,6 +992,18 @@ deque *dq_from_array(
 	if (!new_q)
 		return (NULL);
 
+	node_pool *const pool = ndpool_new(0);
+
+	if (!pool || !ndpool_reserve(pool, (size_t)len))
+	{
+		ndpool_del(pool);
+		return (dq_del(new_q, NULL));
+	}
+
+	pool->n_owners = 1;
+	new_q->pool = pool;
+	new_q->owns_pool = 1;
+
 	for (intmax_t i = 0; i < len; ++i)
 	{
 		void *data = (char *)data_array + (type_size * i);
@@ -243,6 +1061,64 @@ void **dq_to_array(
 	return (data_array);
 }
 
+/**
+ * dq_to_array_into - copy the data pointers of a `deque` into a buffer.
+ * @dq: the `deque`.
+ * @buf: the buffer, the pointers are written head first.
+ * @len: number of pointers `buf` can hold.
+ *
+ * Return: number of pointers written, at most `len`.
+ */
+size_t dq_to_array_into(
+	const deque *const restrict dq, void **const restrict buf, const size_t len
+)
+{
+	if (!dq || !buf)
+		return (0);
+
+	size_t d_i = 0;
+
+	for (list_node *node = dq->head; node && d_i < len; node = node->next)
+		buf[d_i++] = node->data;
+
+	return (d_i);
+}
+
+/**
+ * dq_to_flat_array - copy the data of a `deque` into one packed array.
+ * @dq: the `deque`, every node must point to an object of `elem_size` bytes.
+ * @elem_size: size of the objects.
+ *
+ * Nodes holding NULL are written as zero bytes.
+ *
+ * Return: pointer to the array of `dq->len` objects, NULL on failure or if
+ * the `deque` is empty.
+ */
+void *
+dq_to_flat_array(const deque *const restrict dq, const size_t elem_size)
+{
+	if (!dq || !dq->head || dq->len < 1 || elem_size == 0 ||
+		(size_t)dq->len > SIZE_MAX / elem_size)
+		return (NULL);
+
+	char *const restrict flat = malloc(elem_size * (size_t)dq->len);
+
+	if (!flat)
+		return (NULL);
+
+	char *restrict dst = flat;
+
+	for (list_node *node = dq->head; node; node = node->next, dst += elem_size)
+	{
+		if (node->data)
+			memcpy(dst, node->data, elem_size);
+		else
+			memset(dst, 0, elem_size);
+	}
+
+	return (flat);
+}
+
 /**
  * dq_tostr - stringify a `deque`.
  * @dq: the `deque` to print.
@@ -292,3 +1168,49 @@ char *dq_tostr_reversed(deque const *const restrict dq, data_tostr *print_data)
 
 	return (linked_list_tostr_reversed(dq->tail, print_data));
 }
+
+/**
+ * dq_write - write a `deque` to a `str_buf`.
+ * @dq: the `deque` to write.
+ * @sb: the buffer, in memory or writing to a stream.
+ * @write_data: function that will be called to write data in nodes, if NULL
+ * the address of the data is written.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int dq_write(
+	deque const *const restrict dq, str_buf *const restrict sb,
+	data_write *write_data
+)
+{
+	if (!dq || !sb)
+		return (0);
+
+	if (!dq->head)
+		return (strbuf_puts(sb, "(NULL)"));
+
+	return (linked_list_write(dq->head, sb, write_data));
+}
+
+/**
+ * dq_write_reversed - write a `deque` to a `str_buf` from tail to head.
+ * @dq: the `deque` to write.
+ * @sb: the buffer, in memory or writing to a stream.
+ * @write_data: function that will be called to write data in nodes, if NULL
+ * the address of the data is written.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int dq_write_reversed(
+	deque const *const restrict dq, str_buf *const restrict sb,
+	data_write *write_data
+)
+{
+	if (!dq || !sb)
+		return (0);
+
+	if (!dq->tail)
+		return (strbuf_puts(sb, "(NULL)"));
+
+	return (linked_list_write_reversed(dq->tail, sb, write_data));
+}
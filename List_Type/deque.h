@@ -1,6 +1,7 @@
 #ifndef DS_DEQUE_TYPE_H
 #define DS_DEQUE_TYPE_H
 
+#include <stddef.h> /* size_t */
 #include <stdint.h> /* intmax_t */
 
 #include "attribute_macros.h"
@@ -10,6 +11,7 @@
 
 void *dq_del(deque *const restrict dq, free_func *free_data);
 deque *dq_new(void) ATTR_MALLOC ATTR_MALLOC_FREE(dq_del);
+int dq_set_pool(deque *const restrict dq, node_pool *const pool);
 
 /* manipulate */
 
@@ -20,8 +22,58 @@ list_node *dq_push_tail(
 );
 void *dq_pop_head(deque *const restrict dq);
 void *dq_pop_tail(deque *const restrict dq);
+int dq_push_head_n(
+	deque *const restrict dq, void *const *const restrict data,
+	const size_t n, dup_func *copy_data, free_func *free_data
+);
+int dq_push_tail_n(
+	deque *const restrict dq, void *const *const restrict data,
+	const size_t n, dup_func *copy_data, free_func *free_data
+);
+size_t dq_pop_head_n(
+	deque *const restrict dq, void **const restrict data, const size_t n
+);
+size_t dq_pop_tail_n(
+	deque *const restrict dq, void **const restrict data, const size_t n
+);
 void dq_clear(deque *const restrict dq, free_func *free_data);
 
+/* indexed access */
+
+void *dq_get(deque *const restrict dq, const intmax_t i);
+list_node *dq_insert_at(
+	deque *const restrict dq, intmax_t i, void *const data,
+	dup_func *copy_data
+);
+void *dq_remove_at(deque *const restrict dq, intmax_t i);
+
+/* iterate */
+
+void dq_foreach(
+	deque const *const restrict dq, data_action *action, void *const arg
+);
+void dq_map(deque *const restrict dq, data_map *map, void *const arg);
+size_t dq_filter(
+	deque *const restrict dq, data_pred *keep, void *const arg,
+	free_func *free_data
+);
+void dq_reduce(
+	deque const *const restrict dq, void *const acc, data_fold *fold,
+	void *const arg
+);
+
+/* sort */
+
+void dq_sort(deque *const restrict dq, data_cmp *cmp);
+
+/* splice and split */
+
+int dq_splice(
+	deque *const restrict dst, list_node *const pos, deque *const restrict src
+);
+int dq_concat(deque *const restrict dst, deque *const restrict src);
+deque *dq_split_at(deque *const restrict dq, list_node *const node);
+
 /* array conversion */
 
 deque *dq_from_array(
@@ -31,11 +83,24 @@ deque *dq_from_array(
 void **dq_to_array(
 	const deque *const restrict dq, dup_func *copy_data, free_func *free_data
 );
+size_t dq_to_array_into(
+	const deque *const restrict dq, void **const restrict buf, const size_t len
+);
+void *dq_to_flat_array(const deque *const restrict dq, const size_t elem_size)
+	ATTR_MALLOC;
 
 /* print */
 
 char *dq_tostr(deque const *const restrict dq, data_tostr *print_data);
 char *
 dq_tostr_reversed(deque const *const restrict dq, data_tostr *print_data);
+int dq_write(
+	deque const *const restrict dq, str_buf *const restrict sb,
+	data_write *write_data
+);
+int dq_write_reversed(
+	deque const *const restrict dq, str_buf *const restrict sb,
+	data_write *write_data
+);
 
 #endif /* DS_DEQUE_TYPE_H */
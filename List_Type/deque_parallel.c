@@ -0,0 +1,469 @@
+#include <stdlib.h> /* *alloc */
+#include <string.h> /* memcpy */
+
+#include "deque.h"
+#include "deque_parallel.h"
+#include "list_node.h"
+#include "list_type_structs.h"
+#include "node_pool.h"
+
+/**
+ * struct dq_sort_task - a chain of nodes to be sorted by the pool.
+ * @pool: the pool running the sort.
+ * @cmp: function comparing the data of two nodes.
+ * @head: the first node of the chain, then of the sorted chain.
+ * @tail: the last node of the sorted chain.
+ * @len: number of nodes in the chain.
+ */
+struct dq_sort_task
+{
+	thread_pool *pool;
+	data_cmp *cmp;
+	list_node *head;
+	list_node *tail;
+	size_t len;
+};
+
+/**
+ * dq_sort_run - sort a chain, splitting it between tasks while it is long.
+ * @arg: pointer to a `struct dq_sort_task`.
+ *
+ * The first half is spawned and the second half is sorted by the calling
+ * thread, the sorted halves are then merged with the first one winning
+ * ties, which keeps the sort stable. The merged chain ends with whichever
+ * tail sorts last.
+ */
+static void dq_sort_run(void *arg)
+{
+	struct dq_sort_task *const task = arg;
+
+	if (task->len <= DQ_PAR_SORT_GRAIN)
+	{
+		task->head = linked_list_sort(task->head, task->cmp, &task->tail);
+		return;
+	}
+
+	const size_t half = task->len / 2;
+	list_node *mid = task->head;
+
+	for (size_t i = 1; i < half; ++i)
+		mid = mid->next;
+
+	struct dq_sort_task first = {
+		task->pool, task->cmp, task->head, NULL, half
+	};
+	struct dq_sort_task second = {
+		task->pool, task->cmp, mid->next, NULL, task->len - half
+	};
+	tp_group group;
+
+	mid->next = NULL;
+	second.head->prev = NULL;
+	tpool_group_init(&group);
+	tpool_spawn(task->pool, &group, dq_sort_run, &first);
+	dq_sort_run(&second);
+	tpool_sync(task->pool, &group);
+	task->head = linked_list_merge(first.head, second.head, task->cmp);
+	task->tail = task->cmp(second.tail->data, first.tail->data) < 0
+					 ? first.tail
+					 : second.tail;
+}
+
+/**
+ * dq_sort_parallel - sort a `deque` in place using a thread pool.
+ * @dq: the `deque` to sort.
+ * @cmp: function comparing the data of two nodes, must be thread safe.
+ * @pool: the pool, if NULL the sort runs on the calling thread.
+ *
+ * Runs of at most `DQ_PAR_SORT_GRAIN` nodes are sorted concurrently with the
+ * same merge sort as `dq_sort`, then merged pairwise, so the result is the
+ * same stable order and the nodes are only relinked.
+ */
+void dq_sort_parallel(
+	deque *const restrict dq, data_cmp *cmp, thread_pool *const restrict pool
+)
+{
+	if (!pool || !dq || (size_t)dq->len <= DQ_PAR_SORT_GRAIN)
+	{
+		dq_sort(dq, cmp);
+		return;
+	}
+
+	if (!cmp)
+		return;
+
+	struct dq_sort_task task = {pool, cmp, dq->head, NULL, (size_t)dq->len};
+
+	dq_sort_run(&task);
+	dq->head = task.head;
+	dq->tail = task.tail;
+	dq->finger = NULL;
+}
+
+/**
+ * struct dq_par_job - what the tasks of a map, filter or reduce do.
+ * @map: the function replacing data.
+ * @keep: the test deciding which nodes stay.
+ * @fold: the function folding data into an accumulator.
+ * @free_data: function called on the data of removed nodes.
+ * @arg: argument passed to every call of the above.
+ */
+struct dq_par_job
+{
+	data_map *map;
+	data_pred *keep;
+	data_fold *fold;
+	free_func *free_data;
+	void *arg;
+};
+
+/**
+ * struct dq_chunk - a chain of nodes handled by one task.
+ * @job: what to do with the nodes.
+ * @head: the first node of the chain, nothing links to it.
+ * @tail: the last node of the chain, nothing follows it.
+ * @len: number of nodes in the chain.
+ * @dropped: chain of the nodes a filter removed.
+ * @dropped_tail: the last node of `dropped`.
+ * @n_dropped: number of nodes in `dropped`.
+ * @acc: the accumulator of a reduce.
+ */
+struct dq_chunk
+{
+	struct dq_par_job const *job;
+	list_node *head;
+	list_node *tail;
+	size_t len;
+	list_node *dropped;
+	list_node *dropped_tail;
+	size_t n_dropped;
+	void *acc;
+};
+
+/**
+ * dq_chunks_new - cut a `deque` into detached chains of nearly equal length.
+ * @dq: the `deque`, left pointing at the first chain only until
+ * `dq_chunks_join` is called.
+ * @pool: the pool that will process the chains.
+ * @job: what to do with the nodes.
+ * @n_chunks: out parameter for the number of chains.
+ *
+ * Cutting needs one walk over the list, done by the caller, which is cheap
+ * next to the work the chains are cut for.
+ *
+ * Return: the chains, NULL if there would be fewer than 2 or on allocation
+ * failure, in which case the deque is left untouched.
+ */
+static struct dq_chunk *dq_chunks_new(
+	deque *const restrict dq, thread_pool *const restrict pool,
+	struct dq_par_job const *const job, size_t *const restrict n_chunks
+)
+{
+	const size_t len = (size_t)dq->len;
+	const size_t max = tpool_size(pool) * DQ_PAR_CHUNKS_PER_WORKER;
+	size_t n = (len + DQ_PAR_GRAIN - 1) / DQ_PAR_GRAIN;
+
+	if (n > max)
+		n = max;
+
+	if (n < 2)
+		return (NULL);
+
+	struct dq_chunk *const chunks = calloc(n, sizeof(*chunks));
+
+	if (!chunks)
+		return (NULL);
+
+	list_node *node = dq->head;
+
+	for (size_t c = 0; c < n; ++c)
+	{
+		chunks[c].job = job;
+		chunks[c].len = len / n + (c < len % n);
+		chunks[c].head = node;
+		node->prev = NULL;
+		for (size_t i = 1; i < chunks[c].len; ++i)
+			node = node->next;
+
+		chunks[c].tail = node;
+		node = node->next;
+		chunks[c].tail->next = NULL;
+	}
+
+	*n_chunks = n;
+	return (chunks);
+}
+
+/**
+ * dq_chunks_run - run a task on every chain and wait for all of them.
+ * @pool: the pool.
+ * @chunks: the chains.
+ * @n_chunks: number of chains.
+ * @task: the task, given a pointer to its `struct dq_chunk`.
+ */
+static void dq_chunks_run(
+	thread_pool *const restrict pool, struct dq_chunk *const chunks,
+	const size_t n_chunks, tp_task_func *task
+)
+{
+	tp_group group;
+
+	tpool_group_init(&group);
+	for (size_t c = 1; c < n_chunks; ++c)
+		tpool_spawn(pool, &group, task, &chunks[c]);
+
+	task(&chunks[0]);
+	tpool_sync(pool, &group);
+}
+
+/**
+ * dq_chunks_join - link the chains back into a `deque` and free them.
+ * @dq: the `deque`.
+ * @chunks: the chains, empty ones are skipped.
+ * @n_chunks: number of chains.
+ */
+static void dq_chunks_join(
+	deque *const restrict dq, struct dq_chunk *const chunks,
+	const size_t n_chunks
+)
+{
+	dq->head = NULL;
+	dq->tail = NULL;
+	dq->len = 0;
+	for (size_t c = 0; c < n_chunks; ++c)
+	{
+		if (!chunks[c].head)
+			continue;
+
+		if (dq->tail)
+		{
+			dq->tail->next = chunks[c].head;
+			chunks[c].head->prev = dq->tail;
+		}
+		else
+			dq->head = chunks[c].head;
+
+		dq->tail = chunks[c].tail;
+		dq->len += (intmax_t)chunks[c].len;
+	}
+
+	free(chunks);
+}
+
+/**
+ * dq_map_chunk - replace the data of every node of a chain.
+ * @arg: pointer to a `struct dq_chunk`.
+ */
+static void dq_map_chunk(void *arg)
+{
+	struct dq_chunk *const chunk = arg;
+
+	for (list_node *node = chunk->head; node; node = node->next)
+		node->data = chunk->job->map(node->data, chunk->job->arg);
+}
+
+/**
+ * dq_map_parallel - replace the data of every node of a `deque` by a function
+ * of it, using a thread pool.
+ * @dq: the `deque`.
+ * @map: the function, must be thread safe.
+ * @arg: argument passed to every call of `map`.
+ * @pool: the pool, if NULL or if the deque is short `dq_map` is used.
+ *
+ * The deque is cut into chains that the workers map concurrently, then
+ * linked back in the same order.
+ */
+void dq_map_parallel(
+	deque *const restrict dq, data_map *map, void *const arg,
+	thread_pool *const restrict pool
+)
+{
+	struct dq_par_job const job = {.map = map, .arg = arg};
+	size_t n_chunks = 0;
+	struct dq_chunk *const chunks =
+		dq && map && pool ? dq_chunks_new(dq, pool, &job, &n_chunks) : NULL;
+
+	if (!chunks)
+	{
+		dq_map(dq, map, arg);
+		return;
+	}
+
+	dq_chunks_run(pool, chunks, n_chunks, dq_map_chunk);
+	dq_chunks_join(dq, chunks, n_chunks);
+}
+
+/**
+ * dq_filter_chunk - unlink the nodes of a chain whose data fails a test.
+ * @arg: pointer to a `struct dq_chunk`.
+ *
+ * The data of the removed nodes is freed here, the nodes themselves are
+ * kept in `dropped` for the caller, who may have to return them to a pool.
+ */
+static void dq_filter_chunk(void *arg)
+{
+	struct dq_chunk *const chunk = arg;
+	struct dq_par_job const *const job = chunk->job;
+	list_node *node = chunk->head, *next = NULL;
+
+	chunk->head = NULL;
+	chunk->tail = NULL;
+	for (; node; node = next)
+	{
+		next = node->next;
+		node->next = NULL;
+		if (job->keep(node->data, job->arg))
+		{
+			node->prev = chunk->tail;
+			if (chunk->tail)
+				chunk->tail->next = node;
+			else
+				chunk->head = node;
+
+			chunk->tail = node;
+			continue;
+		}
+
+		if (job->free_data)
+			job->free_data(node->data);
+
+		node->prev = chunk->dropped_tail;
+		if (chunk->dropped_tail)
+			chunk->dropped_tail->next = node;
+		else
+			chunk->dropped = node;
+
+		chunk->dropped_tail = node;
+		++(chunk->n_dropped);
+		--(chunk->len);
+	}
+}
+
+/**
+ * dq_filter_parallel - remove the nodes of a `deque` whose data fails a test,
+ * using a thread pool.
+ * @dq: the `deque`.
+ * @keep: the test, must be thread safe. Nodes for which it returns 0 are
+ * removed.
+ * @arg: argument passed to every call of `keep`.
+ * @free_data: function that will be called on the data of removed nodes, it
+ * must be thread safe.
+ * @pool: the pool, if NULL or if the deque is short `dq_filter` is used.
+ *
+ * The workers test and unlink the nodes of separate chains, the removed
+ * nodes are then freed by the calling thread since a `node_pool` is not
+ * thread safe.
+ *
+ * Return: number of nodes removed.
+ */
+size_t dq_filter_parallel(
+	deque *const restrict dq, data_pred *keep, void *const arg,
+	free_func *free_data, thread_pool *const restrict pool
+)
+{
+	struct dq_par_job const job = {
+		.keep = keep, .free_data = free_data, .arg = arg
+	};
+	size_t n_chunks = 0, removed = 0;
+	struct dq_chunk *const chunks =
+		dq && keep && pool ? dq_chunks_new(dq, pool, &job, &n_chunks) : NULL;
+
+	if (!chunks)
+		return (dq_filter(dq, keep, arg, free_data));
+
+	dq_chunks_run(pool, chunks, n_chunks, dq_filter_chunk);
+	for (size_t c = 0; c < n_chunks; ++c)
+	{
+		if (!chunks[c].dropped)
+			continue;
+
+		if (dq->pool)
+			ndpool_free_chain(
+				dq->pool, chunks[c].dropped, chunks[c].dropped_tail,
+				chunks[c].n_dropped
+			);
+		else
+			linked_list_del(chunks[c].dropped, NULL);
+
+		removed += chunks[c].n_dropped;
+	}
+
+	dq_chunks_join(dq, chunks, n_chunks);
+	if (removed > 0)
+		dq->finger = NULL;
+
+	return (removed);
+}
+
+/**
+ * dq_fold_chunk - fold the data of every node of a chain into the chain's
+ * accumulator.
+ * @arg: pointer to a `struct dq_chunk`.
+ */
+static void dq_fold_chunk(void *arg)
+{
+	struct dq_chunk *const chunk = arg;
+
+	for (list_node *node = chunk->head; node; node = node->next)
+		chunk->job->fold(chunk->acc, node->data, chunk->job->arg);
+}
+
+/**
+ * dq_reduce_parallel - fold the data of every node of a `deque` into an
+ * accumulator, using a thread pool.
+ * @dq: the `deque`, its nodes are relinked but keep their order.
+ * @acc: the accumulator, holding the initial value.
+ * @identity: the identity value of `merge`, such as 0 for a sum,
+ * `acc_size` bytes long.
+ * @acc_size: size in bytes of the accumulator.
+ * @fold: function folding data into an accumulator, must be thread safe.
+ * @merge: associative function folding a second accumulator into the first.
+ * @arg: argument passed to every call of `fold` and `merge`.
+ * @pool: the pool, if NULL or if the deque is short `dq_reduce` is used.
+ *
+ * Every chain is folded into its own accumulator starting from `identity`,
+ * these are then merged into `acc` from head to tail, so `merge` need not be
+ * commutative and the result is the one `dq_reduce` gives.
+ */
+void dq_reduce_parallel(
+	deque *const restrict dq, void *const acc, void const *const identity,
+	const size_t acc_size, data_fold *fold, data_fold *merge, void *const arg,
+	thread_pool *const restrict pool
+)
+{
+	if (!dq || !acc || !fold)
+		return;
+
+	struct dq_par_job const job = {.fold = fold, .arg = arg};
+	size_t n_chunks = 0;
+	struct dq_chunk *const chunks =
+		identity && merge && pool && acc_size > 0
+			? dq_chunks_new(dq, pool, &job, &n_chunks)
+			: NULL;
+	unsigned char *const accs =
+		chunks && acc_size <= SIZE_MAX / n_chunks
+			? malloc(acc_size * n_chunks)
+			: NULL;
+
+	if (!accs)
+	{
+		if (chunks)
+			dq_chunks_join(dq, chunks, n_chunks);
+
+		dq_reduce(dq, acc, fold, arg);
+		return;
+	}
+
+	for (size_t c = 0; c < n_chunks; ++c)
+	{
+		chunks[c].acc = accs + acc_size * c;
+		memcpy(chunks[c].acc, identity, acc_size);
+	}
+
+	dq_chunks_run(pool, chunks, n_chunks, dq_fold_chunk);
+	for (size_t c = 0; c < n_chunks; ++c)
+		merge(acc, chunks[c].acc, arg);
+
+	free(accs);
+	dq_chunks_join(dq, chunks, n_chunks);
+}
@@ -0,0 +1,48 @@
+#ifndef DS_DEQUE_PARALLEL_H
+#define DS_DEQUE_PARALLEL_H
+
+#include <stddef.h> /* size_t */
+
+#include "list_type_typedefs.h"
+#include "thread_pool.h"
+
+/**
+ * DQ_PAR_SORT_GRAIN - chains at most this long are sorted by a single task.
+ */
+#define DQ_PAR_SORT_GRAIN ((size_t)4096)
+
+/**
+ * DQ_PAR_GRAIN - map, filter and reduce give at least this many nodes to
+ * each task.
+ */
+#define DQ_PAR_GRAIN ((size_t)256)
+
+/**
+ * DQ_PAR_CHUNKS_PER_WORKER - map, filter and reduce cut a deque into at most
+ * this many chains per worker, so that uneven work still balances.
+ */
+#define DQ_PAR_CHUNKS_PER_WORKER ((size_t)4)
+
+/* sort */
+
+void dq_sort_parallel(
+	deque *const restrict dq, data_cmp *cmp, thread_pool *const restrict pool
+);
+
+/* map, filter and reduce */
+
+void dq_map_parallel(
+	deque *const restrict dq, data_map *map, void *const arg,
+	thread_pool *const restrict pool
+);
+size_t dq_filter_parallel(
+	deque *const restrict dq, data_pred *keep, void *const arg,
+	free_func *free_data, thread_pool *const restrict pool
+);
+void dq_reduce_parallel(
+	deque *const restrict dq, void *const acc, void const *const identity,
+	const size_t acc_size, data_fold *fold, data_fold *merge, void *const arg,
+	thread_pool *const restrict pool
+);
+
+#endif /* DS_DEQUE_PARALLEL_H */
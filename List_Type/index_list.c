@@ -0,0 +1,352 @@
+#include <stdlib.h> /* *alloc */
+#include <string.h> /* memcpy, memset */
+
+#include "index_list.h"
+#include "list_type_structs.h"
+
+/* Number of slots allocated by the first insertion. */
+#define IXL_CAP_MIN ((uint32_t)16)
+
+/**
+ * ixl_slot - get the element stored in a slot of an `index_list`.
+ * @ixl: the `index_list`.
+ * @i: index of the slot.
+ *
+ * Return: pointer to the first byte of the element.
+ */
+static unsigned char *
+ixl_slot(const index_list *const restrict ixl, const uint32_t i)
+{
+	return (ixl->data + ixl->elem_size * i);
+}
+
+/**
+ * ixl_is_live - check that an index is that of an element of an
+ * `index_list`.
+ * @ixl: the `index_list`.
+ * @i: the index.
+ *
+ * Return: 1 if slot `i` holds an element, 0 if it is free or out of range.
+ */
+static int ixl_is_live(const index_list *const restrict ixl, const uint32_t i)
+{
+	return (i < ixl->n_used && ixl->links[i].prev != IXL_FREE);
+}
+
+/**
+ * ixl_new - allocate an empty `index_list`.
+ * @elem_size: size in bytes of the elements, they are copied into the list.
+ * Use `sizeof(void *)` to store pointers.
+ *
+ * Return: pointer to the new list, NULL on failure or if `elem_size` is 0.
+ */
+index_list *ixl_new(const size_t elem_size)
+{
+	if (elem_size == 0)
+		return (NULL);
+
+	index_list *const ixl = calloc(1, sizeof(*ixl));
+
+	if (!ixl)
+		return (NULL);
+
+	ixl->head = IXL_NIL;
+	ixl->tail = IXL_NIL;
+	ixl->free_head = IXL_NIL;
+	ixl->elem_size = elem_size;
+	return (ixl);
+}
+
+/**
+ * ixl_del - free an `index_list` and all its elements.
+ * @ixl: the `index_list`.
+ *
+ * Return: NULL always.
+ */
+void *ixl_del(index_list *const restrict ixl)
+{
+	if (ixl)
+	{
+		free(ixl->links);
+		free(ixl->data);
+	}
+
+	free(ixl);
+	return (NULL);
+}
+
+/**
+ * ixl_reserve - make sure an `index_list` has room for a number of slots.
+ * @ixl: the `index_list`.
+ * @n: number of slots, at most `IXL_FREE`.
+ *
+ * The arrays grow by doubling, pointers returned by `ixl_at` are invalidated
+ * when they move, indices never are.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int ixl_reserve(index_list *const restrict ixl, const uint32_t n)
+{
+	if (!ixl || n > IXL_FREE)
+		return (0);
+
+	if (ixl->cap >= n)
+		return (1);
+
+	uint32_t cap = ixl->cap ? ixl->cap : IXL_CAP_MIN;
+
+	while (cap < n)
+		cap = cap > IXL_FREE / 2 ? IXL_FREE : cap * 2;
+
+	const size_t widest = ixl->elem_size > sizeof(struct ixl_link)
+							  ? ixl->elem_size
+							  : sizeof(struct ixl_link);
+
+	if (cap > SIZE_MAX / widest)
+		return (0);
+
+	struct ixl_link *const links =
+		realloc(ixl->links, sizeof(*links) * cap);
+
+	if (!links)
+		return (0);
+
+	ixl->links = links;
+
+	unsigned char *const data = realloc(ixl->data, ixl->elem_size * cap);
+
+	if (!data)
+		return (0);
+
+	ixl->data = data;
+	ixl->cap = cap;
+	return (1);
+}
+
+/**
+ * ixl_slot_new - take a free slot and copy an element into it.
+ * @ixl: the `index_list`.
+ * @elem: the element, NULL to zero the slot.
+ *
+ * Freed slots are reused first, so the arrays only grow when all the slots
+ * hold elements.
+ *
+ * Return: index of the slot, `IXL_NIL` on failure.
+ */
+static uint32_t ixl_slot_new(
+	index_list *const restrict ixl, void const *const restrict elem
+)
+{
+	uint32_t i = ixl->free_head;
+
+	if (i != IXL_NIL)
+		ixl->free_head = ixl->links[i].next;
+	else
+	{
+		if (ixl->n_used == ixl->cap &&
+			(ixl->cap == IXL_FREE || !ixl_reserve(ixl, ixl->cap + 1)))
+			return (IXL_NIL);
+
+		i = (ixl->n_used)++;
+	}
+
+	if (elem)
+		memcpy(ixl_slot(ixl, i), elem, ixl->elem_size);
+	else
+		memset(ixl_slot(ixl, i), 0, ixl->elem_size);
+
+	return (i);
+}
+
+/**
+ * ixl_insert_after - add an element after another one.
+ * @ixl: the `index_list`.
+ * @pos: index of an element of the list, `IXL_NIL` to insert at the head.
+ * @elem: the element, `elem_size` bytes are copied from it. If NULL the new
+ * element is zeroed.
+ *
+ * Return: index of the new element, `IXL_NIL` on failure.
+ */
+uint32_t ixl_insert_after(
+	index_list *const restrict ixl, const uint32_t pos,
+	void const *const restrict elem
+)
+{
+	if (!ixl || (pos != IXL_NIL && !ixl_is_live(ixl, pos)))
+		return (IXL_NIL);
+
+	const uint32_t i = ixl_slot_new(ixl, elem);
+
+	if (i == IXL_NIL)
+		return (IXL_NIL);
+
+	const uint32_t next = pos == IXL_NIL ? ixl->head : ixl->links[pos].next;
+
+	ixl->links[i].prev = pos;
+	ixl->links[i].next = next;
+	if (pos == IXL_NIL)
+		ixl->head = i;
+	else
+		ixl->links[pos].next = i;
+
+	if (next == IXL_NIL)
+		ixl->tail = i;
+	else
+		ixl->links[next].prev = i;
+
+	++(ixl->len);
+	return (i);
+}
+
+/**
+ * ixl_push_head - add an element to the head of an `index_list`.
+ * @ixl: the `index_list`.
+ * @elem: the element, see `ixl_insert_after`.
+ *
+ * Return: index of the new element, `IXL_NIL` on failure.
+ */
+uint32_t
+ixl_push_head(index_list *const restrict ixl, void const *const restrict elem)
+{
+	return (ixl_insert_after(ixl, IXL_NIL, elem));
+}
+
+/**
+ * ixl_push_tail - add an element to the tail of an `index_list`.
+ * @ixl: the `index_list`.
+ * @elem: the element, see `ixl_insert_after`.
+ *
+ * Return: index of the new element, `IXL_NIL` on failure.
+ */
+uint32_t
+ixl_push_tail(index_list *const restrict ixl, void const *const restrict elem)
+{
+	return (ixl_insert_after(ixl, ixl ? ixl->tail : IXL_NIL, elem));
+}
+
+/**
+ * ixl_remove - remove an element of an `index_list` in O(1).
+ * @ixl: the `index_list`.
+ * @i: index of an element of the list.
+ * @out: optional buffer of `elem_size` bytes receiving the element.
+ *
+ * The slot goes to the head of the free chain and is the next one reused.
+ *
+ * Return: 1 on success, 0 if `ixl` is NULL or `i` is not an element.
+ */
+int ixl_remove(
+	index_list *const restrict ixl, const uint32_t i, void *const restrict out
+)
+{
+	if (!ixl || !ixl_is_live(ixl, i))
+		return (0);
+
+	const struct ixl_link link = ixl->links[i];
+
+	if (out)
+		memcpy(out, ixl_slot(ixl, i), ixl->elem_size);
+
+	if (link.prev == IXL_NIL)
+		ixl->head = link.next;
+	else
+		ixl->links[link.prev].next = link.next;
+
+	if (link.next == IXL_NIL)
+		ixl->tail = link.prev;
+	else
+		ixl->links[link.next].prev = link.prev;
+
+	ixl->links[i].next = ixl->free_head;
+	ixl->links[i].prev = IXL_FREE;
+	ixl->free_head = i;
+	--(ixl->len);
+	return (1);
+}
+
+/**
+ * ixl_pop_head - remove the head element of an `index_list`.
+ * @ixl: the `index_list`.
+ * @out: optional buffer of `elem_size` bytes receiving the element.
+ *
+ * Return: 1 on success, 0 if the list is empty.
+ */
+int ixl_pop_head(index_list *const restrict ixl, void *const restrict out)
+{
+	return (ixl ? ixl_remove(ixl, ixl->head, out) : 0);
+}
+
+/**
+ * ixl_pop_tail - remove the tail element of an `index_list`.
+ * @ixl: the `index_list`.
+ * @out: optional buffer of `elem_size` bytes receiving the element.
+ *
+ * Return: 1 on success, 0 if the list is empty.
+ */
+int ixl_pop_tail(index_list *const restrict ixl, void *const restrict out)
+{
+	return (ixl ? ixl_remove(ixl, ixl->tail, out) : 0);
+}
+
+/**
+ * ixl_clear - remove all the elements of an `index_list` in O(1).
+ * @ixl: the `index_list`, its arrays are kept for reuse.
+ */
+void ixl_clear(index_list *const restrict ixl)
+{
+	if (!ixl)
+		return;
+
+	ixl->len = 0;
+	ixl->head = IXL_NIL;
+	ixl->tail = IXL_NIL;
+	ixl->free_head = IXL_NIL;
+	ixl->n_used = 0;
+}
+
+/**
+ * ixl_at - get an element of an `index_list`.
+ * @ixl: the `index_list`.
+ * @i: index of an element of the list.
+ *
+ * Return: pointer to the element, valid until the list grows, NULL if `i` is
+ * not an element.
+ */
+void *ixl_at(const index_list *const restrict ixl, const uint32_t i)
+{
+	if (!ixl || !ixl_is_live(ixl, i))
+		return (NULL);
+
+	return (ixl_slot(ixl, i));
+}
+
+/**
+ * ixl_next - get the element after another one.
+ * @ixl: the `index_list`.
+ * @i: index of an element of the list.
+ *
+ * Return: index of the next element, `IXL_NIL` if `i` is the tail or not an
+ * element.
+ */
+uint32_t ixl_next(const index_list *const restrict ixl, const uint32_t i)
+{
+	if (!ixl || !ixl_is_live(ixl, i))
+		return (IXL_NIL);
+
+	return (ixl->links[i].next);
+}
+
+/**
+ * ixl_prev - get the element before another one.
+ * @ixl: the `index_list`.
+ * @i: index of an element of the list.
+ *
+ * Return: index of the previous element, `IXL_NIL` if `i` is the head or not
+ * an element.
+ */
+uint32_t ixl_prev(const index_list *const restrict ixl, const uint32_t i)
+{
+	if (!ixl || !ixl_is_live(ixl, i))
+		return (IXL_NIL);
+
+	return (ixl->links[i].prev);
+}
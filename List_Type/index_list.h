@@ -0,0 +1,40 @@
+#ifndef DS_INDEX_LIST_TYPE_H
+#define DS_INDEX_LIST_TYPE_H
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* uint32_t */
+
+#include "attribute_macros.h"
+#include "list_type_typedefs.h"
+
+/* alloc and free */
+
+void *ixl_del(index_list *const restrict ixl);
+index_list *
+ixl_new(const size_t elem_size) ATTR_MALLOC ATTR_MALLOC_FREE(ixl_del);
+int ixl_reserve(index_list *const restrict ixl, const uint32_t n);
+
+/* manipulate */
+
+uint32_t ixl_insert_after(
+	index_list *const restrict ixl, const uint32_t pos,
+	void const *const restrict elem
+);
+uint32_t
+ixl_push_head(index_list *const restrict ixl, void const *const restrict elem);
+uint32_t
+ixl_push_tail(index_list *const restrict ixl, void const *const restrict elem);
+int ixl_remove(
+	index_list *const restrict ixl, const uint32_t i, void *const restrict out
+);
+int ixl_pop_head(index_list *const restrict ixl, void *const restrict out);
+int ixl_pop_tail(index_list *const restrict ixl, void *const restrict out);
+void ixl_clear(index_list *const restrict ixl);
+
+/* access */
+
+void *ixl_at(const index_list *const restrict ixl, const uint32_t i);
+uint32_t ixl_next(const index_list *const restrict ixl, const uint32_t i);
+uint32_t ixl_prev(const index_list *const restrict ixl, const uint32_t i);
+
+#endif /* DS_INDEX_LIST_TYPE_H */
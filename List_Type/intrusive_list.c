@@ -0,0 +1,267 @@
+#include <assert.h> /* asserts */
+
+#include "intrusive_list.h"
+#include "list_type_structs.h"
+
+/**
+ * ilink_init - initialise an `ilink` as not linked to anything.
+ * @link: pointer to the link.
+ */
+void ilink_init(ilink *const restrict link)
+{
+	assert(link);
+	link->next = NULL;
+	link->prev = NULL;
+}
+
+/**
+ * ilink_pop - remove a link from a linked list.
+ * @link: pointer to the link.
+ *
+ * Return: pointer to the popped link.
+ */
+ilink *ilink_pop(ilink *const restrict link)
+{
+	if (!link)
+		return (NULL);
+
+	if (link->next)
+		link->next->prev = link->prev;
+
+	if (link->prev)
+		link->prev->next = link->next;
+
+	link->next = NULL;
+	link->prev = NULL;
+	return (link);
+}
+
+/**
+ * ilink_insert_after - insert a link after another link.
+ * @this_link: pointer to a link.
+ * @other_link: pointer to the link to be inserted.
+ *
+ * Return: pointer to the newly inserted link, NULL if `other_link` is NULL.
+ */
+ilink *ilink_insert_after(
+	ilink *const restrict this_link, ilink *const restrict other_link
+)
+{
+	if (!this_link)
+		return (other_link);
+
+	return (ilink_splice_after(this_link, other_link, other_link));
+}
+
+/**
+ * ilink_insert_before - insert a link before another link.
+ * @this_link: pointer to a link.
+ * @other_link: pointer to the link to be inserted.
+ *
+ * Return: pointer to the newly inserted link, NULL if `other_link` is NULL.
+ */
+ilink *ilink_insert_before(
+	ilink *const restrict this_link, ilink *const restrict other_link
+)
+{
+	if (!this_link || !other_link)
+		return (other_link);
+
+	if (this_link->prev)
+		return (ilink_splice_after(this_link->prev, other_link, other_link));
+
+	other_link->prev = NULL;
+	other_link->next = this_link;
+	this_link->prev = other_link;
+	return (other_link);
+}
+
+/**
+ * ilink_splice_after - insert a chain of links after a link in O(1).
+ * @this_link: pointer to a link.
+ * @first: the first link of the chain.
+ * @last: the last link of the chain, reachable from `first`.
+ *
+ * Return: pointer to `last`, NULL if the chain is empty.
+ */
+ilink *ilink_splice_after(
+	ilink *const restrict this_link, ilink *const first, ilink *const last
+)
+{
+	if (!first || !last)
+		return (NULL);
+
+	if (!this_link)
+	{
+		first->prev = NULL;
+		last->next = NULL;
+		return (last);
+	}
+
+	ilink *const this_next = this_link->next;
+
+	this_link->next = first;
+	first->prev = this_link;
+	last->next = this_next;
+	if (this_next)
+		this_next->prev = last;
+
+	return (last);
+}
+
+/**
+ * idq_init - initialise an empty `intrusive_deque`.
+ * @idq: pointer to the deque.
+ */
+void idq_init(intrusive_deque *const restrict idq)
+{
+	assert(idq);
+	idq->len = 0;
+	idq->head = NULL;
+	idq->tail = NULL;
+}
+
+/**
+ * idq_insert_after - insert a link after a link of an `intrusive_deque`.
+ * @idq: the deque.
+ * @pos: a link in the deque, NULL to insert at the head.
+ * @link: the link to insert, must not be in any list.
+ *
+ * Return: pointer to the inserted link, NULL if `idq` or `link` is NULL.
+ */
+ilink *idq_insert_after(
+	intrusive_deque *const restrict idq, ilink *const pos,
+	ilink *const restrict link
+)
+{
+	if (!idq || !link)
+		return (NULL);
+
+	ilink_init(link);
+	if (pos)
+		ilink_insert_after(pos, link);
+	else
+		ilink_insert_before(idq->head, link);
+
+	if (!link->prev)
+		idq->head = link;
+
+	if (!link->next)
+		idq->tail = link;
+
+	++(idq->len);
+	return (link);
+}
+
+/**
+ * idq_insert_before - insert a link before a link of an `intrusive_deque`.
+ * @idq: the deque.
+ * @pos: a link in the deque, NULL to insert at the tail.
+ * @link: the link to insert, must not be in any list.
+ *
+ * Return: pointer to the inserted link, NULL if `idq` or `link` is NULL.
+ */
+ilink *idq_insert_before(
+	intrusive_deque *const restrict idq, ilink *const pos,
+	ilink *const restrict link
+)
+{
+	if (!idq || !link)
+		return (NULL);
+
+	return (idq_insert_after(idq, pos ? pos->prev : idq->tail, link));
+}
+
+/**
+ * idq_push_head - add a link to the head of an `intrusive_deque`.
+ * @idq: the deque.
+ * @link: the link to add, must not be in any list.
+ *
+ * Return: pointer to the link, NULL if `idq` or `link` is NULL.
+ */
+ilink *
+idq_push_head(intrusive_deque *const restrict idq, ilink *const restrict link)
+{
+	return (idq_insert_after(idq, NULL, link));
+}
+
+/**
+ * idq_push_tail - add a link to the tail of an `intrusive_deque`.
+ * @idq: the deque.
+ * @link: the link to add, must not be in any list.
+ *
+ * Return: pointer to the link, NULL if `idq` or `link` is NULL.
+ */
+ilink *
+idq_push_tail(intrusive_deque *const restrict idq, ilink *const restrict link)
+{
+	return (idq_insert_before(idq, NULL, link));
+}
+
+/**
+ * idq_remove - remove a link from an `intrusive_deque` in O(1).
+ * @idq: the deque.
+ * @link: a link in the deque.
+ *
+ * Return: pointer to the unlinked link, NULL if `idq` or `link` is NULL.
+ */
+ilink *
+idq_remove(intrusive_deque *const restrict idq, ilink *const restrict link)
+{
+	if (!idq || !link)
+		return (NULL);
+
+	if (idq->head == link)
+		idq->head = link->next;
+
+	if (idq->tail == link)
+		idq->tail = link->prev;
+
+	if (idq->len > 0)
+		--(idq->len);
+
+	return (ilink_pop(link));
+}
+
+/**
+ * idq_pop_head - remove the head link of an `intrusive_deque`.
+ * @idq: the deque.
+ *
+ * Return: pointer to the unlinked link, NULL if the deque is empty.
+ */
+ilink *idq_pop_head(intrusive_deque *const restrict idq)
+{
+	return (idq ? idq_remove(idq, idq->head) : NULL);
+}
+
+/**
+ * idq_pop_tail - remove the tail link of an `intrusive_deque`.
+ * @idq: the deque.
+ *
+ * Return: pointer to the unlinked link, NULL if the deque is empty.
+ */
+ilink *idq_pop_tail(intrusive_deque *const restrict idq)
+{
+	return (idq ? idq_remove(idq, idq->tail) : NULL);
+}
+
+/**
+ * idq_splice_tail - move all the links of a deque to the tail of another.
+ * @dst: the deque to append to.
+ * @src: the deque to take the links from, left empty.
+ */
+void idq_splice_tail(
+	intrusive_deque *const restrict dst, intrusive_deque *const restrict src
+)
+{
+	if (!dst || !src || !src->head)
+		return;
+
+	ilink_splice_after(dst->tail, src->head, src->tail);
+	if (!dst->head)
+		dst->head = src->head;
+
+	dst->tail = src->tail;
+	dst->len += src->len;
+	idq_init(src);
+}
@@ -0,0 +1,56 @@
+#ifndef DS_INTRUSIVE_LIST_TYPE_H
+#define DS_INTRUSIVE_LIST_TYPE_H
+
+#include <stddef.h> /* offsetof */
+
+#include "attribute_macros.h"
+#include "list_type_typedefs.h"
+
+#ifndef container_of
+	/* INFO: get the object a pointer to one of its members belongs to. */
+	#define container_of(ptr, type, member)                                    \
+		((type *)((char *)(ptr) - offsetof(type, member)))
+#endif /* container_of */
+
+/* INFO: get the object an `ilink` is embedded in, NULL for a NULL link. */
+#define ilink_entry(link, type, member)                                        \
+	((link) ? container_of(link, type, member) : (type *)NULL)
+
+/* links */
+
+void ilink_init(ilink *const restrict link) ATTR_NONNULL;
+ilink *ilink_pop(ilink *const restrict link);
+ilink *ilink_insert_after(
+	ilink *const restrict this_link, ilink *const restrict other_link
+);
+ilink *ilink_insert_before(
+	ilink *const restrict this_link, ilink *const restrict other_link
+);
+ilink *ilink_splice_after(
+	ilink *const restrict this_link, ilink *const first, ilink *const last
+);
+
+/* deque */
+
+void idq_init(intrusive_deque *const restrict idq) ATTR_NONNULL;
+ilink *
+idq_push_head(intrusive_deque *const restrict idq, ilink *const restrict link);
+ilink *
+idq_push_tail(intrusive_deque *const restrict idq, ilink *const restrict link);
+ilink *idq_pop_head(intrusive_deque *const restrict idq);
+ilink *idq_pop_tail(intrusive_deque *const restrict idq);
+ilink *idq_insert_after(
+	intrusive_deque *const restrict idq, ilink *const pos,
+	ilink *const restrict link
+);
+ilink *idq_insert_before(
+	intrusive_deque *const restrict idq, ilink *const pos,
+	ilink *const restrict link
+);
+ilink *
+idq_remove(intrusive_deque *const restrict idq, ilink *const restrict link);
+void idq_splice_tail(
+	intrusive_deque *const restrict dst, intrusive_deque *const restrict src
+);
+
+#endif /* DS_INTRUSIVE_LIST_TYPE_H */
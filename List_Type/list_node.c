@@ -1,18 +1,9 @@
-/* vsnprintf */
-#define _ISOC99_SOURCE
-
 #include <assert.h> /* asserts */
-#include <stdarg.h> /* va_arg, vsnprintf */
-#include <stdio.h>  /* vsnprintf */
 #include <stdlib.h> /* *alloc */
-#include <string.h> /* strlen, strcat */
 
 #include "list_node.h"
 #include "list_type_structs.h"
-
-static char *format_str(
-	const char *const restrict fmt, ...
-) ATTR_NONNULL ATTR_FORMAT(printf, 1, 2);
+#include "str_buf.h"
 
 /**
  * node_get_next - get next node.
@@ -248,11 +239,34 @@ list_node *lstnode_swap(
 	return (other_node);
 }
 
+/**
+ * lstnode_prefetch - move a pointer further down a list, prefetching the
+ * nodes it reaches.
+ * @ahead: the node the pointer is at, may be NULL.
+ * @n: number of nodes to move.
+ *
+ * Return: the node reached, NULL past the end of the list.
+ */
+static list_node *lstnode_prefetch(list_node *ahead, size_t n)
+{
+	for (; ahead && n > 0; --n)
+	{
+		ahead = ahead->next;
+		PREFETCH(ahead);
+	}
+
+	return (ahead);
+}
+
 /**
  * linked_list_del - free a linked list.
  * @head: pointer to the start of the linked list.
  * @free_data: function that will be called to free data in the nodes.
  *
+ * The whole list goes away, so only the node before `head` is unlinked and
+ * the nodes are freed without fixing up their neighbours. The walk
+ * prefetches `LT_PREFETCH_DIST` nodes ahead.
+ *
  * Return: NULL always.
  */
 void *linked_list_del(list_node *const head, free_func *free_data)
@@ -260,175 +274,304 @@ void *linked_list_del(list_node *const head, free_func *free_data)
 	if (!head)
 		return (NULL);
 
-	list_node *restrict walk = head, *next = lstnode_get_next(head);
+	if (head->prev)
+		head->prev->next = NULL;
+
+	list_node *ahead = lstnode_prefetch(head, LT_PREFETCH_DIST);
 
-	while (walk)
+	for (list_node *node = head, *next = NULL; node; node = next)
 	{
-		void *data = lstnode_del(walk);
+		ahead = lstnode_prefetch(ahead, 1);
+		next = node->next;
 		if (free_data)
-			free_data(data);
+			free_data(node->data);
 
-		walk = next;
-		next = walk ? lstnode_get_next(walk) : NULL;
+		free(node);
 	}
 
 	return (NULL);
 }
 
 /**
- * format_str - return a printf style formatted string.
- * @fmt: pointer to a string with format specifiers.
+ * linked_list_foreach - call a function on the data of every node of a
+ * linked list.
+ * @head: pointer to the start of the linked list.
+ * @action: the function, it must not unlink or free nodes.
+ * @arg: argument passed to every call of `action`.
  *
- * Return: pointer to the formatted string, NULL on failure.
+ * The walk prefetches `LT_PREFETCH_DIST` nodes ahead, so the cache misses of
+ * a scattered list overlap with the calls on earlier nodes.
  */
-static char *format_str(const char *const restrict fmt, ...)
+void linked_list_foreach(
+	list_node *const head, data_action *action, void *const arg
+)
 {
-	intmax_t size = 0;
-	char *restrict out_str = NULL;
-	va_list vars;
-
-	va_start(vars, fmt);
-	size = vsnprintf(NULL, 0, fmt, vars);
-	va_end(vars);
-	if (size < 0)
-		return (NULL);
+	if (!action)
+		return;
 
-	out_str = malloc(sizeof(*out_str) * (++size));
-	if (!out_str)
-		return (NULL);
+	list_node *ahead = lstnode_prefetch(head, LT_PREFETCH_DIST);
 
-	va_start(vars, fmt);
-	size = vsnprintf(out_str, size, fmt, vars);
-	va_end(vars);
-	if (size < 0)
+	for (list_node *node = head; node; node = node->next)
 	{
-		free(out_str);
-		out_str = NULL;
+		ahead = lstnode_prefetch(ahead, 1);
+		action(node->data, arg);
 	}
+}
 
-	return (out_str);
+/**
+ * lstnode_merge_next - merge two sorted chains following `next` only.
+ * @a: the first chain, wins ties.
+ * @b: the second chain.
+ * @cmp: function comparing the data of two nodes.
+ *
+ * Return: pointer to the first node of the merged chain.
+ */
+static list_node *
+lstnode_merge_next(list_node *a, list_node *b, data_cmp *cmp)
+{
+	list_node *head = NULL, *restrict *link = &head;
+
+	while (a && b)
+	{
+		if (cmp(b->data, a->data) < 0)
+		{
+			*link = b;
+			b = b->next;
+		}
+		else
+		{
+			*link = a;
+			a = a->next;
+		}
+
+		link = &(*link)->next;
+	}
+
+	*link = a ? a : b;
+	return (head);
 }
 
 /**
- * linked_list_tostr - stringify a linked list.
- * @head: pointer to the start of the linked list to stringify.
- * @stringify_data: function that will be called to stringify the data
- * in the linked list nodes.
+ * linked_list_relink - rebuild the `prev` pointers of a chain.
+ * @head: the first node of the chain.
  *
- * Return: pointer to the stringified linked list, NULL on error.
+ * Return: pointer to the last node of the chain.
  */
-char *linked_list_tostr(
-	list_node const *const restrict head, data_tostr *stringify_data
+static list_node *linked_list_relink(list_node *const head)
+{
+	list_node *tail = head;
+
+	head->prev = NULL;
+	for (; tail->next; tail = tail->next)
+		tail->next->prev = tail;
+
+	return (tail);
+}
+
+/**
+ * linked_list_merge - merge two sorted linked lists.
+ * @a: the first list, its nodes go first when they compare equal.
+ * @b: the second list.
+ * @cmp: function comparing the data of two nodes.
+ *
+ * Return: pointer to the head of the merged list.
+ */
+list_node *linked_list_merge(
+	list_node *const a, list_node *const b, data_cmp *cmp
 )
 {
-	if (!head)
-		return (NULL);
+	if (!a || !b || !cmp)
+		return (a ? a : b);
 
-	const char link[] = " <--> ";
-	char *restrict list_str = NULL, *restrict data_str = NULL;
-	intmax_t list_str_len = 0;
-	list_node const *restrict walk = head;
+	list_node *const head = lstnode_merge_next(a, b, cmp);
 
-	if (stringify_data)
-		list_str = stringify_data(lstnode_get_data(walk));
-	else
-		list_str = format_str("%p", lstnode_get_data(walk));
+	linked_list_relink(head);
+	return (head);
+}
 
-	if (!list_str)
-		return (NULL);
+/**
+ * linked_list_sort - sort a linked list in place with a stable merge sort.
+ * @head: pointer to the start of the linked list.
+ * @cmp: function comparing the data of two nodes.
+ * @tail: optional out parameter for the last node of the sorted list.
+ *
+ * The nodes are relinked, never copied. Sorted runs are kept in bins of
+ * doubling sizes like a binary counter, so the sort is bottom-up, needs no
+ * recursion and takes O(n log n) comparisons.
+ *
+ * Return: pointer to the head of the sorted list.
+ */
+list_node *linked_list_sort(
+	list_node *head, data_cmp *cmp, list_node **const restrict tail
+)
+{
+	list_node *bins[sizeof(size_t) * 8] = {NULL};
+	size_t n_bins = 0;
 
-	list_str_len += strlen(list_str);
-	walk = lstnode_get_next(walk);
-	while (list_str && walk)
+	if (!head || !cmp)
 	{
-		void *d = lstnode_get_data(walk);
+		if (tail)
+			*tail = head;
 
-		if (stringify_data)
-			data_str = stringify_data(d);
-		else
-			data_str = format_str("%p", d);
+		return (head);
+	}
 
-		if (!data_str)
-			goto malloc_error;
+	while (head)
+	{
+		list_node *run = head;
+		size_t i = 0;
 
-		list_str_len += sizeof(link) - 1 + strlen(data_str);
-		list_str = realloc(list_str, list_str_len + 1);
-		if (list_str)
-			strcat(strcat(list_str, link), data_str);
+		head = head->next;
+		run->next = NULL;
+		for (; i < n_bins && bins[i]; ++i)
+		{
+			run = lstnode_merge_next(bins[i], run, cmp);
+			bins[i] = NULL;
+		}
 
-		free(data_str);
-		data_str = NULL;
-		walk = lstnode_get_next(walk);
+		bins[i] = run;
+		if (i == n_bins)
+			++n_bins;
 	}
 
-	if (0)
+	for (size_t i = 0; i < n_bins; ++i)
+		head = lstnode_merge_next(bins[i], head, cmp);
+
+	list_node *const last = linked_list_relink(head);
+
+	if (tail)
+		*tail = last;
+
+	return (head);
+}
+
+/**
+ * linked_list_walk - write a linked list to a `str_buf`.
+ * @node: the node to start from.
+ * @reversed: whether to follow the `prev` pointers instead of `next`.
+ * @sb: the buffer.
+ * @write_data: function that will be called to write the data, if NULL
+ * `stringify_data` is used.
+ * @stringify_data: function that will be called to stringify the data, if
+ * both are NULL the address of the data is written.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int linked_list_walk(
+	list_node const *const restrict node, const int reversed,
+	str_buf *const restrict sb, data_write *write_data,
+	data_tostr *stringify_data
+)
+{
+	const char link[] = " <--> ";
+
+	for (list_node const *restrict walk = node; walk;
+		 walk = reversed ? walk->prev : walk->next)
 	{
-malloc_error:
-		free(list_str);
-		list_str = NULL;
+		if (walk != node && !strbuf_write(sb, link, sizeof(link) - 1))
+			return (0);
+
+		if (write_data)
+		{
+			if (!write_data(sb, walk->data))
+				return (0);
+		}
+		else if (stringify_data)
+		{
+			char *const restrict data_str = stringify_data(walk->data);
+			const int written = data_str && strbuf_puts(sb, data_str);
+
+			free(data_str);
+			if (!written)
+				return (0);
+		}
+		else if (!strbuf_printf(sb, "%p", walk->data))
+			return (0);
 	}
 
-	return (list_str);
+	return (1);
 }
 
 /**
- * linked_list_tostr_reversed - stringify a linked list in reverse.
+ * linked_list_write - write a linked list to a `str_buf`.
+ * @head: pointer to the start of the linked list.
+ * @sb: the buffer, in memory or writing to a stream.
+ * @write_data: function that will be called to write the data in the nodes,
+ * if NULL the address of the data is written.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int linked_list_write(
+	list_node const *const restrict head, str_buf *const restrict sb,
+	data_write *write_data
+)
+{
+	if (!head || !sb)
+		return (0);
+
+	return (linked_list_walk(head, 0, sb, write_data, NULL));
+}
+
+/**
+ * linked_list_write_reversed - write a linked list to a `str_buf` in reverse.
  * @tail: pointer to the tail of the linked list.
+ * @sb: the buffer, in memory or writing to a stream.
+ * @write_data: function that will be called to write the data in the nodes,
+ * if NULL the address of the data is written.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int linked_list_write_reversed(
+	list_node const *const restrict tail, str_buf *const restrict sb,
+	data_write *write_data
+)
+{
+	if (!tail || !sb)
+		return (0);
+
+	return (linked_list_walk(tail, 1, sb, write_data, NULL));
+}
+
+/**
+ * linked_list_tostr - stringify a linked list.
+ * @head: pointer to the start of the linked list to stringify.
  * @stringify_data: function that will be called to stringify the data
  * in the linked list nodes.
  *
  * Return: pointer to the stringified linked list, NULL on error.
  */
-char *linked_list_tostr_reversed(
-	list_node const *const restrict tail, data_tostr *stringify_data
+char *linked_list_tostr(
+	list_node const *const restrict head, data_tostr *stringify_data
 )
 {
-	if (!tail)
+	if (!head)
 		return (NULL);
 
-	const char link[] = " <--> ";
-	char *restrict list_str = NULL, *restrict data_str = NULL;
-	intmax_t list_str_len = 0;
-	list_node const *restrict walk = tail;
+	str_buf sb;
 
-	if (stringify_data)
-		list_str = stringify_data(lstnode_get_data(walk));
-	else
-		list_str = format_str("%p", lstnode_get_data(walk));
+	strbuf_init(&sb, NULL);
+	linked_list_walk(head, 0, &sb, NULL, stringify_data);
+	return (strbuf_release(&sb));
+}
 
-	if (!list_str)
+/**
+ * linked_list_tostr_reversed - stringify a linked list in reverse.
+ * @tail: pointer to the tail of the linked list.
+ * @stringify_data: function that will be called to stringify the data
+ * in the linked list nodes.
+ *
+ * Return: pointer to the stringified linked list, NULL on error.
+ */
+char *linked_list_tostr_reversed(
+	list_node const *const restrict tail, data_tostr *stringify_data
+)
+{
+	if (!tail)
 		return (NULL);
 
-	list_str_len += strlen(list_str);
-	walk = lstnode_get_prev(walk);
-	while (list_str && walk)
-	{
-		void *d = lstnode_get_data(walk);
-
-		if (stringify_data)
-			data_str = stringify_data(d);
-		else
-			data_str = format_str("%p", d);
-
-		if (!data_str)
-			goto malloc_error;
-
-		list_str_len += sizeof(link) - 1 + strlen(data_str);
-		list_str = realloc(list_str, list_str_len + 1);
-		if (list_str)
-			strcat(strcat(list_str, link), data_str);
-
-		free(data_str);
-		data_str = NULL;
-		walk = lstnode_get_prev(walk);
-	}
-
-	if (0)
-	{
-malloc_error:
-		free(list_str);
-		list_str = NULL;
-	}
+	str_buf sb;
 
-	return (list_str);
+	strbuf_init(&sb, NULL);
+	linked_list_walk(tail, 1, &sb, NULL, stringify_data);
+	return (strbuf_release(&sb));
 }
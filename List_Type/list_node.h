@@ -14,6 +14,21 @@ list_node *lstnode_new(
 
 void *linked_list_del(list_node *const head, free_func *free_data);
 
+/* iterate */
+
+void linked_list_foreach(
+	list_node *const head, data_action *action, void *const arg
+);
+
+/* sort */
+
+list_node *linked_list_merge(
+	list_node *const a, list_node *const b, data_cmp *cmp
+);
+list_node *linked_list_sort(
+	list_node *head, data_cmp *cmp, list_node **const restrict tail
+);
+
 /* access */
 
 list_node *lstnode_get_next(const list_node *const restrict node) ATTR_NONNULL;
@@ -49,5 +64,13 @@ char *linked_list_tostr(
 char *linked_list_tostr_reversed(
 	list_node const *const restrict tail, data_tostr *data_stringify
 ) ATTR_MALLOC;
+int linked_list_write(
+	list_node const *const restrict head, str_buf *const restrict sb,
+	data_write *write_data
+);
+int linked_list_write_reversed(
+	list_node const *const restrict tail, str_buf *const restrict sb,
+	data_write *write_data
+);
 
 #endif /* DS_LIST_NODE_TYPE_H */
@@ -1,7 +1,10 @@
 #ifndef DS_LIST_TYPE_STRUCTS_H
 #define DS_LIST_TYPE_STRUCTS_H
 
-#include <stdint.h> /* intmax_t */
+#include <stdatomic.h> /* atomic_size_t */
+#include <stddef.h>	/* size_t */
+#include <stdint.h>	/* intmax_t */
+#include <stdio.h>	/* FILE */
 
 #include "list_type_typedefs.h"
 
@@ -10,12 +13,20 @@
  * @len: number of nodes in the deque.
  * @head: pointer to the head node of the deque.
  * @tail: pointer to the tail node of the deque.
+ * @pool: pool the nodes are taken from, NULL if they are malloc'd.
+ * @owns_pool: whether the deque is one of the owners of `pool`.
+ * @finger: the node last reached by index, NULL if unknown.
+ * @finger_i: index of `finger`.
  */
 struct deque
 {
 	intmax_t len;
 	list_node *head;
 	list_node *tail;
+	node_pool *pool;
+	int owns_pool;
+	list_node *finger;
+	intmax_t finger_i;
 };
 
 /**
@@ -31,4 +42,236 @@ struct list_node
 	void *data;
 };
 
+/**
+ * struct ilink - a doubly linked link embedded in the user's own objects.
+ * @next: pointer to the next link.
+ * @prev: pointer to the previous link.
+ */
+struct ilink
+{
+	struct ilink *next;
+	struct ilink *prev;
+};
+
+/**
+ * struct intrusive_deque - a deque of objects with embedded `ilink`s.
+ * @len: number of links in the deque.
+ * @head: pointer to the head link of the deque.
+ * @tail: pointer to the tail link of the deque.
+ */
+struct intrusive_deque
+{
+	intmax_t len;
+	ilink *head;
+	ilink *tail;
+};
+
+/* Number of nodes per slab of a `node_pool` created with a length of 0. */
+#define NDPOOL_SLAB_LEN ((size_t)256)
+
+/**
+ * struct node_pool - a cache of `list_node`s carved from slabs.
+ * @free_list: unused nodes, linked through their `next` pointers.
+ * @n_free: number of nodes on the free list.
+ * @slabs: the slabs the nodes were carved from.
+ * @slab_len: number of nodes per slab.
+ * @n_owners: number of deques that own the pool, the last one frees it. 0
+ * for a pool managed by the caller.
+ */
+struct node_pool
+{
+	list_node *free_list;
+	size_t n_free;
+	struct ndpool_slab *slabs;
+	size_t slab_len;
+	size_t n_owners;
+};
+
+/* Number of element slots in a `block_deque` block, 512 bytes on LP64. */
+#define BDQ_BLOCK_LEN ((size_t)64)
+
+/**
+ * struct block_deque - a deque storing its elements in fixed size blocks.
+ * @len: number of elements in the deque.
+ * @head: position of the head element, counted in slots from the start of
+ * the block `map[0]` would point to.
+ * @map: array of pointers to blocks of `BDQ_BLOCK_LEN` slots, entries not
+ * holding any element are NULL.
+ * @map_len: number of entries in `map`.
+ * @spare: an emptied block kept for the next push, NULL if none.
+ */
+struct block_deque
+{
+	intmax_t len;
+	size_t head;
+	void ***map;
+	size_t map_len;
+	void **spare;
+};
+
+/**
+ * struct ring_deque - a deque stored in a circular array.
+ * @len: number of elements in the deque.
+ * @head: index of the head element in `buf`.
+ * @cap: number of slots in `buf`, 0 or a power of 2.
+ * @max_len: most elements the deque may hold, 0 if it may grow unbounded.
+ * @buf: the slots.
+ */
+struct ring_deque
+{
+	intmax_t len;
+	size_t head;
+	size_t cap;
+	size_t max_len;
+	void **buf;
+};
+
+/* Assumed size of a cache line, fields written by different threads are
+ * kept this far apart. */
+#define LT_CACHE_LINE ((size_t)64)
+
+/* Number of nodes ahead of the current one that list walks prefetch, far
+ * enough to hide a cache miss behind the work done on the nodes between. */
+#define LT_PREFETCH_DIST ((size_t)4)
+
+/**
+ * struct spsc_queue - a bounded single-producer single-consumer queue.
+ * @head: index of the next slot to read, written by the consumer only.
+ * @tail_cache: the consumer's last seen value of `tail`.
+ * @tail: index of the next slot to write, written by the producer only.
+ * @head_cache: the producer's last seen value of `head`.
+ * @mask: number of slots minus 1, the number of slots is a power of 2.
+ * @buf: the slots.
+ *
+ * The indices run freely and are masked on access. Each side keeps a cached
+ * copy of the other side's index, and only reloads it when the queue looks
+ * full or empty, so the cache lines only bounce when they have to.
+ */
+struct spsc_queue
+{
+	_Alignas(LT_CACHE_LINE) atomic_size_t head;
+	size_t tail_cache;
+	_Alignas(LT_CACHE_LINE) atomic_size_t tail;
+	size_t head_cache;
+	_Alignas(LT_CACHE_LINE) size_t mask;
+	void **buf;
+};
+
+/**
+ * struct mpmc_cell - a slot of a `mpmc_queue`.
+ * @seq: sequence number telling which lap of the ring the slot is ready for.
+ * @data: the element.
+ */
+struct mpmc_cell
+{
+	atomic_size_t seq;
+	void *data;
+};
+
+/**
+ * struct mpmc_queue - a bounded multi-producer multi-consumer queue.
+ * @head: index of the next slot to read, claimed by consumers.
+ * @tail: index of the next slot to write, claimed by producers.
+ * @mask: number of slots minus 1, the number of slots is a power of 2.
+ * @cells: the slots.
+ *
+ * A slot at position `pos` can be written when its sequence number is `pos`,
+ * and read when it is `pos + 1`. Threads claim a position with a CAS on the
+ * index and then hand the slot over with a store to its sequence number, so
+ * producers and consumers only contend with their own kind.
+ */
+struct mpmc_queue
+{
+	_Alignas(LT_CACHE_LINE) atomic_size_t head;
+	_Alignas(LT_CACHE_LINE) atomic_size_t tail;
+	_Alignas(LT_CACHE_LINE) size_t mask;
+	struct mpmc_cell *cells;
+};
+
+/**
+ * struct ws_deque - a growable Chase-Lev work-stealing deque.
+ * @head: index of the oldest element, advanced by thieves and by the owner
+ * when it takes the last element.
+ * @tail: index one past the newest element, written by the owner only.
+ * @buf: the current ring of slots.
+ * @retired: rings replaced by a bigger one, kept until the deque is deleted
+ * because a thief may still be reading from them.
+ *
+ * The owner pushes and pops at the tail, any other thread may steal from the
+ * head.
+ */
+struct ws_deque
+{
+	_Alignas(LT_CACHE_LINE) atomic_intmax_t head;
+	_Alignas(LT_CACHE_LINE) atomic_intmax_t tail;
+	_Atomic(struct wsdq_buffer *) buf;
+	struct wsdq_buffer *retired;
+};
+
+/**
+ * struct str_buf - a string written piece by piece.
+ * @str: the string built in memory, NUL terminated, NULL until the first
+ * write or when writing to a stream.
+ * @len: number of bytes written so far.
+ * @cap: size of the allocation behind `str`.
+ * @stream: stream the bytes go to, NULL to build the string in memory.
+ * @failed: set by the first failed write, later writes do nothing.
+ */
+struct str_buf
+{
+	char *str;
+	size_t len;
+	size_t cap;
+	FILE *stream;
+	int failed;
+};
+
+/* Index of no element of an `index_list`, ends its chains. */
+#define IXL_NIL UINT32_MAX
+
+/* Marks the `prev` link of a free `index_list` slot, and bounds the number
+ * of slots so that it is never a valid index. */
+#define IXL_FREE (UINT32_MAX - 1)
+
+/**
+ * struct ixl_link - the links of an `index_list` element.
+ * @next: index of the next element, or of the next free slot.
+ * @prev: index of the previous element, `IXL_FREE` for a free slot.
+ */
+struct ixl_link
+{
+	uint32_t next;
+	uint32_t prev;
+};
+
+/**
+ * struct index_list - a doubly linked list stored in growable arrays and
+ * linked by 32-bit indices.
+ * @len: number of elements in the list.
+ * @head: index of the head element, `IXL_NIL` if the list is empty.
+ * @tail: index of the tail element, `IXL_NIL` if the list is empty.
+ * @free_head: first slot of the chain of freed slots, `IXL_NIL` if none.
+ * @n_used: number of slots handed out at least once, the slots past it have
+ * never been used.
+ * @cap: number of slots in `links` and `data`.
+ * @elem_size: size in bytes of each element, stored inline in `data`.
+ * @links: the links of each slot.
+ * @data: the elements, `elem_size` bytes per slot.
+ *
+ * Since nothing points into the arrays, the list can be moved or written out
+ * as is.
+ */
+struct index_list
+{
+	uint32_t len;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t free_head;
+	uint32_t n_used;
+	uint32_t cap;
+	size_t elem_size;
+	struct ixl_link *links;
+	unsigned char *data;
+};
+
 #endif /* DS_LIST_TYPE_STRUCTS_H */
@@ -24,7 +24,72 @@ typedef void(free_func)(void *const data);
  */
 typedef char *(data_tostr)(void const *const data);
 
+/**
+ * data_cmp - a function that compares two objects.
+ * @a: the first object.
+ * @b: the second object.
+ *
+ * Return: negative if `a` goes before `b`, positive if it goes after, 0 if
+ * they are equal.
+ */
+typedef int(data_cmp)(void const *const a, void const *const b);
+
+/**
+ * data_action - a function called on each object of a container.
+ * @data: the object.
+ * @arg: the argument given to the iterator.
+ */
+typedef void(data_action)(void *const data, void *const arg);
+
+/**
+ * data_map - a function that transforms an object.
+ * @data: the object.
+ * @arg: the argument given to the iterator.
+ *
+ * Return: the object replacing `data`.
+ */
+typedef void *(data_map)(void *const data, void *const arg);
+
+/**
+ * data_pred - a function that tests an object.
+ * @data: the object.
+ * @arg: the argument given to the iterator.
+ *
+ * Return: non-zero if the object passes the test, 0 if it does not.
+ */
+typedef int(data_pred)(void const *const data, void *const arg);
+
+/**
+ * data_fold - a function that folds an object into an accumulator.
+ * @acc: the accumulator, updated in place.
+ * @data: the object.
+ * @arg: the argument given to the iterator.
+ */
+typedef void(data_fold)(
+	void *const acc, void const *const data, void *const arg
+);
+
+typedef struct str_buf str_buf;
+
+/**
+ * data_write - a function that writes an object to a `str_buf`.
+ * @sb: the buffer to write to.
+ * @data: the object to write.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+typedef int(data_write)(str_buf *const sb, void const *const data);
+
 typedef struct list_node list_node;
 typedef struct deque deque;
+typedef struct node_pool node_pool;
+typedef struct block_deque block_deque;
+typedef struct ring_deque ring_deque;
+typedef struct ilink ilink;
+typedef struct intrusive_deque intrusive_deque;
+typedef struct spsc_queue spsc_queue;
+typedef struct mpmc_queue mpmc_queue;
+typedef struct ws_deque ws_deque;
+typedef struct index_list index_list;
 
 #endif /* DS_LIST_TYPE_TYPEDEFS_H */
@@ -0,0 +1,243 @@
+/* sched_yield */
+#define _POSIX_C_SOURCE 200809L
+
+#include <sched.h>  /* sched_yield */
+#include <stdint.h> /* SIZE_MAX */
+#include <stdlib.h> /* *alloc */
+
+#include "list_type_structs.h"
+#include "mpmc_queue.h"
+
+/* Failed attempts spent spinning before a blocked thread starts yielding. */
+#define MPMCQ_SPINS (64U)
+
+/**
+ * mpmcq_new - allocate a `mpmc_queue`.
+ * @capacity: number of elements the queue must hold, rounded up to a power
+ * of 2 of at least 2.
+ *
+ * Return: pointer to the new queue, NULL on failure.
+ */
+mpmc_queue *mpmcq_new(const size_t capacity)
+{
+	size_t slots = 2;
+
+	if (capacity < 1)
+		return (NULL);
+
+	while (slots < capacity)
+	{
+		if (slots > SIZE_MAX / sizeof(struct mpmc_cell) / 2)
+			return (NULL);
+
+		slots <<= 1;
+	}
+
+	mpmc_queue *const q = aligned_alloc(LT_CACHE_LINE, sizeof(*q));
+
+	if (!q)
+		return (NULL);
+
+	q->cells = malloc(sizeof(*q->cells) * slots);
+	if (!q->cells)
+	{
+		free(q);
+		return (NULL);
+	}
+
+	for (size_t i = 0; i < slots; ++i)
+	{
+		atomic_init(&q->cells[i].seq, i);
+		q->cells[i].data = NULL;
+	}
+
+	atomic_init(&q->head, 0);
+	atomic_init(&q->tail, 0);
+	q->mask = slots - 1;
+	return (q);
+}
+
+/**
+ * mpmcq_del - free a `mpmc_queue`, no thread may be using it.
+ * @q: the queue.
+ * @free_data: optional function that will be called on queued data.
+ *
+ * Return: NULL always.
+ */
+void *mpmcq_del(mpmc_queue *const restrict q, free_func *free_data)
+{
+	if (!q)
+		return (NULL);
+
+	void *data = NULL;
+
+	while (free_data && mpmcq_try_pop(q, &data))
+		free_data(data);
+
+	free(q->cells);
+	free(q);
+	return (NULL);
+}
+
+/**
+ * mpmcq_try_push - add an element if there is room.
+ * @q: the queue.
+ * @data: the element.
+ *
+ * Return: 1 on success, 0 if the queue is full.
+ */
+int mpmcq_try_push(mpmc_queue *const restrict q, void *const data)
+{
+	if (!q)
+		return (0);
+
+	size_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+	struct mpmc_cell *cell = NULL;
+
+	for (;;)
+	{
+		cell = &q->cells[pos & q->mask];
+
+		const size_t seq =
+			atomic_load_explicit(&cell->seq, memory_order_acquire);
+		const ptrdiff_t lap = (ptrdiff_t)(seq - pos);
+
+		if (lap < 0)
+			return (0);
+
+		if (lap > 0)
+			pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+		else if (atomic_compare_exchange_weak_explicit(
+					 &q->tail, &pos, pos + 1, memory_order_relaxed,
+					 memory_order_relaxed
+				 ))
+			break;
+	}
+
+	cell->data = data;
+	atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+	return (1);
+}
+
+/**
+ * mpmcq_try_pop - remove an element if there is one.
+ * @q: the queue.
+ * @data: out parameter for the element.
+ *
+ * Return: 1 on success, 0 if the queue is empty.
+ */
+int mpmcq_try_pop(mpmc_queue *const restrict q, void **const restrict data)
+{
+	if (!q || !data)
+		return (0);
+
+	size_t pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+	struct mpmc_cell *cell = NULL;
+
+	for (;;)
+	{
+		cell = &q->cells[pos & q->mask];
+
+		const size_t seq =
+			atomic_load_explicit(&cell->seq, memory_order_acquire);
+		const ptrdiff_t lap = (ptrdiff_t)(seq - (pos + 1));
+
+		if (lap < 0)
+			return (0);
+
+		if (lap > 0)
+			pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+		else if (atomic_compare_exchange_weak_explicit(
+					 &q->head, &pos, pos + 1, memory_order_relaxed,
+					 memory_order_relaxed
+				 ))
+			break;
+	}
+
+	*data = cell->data;
+	atomic_store_explicit(
+		&cell->seq, pos + q->mask + 1, memory_order_release
+	);
+	return (1);
+}
+
+/**
+ * mpmcq_backoff - wait a little after a failed attempt.
+ * @spins: number of consecutive failed attempts.
+ */
+static void mpmcq_backoff(unsigned int *const restrict spins)
+{
+	if (*spins < MPMCQ_SPINS)
+		++(*spins);
+	else
+		sched_yield();
+}
+
+/**
+ * mpmcq_push - add an element, waiting for room if the queue is full.
+ * @q: the queue.
+ * @data: the element.
+ *
+ * Return: 1 once the element is added, 0 if `q` is NULL.
+ */
+int mpmcq_push(mpmc_queue *const restrict q, void *const data)
+{
+	if (!q)
+		return (0);
+
+	unsigned int spins = 0;
+
+	while (!mpmcq_try_push(q, data))
+		mpmcq_backoff(&spins);
+
+	return (1);
+}
+
+/**
+ * mpmcq_pop - remove an element, waiting for one if the queue is empty.
+ * @q: the queue.
+ * @data: out parameter for the element.
+ *
+ * Return: 1 once an element is removed, 0 if `q` or `data` is NULL.
+ */
+int mpmcq_pop(mpmc_queue *const restrict q, void **const restrict data)
+{
+	if (!q || !data)
+		return (0);
+
+	unsigned int spins = 0;
+
+	while (!mpmcq_try_pop(q, data))
+		mpmcq_backoff(&spins);
+
+	return (1);
+}
+
+/**
+ * mpmcq_len - number of elements in a `mpmc_queue`.
+ * @q: the queue.
+ *
+ * Return: the number of claimed slots, only a snapshot while threads use
+ * the queue.
+ */
+size_t mpmcq_len(const mpmc_queue *const restrict q)
+{
+	if (!q)
+		return (0);
+
+	const size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+	const size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+	return (tail - head < q->mask + 1 ? tail - head : q->mask + 1);
+}
+
+/**
+ * mpmcq_capacity - number of elements a `mpmc_queue` can hold.
+ * @q: the queue.
+ *
+ * Return: the capacity.
+ */
+size_t mpmcq_capacity(const mpmc_queue *const restrict q)
+{
+	return (q ? q->mask + 1 : 0);
+}
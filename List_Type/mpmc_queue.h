@@ -0,0 +1,30 @@
+#ifndef DS_MPMC_QUEUE_TYPE_H
+#define DS_MPMC_QUEUE_TYPE_H
+
+#include <stddef.h> /* size_t */
+
+#include "attribute_macros.h"
+#include "list_type_typedefs.h"
+
+/* alloc and free */
+
+void *mpmcq_del(mpmc_queue *const restrict q, free_func *free_data);
+mpmc_queue *
+mpmcq_new(const size_t capacity) ATTR_MALLOC ATTR_MALLOC_FREE(mpmcq_del);
+
+/* non-blocking */
+
+int mpmcq_try_push(mpmc_queue *const restrict q, void *const data);
+int mpmcq_try_pop(mpmc_queue *const restrict q, void **const restrict data);
+
+/* blocking */
+
+int mpmcq_push(mpmc_queue *const restrict q, void *const data);
+int mpmcq_pop(mpmc_queue *const restrict q, void **const restrict data);
+
+/* info */
+
+size_t mpmcq_len(const mpmc_queue *const restrict q);
+size_t mpmcq_capacity(const mpmc_queue *const restrict q);
+
+#endif /* DS_MPMC_QUEUE_TYPE_H */
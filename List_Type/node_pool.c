@@ -0,0 +1,187 @@
+#include <stdint.h> /* SIZE_MAX */
+#include <stdlib.h> /* *alloc */
+
+#include "list_node.h"
+#include "list_type_structs.h"
+#include "node_pool.h"
+
+/**
+ * struct ndpool_slab - a block of nodes allocated at once.
+ * @next: the next slab of the pool.
+ * @len: number of nodes in the slab.
+ * @nodes: the nodes.
+ */
+struct ndpool_slab
+{
+	struct ndpool_slab *next;
+	size_t len;
+	list_node nodes[];
+};
+
+/**
+ * ndpool_add_slab - allocate a slab and put its nodes on the free list.
+ * @pool: the `node_pool`.
+ * @len: number of nodes in the slab.
+ *
+ * Return: 1 on success, 0 on allocation failure.
+ */
+static int ndpool_add_slab(node_pool *const restrict pool, const size_t len)
+{
+	if (len > (SIZE_MAX - sizeof(struct ndpool_slab)) / sizeof(list_node))
+		return (0);
+
+	struct ndpool_slab *const slab =
+		malloc(sizeof(*slab) + sizeof(list_node) * len);
+
+	if (!slab)
+		return (0);
+
+	slab->len = len;
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+	for (size_t i = len; i > 0; --i)
+	{
+		slab->nodes[i - 1].next = pool->free_list;
+		pool->free_list = &slab->nodes[i - 1];
+	}
+
+	pool->n_free += len;
+	return (1);
+}
+
+/**
+ * ndpool_new - allocate and initialise a `node_pool`.
+ * @slab_len: number of nodes allocated at once, 0 for `NDPOOL_SLAB_LEN`.
+ *
+ * Return: pointer to the new pool, NULL on failure.
+ */
+node_pool *ndpool_new(const size_t slab_len)
+{
+	node_pool *const pool = calloc(1, sizeof(*pool));
+
+	if (pool)
+		pool->slab_len = slab_len ? slab_len : NDPOOL_SLAB_LEN;
+
+	return (pool);
+}
+
+/**
+ * ndpool_del - free a `node_pool` and all its nodes.
+ * @pool: the `node_pool`, no node taken from it may still be in use.
+ *
+ * Return: NULL always.
+ */
+void *ndpool_del(node_pool *const restrict pool)
+{
+	if (!pool)
+		return (NULL);
+
+	while (pool->slabs)
+	{
+		struct ndpool_slab *const next = pool->slabs->next;
+
+		free(pool->slabs);
+		pool->slabs = next;
+	}
+
+	free(pool);
+	return (NULL);
+}
+
+/**
+ * ndpool_reserve - make sure a number of nodes can be taken without
+ * allocating.
+ * @pool: the `node_pool`.
+ * @n: number of nodes.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int ndpool_reserve(node_pool *const restrict pool, const size_t n)
+{
+	if (!pool)
+		return (0);
+
+	if (pool->n_free >= n)
+		return (1);
+
+	const size_t need = n - pool->n_free;
+
+	return (
+		ndpool_add_slab(pool, need > pool->slab_len ? need : pool->slab_len)
+	);
+}
+
+/**
+ * ndpool_alloc - take a node from a `node_pool`.
+ * @pool: the `node_pool`.
+ * @data: data that the node will hold.
+ * @copy_data: function that returns a separate copy of data,
+ * if NULL a simple copy of the pointer to data is done.
+ *
+ * Return: pointer to the unlinked node, NULL on failure.
+ */
+list_node *ndpool_alloc(
+	node_pool *const restrict pool, void *const data, dup_func *copy_data
+)
+{
+	if (!pool || (!pool->free_list && !ndpool_add_slab(pool, pool->slab_len)))
+		return (NULL);
+
+	void *const d = copy_data ? copy_data(data) : data;
+
+	if (!d && data)
+		return (NULL);
+
+	list_node *const node = pool->free_list;
+
+	pool->free_list = node->next;
+	--(pool->n_free);
+	node->next = NULL;
+	node->prev = NULL;
+	node->data = d;
+	return (node);
+}
+
+/**
+ * ndpool_free - unlink a node and return it to its `node_pool`.
+ * @pool: the `node_pool` the node was taken from.
+ * @node: the node.
+ *
+ * Return: pointer to the data in the node.
+ */
+void *
+ndpool_free(node_pool *const restrict pool, list_node *const restrict node)
+{
+	if (!pool || !node)
+		return (NULL);
+
+	void *const data = lstnode_set_data(node, NULL);
+
+	lstnode_pop(node);
+	node->next = pool->free_list;
+	pool->free_list = node;
+	++(pool->n_free);
+	return (data);
+}
+
+/**
+ * ndpool_free_chain - return a whole linked list of nodes in O(1).
+ * @pool: the `node_pool` the nodes were taken from.
+ * @head: the first node, nothing may link to it.
+ * @tail: the last node, reachable from `head` through the `next` pointers.
+ * @n: number of nodes from `head` to `tail`.
+ *
+ * The data of the nodes is left to the caller.
+ */
+void ndpool_free_chain(
+	node_pool *const restrict pool, list_node *const head,
+	list_node *const tail, const size_t n
+)
+{
+	if (!pool || !head || !tail)
+		return;
+
+	tail->next = pool->free_list;
+	pool->free_list = head;
+	pool->n_free += n;
+}
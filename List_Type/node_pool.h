@@ -0,0 +1,28 @@
+#ifndef DS_NODE_POOL_TYPE_H
+#define DS_NODE_POOL_TYPE_H
+
+#include <stddef.h> /* size_t */
+
+#include "attribute_macros.h"
+#include "list_type_typedefs.h"
+
+/* alloc and free */
+
+void *ndpool_del(node_pool *const restrict pool);
+node_pool *ndpool_new(const size_t slab_len) ATTR_MALLOC
+	ATTR_MALLOC_FREE(ndpool_del);
+int ndpool_reserve(node_pool *const restrict pool, const size_t n);
+
+/* nodes */
+
+list_node *ndpool_alloc(
+	node_pool *const restrict pool, void *const data, dup_func *copy_data
+);
+void *
+ndpool_free(node_pool *const restrict pool, list_node *const restrict node);
+void ndpool_free_chain(
+	node_pool *const restrict pool, list_node *const head,
+	list_node *const tail, const size_t n
+);
+
+#endif /* DS_NODE_POOL_TYPE_H */
@@ -0,0 +1,203 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "deque.h"
+#include "list_type_structs.h"
+#include "mpmc_queue.h"
+
+#define N_MESSAGES ((uintptr_t)1 << 21)
+#define QUEUE_LEN ((size_t)1024)
+#define MAX_THREADS (64)
+
+/**
+ * struct bench - state shared by the threads of a benchmark.
+ * @q: the lock-free queue, NULL when running the locked baseline.
+ * @dq: the deque of the locked baseline.
+ * @lock: mutex protecting `dq`.
+ * @per_thread: number of messages each producer and consumer handles.
+ * @next_cpu: cpu the next thread will be pinned to.
+ * @sum: sum of all the messages received.
+ */
+struct bench
+{
+	mpmc_queue *q;
+	deque *dq;
+	pthread_mutex_t lock;
+	uintptr_t per_thread;
+	atomic_int next_cpu;
+	atomic_uintptr_t sum;
+};
+
+/**
+ * pin_thread - pin the calling thread to the next available cpu.
+ * @b: the benchmark state.
+ */
+static void pin_thread(struct bench *b)
+{
+	cpu_set_t set;
+	const int cpu = atomic_fetch_add(&b->next_cpu, 1);
+
+	if (sched_getaffinity(0, sizeof(set), &set) || CPU_COUNT(&set) < 2)
+		return;
+
+	for (int i = 0, seen = 0; i < CPU_SETSIZE; ++i)
+	{
+		if (!CPU_ISSET(i, &set))
+			continue;
+
+		if (seen++ == cpu % CPU_COUNT(&set))
+		{
+			CPU_ZERO(&set);
+			CPU_SET(i, &set);
+			pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+			return;
+		}
+	}
+}
+
+/**
+ * produce - push `per_thread` messages.
+ * @arg: the benchmark state.
+ *
+ * Return: NULL.
+ */
+static void *produce(void *arg)
+{
+	struct bench *const b = arg;
+
+	pin_thread(b);
+	for (uintptr_t i = 1; i <= b->per_thread; ++i)
+	{
+		if (b->q)
+		{
+			mpmcq_push(b->q, (void *)i);
+			continue;
+		}
+
+		pthread_mutex_lock(&b->lock);
+		dq_push_tail(b->dq, (void *)i, NULL);
+		pthread_mutex_unlock(&b->lock);
+	}
+
+	return (NULL);
+}
+
+/**
+ * consume - pop `per_thread` messages.
+ * @arg: the benchmark state.
+ *
+ * Return: NULL.
+ */
+static void *consume(void *arg)
+{
+	struct bench *const b = arg;
+	uintptr_t sum = 0;
+	void *d = NULL;
+
+	pin_thread(b);
+	for (uintptr_t i = 0; i < b->per_thread;)
+	{
+		if (b->q)
+			mpmcq_pop(b->q, &d);
+		else
+		{
+			pthread_mutex_lock(&b->lock);
+			d = dq_pop_head(b->dq);
+			pthread_mutex_unlock(&b->lock);
+			if (!d)
+			{
+				sched_yield();
+				continue;
+			}
+		}
+
+		sum += (uintptr_t)d;
+		++i;
+	}
+
+	atomic_fetch_add(&b->sum, sum);
+	return (NULL);
+}
+
+/**
+ * run - time `N_MESSAGES` going through `n` producers and `n` consumers.
+ * @label: name of the queue.
+ * @b: the benchmark state.
+ * @n: number of producer and consumer threads.
+ */
+static void run(const char *label, struct bench *b, int n)
+{
+	pthread_t threads[MAX_THREADS * 2];
+	struct timespec start, end;
+	int started = 0;
+
+	b->per_thread = N_MESSAGES / n;
+	atomic_store(&b->next_cpu, 0);
+	atomic_store(&b->sum, 0);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < n; ++i)
+	{
+		if (!pthread_create(&threads[started], NULL, consume, b))
+			++started;
+
+		if (!pthread_create(&threads[started], NULL, produce, b))
+			++started;
+	}
+
+	for (int i = 0; i < started; ++i)
+		pthread_join(threads[i], NULL);
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	printf(
+		"%-12s %2dP/%2dC: %.2f Mmsg/s%s\n", label, n, n,
+		b->per_thread * n /
+			((end.tv_sec - start.tv_sec) +
+			 (end.tv_nsec - start.tv_nsec) / 1e9) /
+			1e6,
+		started == n * 2 &&
+				b->sum == n * (b->per_thread * (b->per_thread + 1) / 2)
+			? ""
+			: " (failed)"
+	);
+}
+
+/**
+ * main - compare the MPMC queue to a mutex protected `deque` under
+ * contention.
+ * @argc: number of arguments.
+ * @argv: optional maximum number of producers, as many consumers are used.
+ *
+ * Return: 0 on success, 1 on allocation failure.
+ */
+int main(int argc, char **argv)
+{
+	const int max = argc > 1 ? atoi(argv[1]) : 4;
+	struct bench b = {.q = NULL, .dq = dq_new()};
+	mpmc_queue *const q = mpmcq_new(QUEUE_LEN);
+
+	pthread_mutex_init(&b.lock, NULL);
+	if (!q || !b.dq || max < 1 || max > MAX_THREADS)
+	{
+		mpmcq_del(q, NULL);
+		dq_del(b.dq, NULL);
+		return (1);
+	}
+
+	for (int n = 1; n <= max; n *= 2)
+	{
+		b.q = q;
+		run("mpmc queue", &b, n);
+		b.q = NULL;
+		run("mutex deque", &b, n);
+	}
+
+	mpmcq_del(q, NULL);
+	dq_del(b.dq, NULL);
+	pthread_mutex_destroy(&b.lock);
+	return (0);
+}
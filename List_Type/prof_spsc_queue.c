@@ -0,0 +1,313 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "deque.h"
+#include "list_type_structs.h"
+#include "spsc_queue.h"
+
+#define N_MESSAGES ((uintptr_t)1 << 22)
+#define N_PINGS ((uintptr_t)1 << 17)
+#define QUEUE_LEN ((size_t)1024)
+#define BATCH_LEN ((size_t)32)
+
+/**
+ * struct bench - state shared by the two threads of a benchmark.
+ * @q: the lock-free queue.
+ * @reply: queue for the way back of the ping-pong benchmark.
+ * @dq: the deque of the locked baseline.
+ * @lock: mutex protecting `dq`.
+ * @cpu: cpu the producer thread is pinned to.
+ */
+struct bench
+{
+	spsc_queue *q;
+	spsc_queue *reply;
+	deque *dq;
+	pthread_mutex_t lock;
+	int cpu;
+};
+
+/**
+ * pin_thread - pin the calling thread to a cpu.
+ * @cpu: the cpu, taken modulo the number of cpus available.
+ */
+static void pin_thread(int cpu)
+{
+	cpu_set_t set;
+
+	if (sched_getaffinity(0, sizeof(set), &set) || CPU_COUNT(&set) < 2)
+		return;
+
+	for (int i = 0, seen = 0; i < CPU_SETSIZE; ++i)
+	{
+		if (!CPU_ISSET(i, &set))
+			continue;
+
+		if (seen++ == cpu % CPU_COUNT(&set))
+		{
+			CPU_ZERO(&set);
+			CPU_SET(i, &set);
+			pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+			return;
+		}
+	}
+}
+
+/**
+ * backoff - wait for the other thread after a failed queue operation.
+ * @spins: number of consecutive failures, reset by the caller on success.
+ *
+ * Spinning keeps latency low when both threads have a cpu, yielding lets the
+ * other thread run when they share one.
+ */
+static void backoff(unsigned int *const spins)
+{
+	if (++(*spins) > 64)
+		sched_yield();
+}
+
+/**
+ * elapsed - seconds between two points in time.
+ * @start: the first point.
+ * @end: the second point.
+ *
+ * Return: the number of seconds.
+ */
+static double elapsed(const struct timespec *start, const struct timespec *end)
+{
+	return (
+		(end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9
+	);
+}
+
+/**
+ * produce_single - push messages one at a time.
+ * @arg: the benchmark state.
+ *
+ * Return: NULL.
+ */
+static void *produce_single(void *arg)
+{
+	struct bench *const b = arg;
+
+	unsigned int spins = 0;
+
+	pin_thread(b->cpu);
+	for (uintptr_t i = 1; i <= N_MESSAGES; ++i, spins = 0)
+	{
+		while (!spscq_push(b->q, (void *)i))
+			backoff(&spins);
+	}
+
+	return (NULL);
+}
+
+/**
+ * produce_batch - push messages `BATCH_LEN` at a time.
+ * @arg: the benchmark state.
+ *
+ * Return: NULL.
+ */
+static void *produce_batch(void *arg)
+{
+	struct bench *const b = arg;
+	void *batch[BATCH_LEN];
+	unsigned int spins = 0;
+
+	pin_thread(b->cpu);
+	for (uintptr_t i = 1; i <= N_MESSAGES; i += BATCH_LEN)
+	{
+		size_t done = 0;
+
+		for (size_t j = 0; j < BATCH_LEN; ++j)
+			batch[j] = (void *)(i + j);
+
+		while (done < BATCH_LEN)
+		{
+			const size_t n = spscq_push_n(b->q, batch + done, BATCH_LEN - done);
+
+			if (!n)
+				backoff(&spins);
+			else
+				spins = 0;
+
+			done += n;
+		}
+	}
+
+	return (NULL);
+}
+
+/**
+ * produce_locked - push messages to the mutex protected deque.
+ * @arg: the benchmark state.
+ *
+ * Return: NULL.
+ */
+static void *produce_locked(void *arg)
+{
+	struct bench *const b = arg;
+
+	pin_thread(b->cpu);
+	for (uintptr_t i = 1; i <= N_MESSAGES; ++i)
+	{
+		pthread_mutex_lock(&b->lock);
+		dq_push_tail(b->dq, (void *)i, NULL);
+		pthread_mutex_unlock(&b->lock);
+	}
+
+	return (NULL);
+}
+
+/**
+ * echo - send every message of `q` back through `reply`.
+ * @arg: the benchmark state.
+ *
+ * Return: NULL.
+ */
+static void *echo(void *arg)
+{
+	struct bench *const b = arg;
+	void *d = NULL;
+	unsigned int spins = 0;
+
+	pin_thread(b->cpu);
+	for (uintptr_t i = 0; i < N_PINGS; ++i, spins = 0)
+	{
+		while (!spscq_pop(b->q, &d))
+			backoff(&spins);
+
+		while (!spscq_push(b->reply, d))
+			backoff(&spins);
+	}
+
+	return (NULL);
+}
+
+/**
+ * run_throughput - time the transfer of `N_MESSAGES` between two threads.
+ * @label: name of the benchmark.
+ * @b: the benchmark state.
+ * @producer: the producer thread function.
+ * @batched: whether the consumer should pop in batches.
+ */
+static void run_throughput(
+	const char *label, struct bench *b, void *(*producer)(void *), int batched
+)
+{
+	struct timespec start, end;
+	pthread_t thread;
+	void *batch[BATCH_LEN];
+	uintptr_t received = 0, sum = 0;
+	unsigned int spins = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	if (pthread_create(&thread, NULL, producer, b))
+		return;
+
+	while (received < N_MESSAGES)
+	{
+		size_t n = 0;
+
+		if (b->dq)
+		{
+			pthread_mutex_lock(&b->lock);
+			batch[0] = dq_pop_head(b->dq);
+			pthread_mutex_unlock(&b->lock);
+			n = batch[0] != NULL;
+		}
+		else if (batched)
+			n = spscq_pop_n(b->q, batch, BATCH_LEN);
+		else
+			n = spscq_pop(b->q, batch);
+
+		if (!n)
+			backoff(&spins);
+		else
+			spins = 0;
+
+		for (size_t i = 0; i < n; ++i)
+			sum += (uintptr_t)batch[i];
+
+		received += n;
+	}
+
+	pthread_join(thread, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	printf(
+		"%-14s: %.1f Mmsg/s%s\n", label,
+		N_MESSAGES / elapsed(&start, &end) / 1e6,
+		sum == N_MESSAGES * (N_MESSAGES + 1) / 2 ? "" : " (corrupted)"
+	);
+}
+
+/**
+ * run_latency - time round trips of a single message between two threads.
+ * @b: the benchmark state.
+ */
+static void run_latency(struct bench *b)
+{
+	struct timespec start, end;
+	pthread_t thread;
+	void *d = NULL;
+	unsigned int spins = 0;
+
+	if (pthread_create(&thread, NULL, echo, b))
+		return;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (uintptr_t i = 1; i <= N_PINGS; ++i, spins = 0)
+	{
+		while (!spscq_push(b->q, (void *)i))
+			backoff(&spins);
+
+		while (!spscq_pop(b->reply, &d))
+			backoff(&spins);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	pthread_join(thread, NULL);
+	printf(
+		"%-14s: %.0f ns/round trip\n", "ping-pong",
+		elapsed(&start, &end) * 1e9 / N_PINGS
+	);
+}
+
+/**
+ * main - compare the SPSC queue to a mutex protected `deque`.
+ * @argc: number of arguments.
+ * @argv: optional producer cpu, the consumer runs on the cpu after it.
+ *
+ * Return: 0 on success, 1 on allocation failure.
+ */
+int main(int argc, char **argv)
+{
+	struct bench b = {
+		.q = spscq_new(QUEUE_LEN),
+		.reply = spscq_new(QUEUE_LEN),
+		.cpu = argc > 1 ? atoi(argv[1]) + 1 : 1,
+	};
+
+	pthread_mutex_init(&b.lock, NULL);
+	if (!b.q || !b.reply)
+		return (1);
+
+	pin_thread(b.cpu - 1);
+	run_throughput("spsc single", &b, produce_single, 0);
+	run_throughput("spsc batch", &b, produce_batch, 1);
+	run_latency(&b);
+	b.dq = dq_new();
+	if (b.dq)
+		run_throughput("mutex deque", &b, produce_locked, 0);
+
+	b.dq = dq_del(b.dq, NULL);
+	spscq_del(b.q, NULL);
+	spscq_del(b.reply, NULL);
+	pthread_mutex_destroy(&b.lock);
+	return (0);
+}
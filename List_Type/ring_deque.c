@@ -0,0 +1,313 @@
+#include <stdlib.h> /* *alloc */
+#include <string.h> /* memcpy */
+
+#include "list_type_structs.h"
+#include "matrix.h"
+#include "ring_deque.h"
+
+/* Number of slots allocated by the first push. */
+#define RDQ_CAP_MIN ((size_t)8)
+
+/**
+ * rdq_slot - get the slot of an element of a `ring_deque`.
+ * @rdq: the `ring_deque`.
+ * @i: index of the element from the head, may be one past the tail.
+ *
+ * Return: pointer to the slot.
+ */
+static void **rdq_slot(const ring_deque *const restrict rdq, const size_t i)
+{
+	return (&rdq->buf[(rdq->head + i) & (rdq->cap - 1)]);
+}
+
+/**
+ * rdq_resize - move the elements of a `ring_deque` to a new buffer.
+ * @rdq: the `ring_deque`.
+ * @cap: size of the new buffer, a power of 2 not less than the length.
+ *
+ * The elements are unwrapped so that the head lands in slot 0.
+ *
+ * Return: 1 on success, 0 on allocation failure.
+ */
+static int rdq_resize(ring_deque *const restrict rdq, const size_t cap)
+{
+	void **const buf = malloc(sizeof(*buf) * cap);
+
+	if (!buf)
+		return (0);
+
+	if (rdq->len > 0)
+	{
+		const size_t len = (size_t)rdq->len;
+		const size_t first = rdq->cap - rdq->head < len ? rdq->cap - rdq->head
+													   : len;
+
+		memcpy(buf, rdq->buf + rdq->head, sizeof(*buf) * first);
+		memcpy(buf + first, rdq->buf, sizeof(*buf) * (len - first));
+	}
+
+	free(rdq->buf);
+	rdq->buf = buf;
+	rdq->cap = cap;
+	rdq->head = 0;
+	return (1);
+}
+
+/**
+ * rdq_new - allocate and initialise memory for a growable `ring_deque`.
+ *
+ * Return: pointer to the new deque.
+ */
+ring_deque *rdq_new(void) { return (calloc(1, sizeof(ring_deque))); }
+
+/**
+ * rdq_new_fixed - allocate a `ring_deque` that never reallocates.
+ * @capacity: most elements the deque may hold, must not be 0.
+ *
+ * All memory is allocated here, pushes onto a full deque fail instead of
+ * growing it.
+ *
+ * Return: pointer to the new deque, NULL on failure.
+ */
+ring_deque *rdq_new_fixed(const size_t capacity)
+{
+	if (capacity < 1)
+		return (NULL);
+
+	ring_deque *const rdq = rdq_new();
+
+	if (!rdq)
+		return (NULL);
+
+	if (!rdq_reserve(rdq, capacity))
+		return (rdq_del(rdq, NULL));
+
+	rdq->max_len = capacity;
+	return (rdq);
+}
+
+/**
+ * rdq_reserve - make room for a number of elements in a `ring_deque`.
+ * @rdq: the `ring_deque`.
+ * @n: number of elements the deque should hold without reallocating.
+ *
+ * Return: 1 on success, 0 on failure or if `n` exceeds a fixed capacity.
+ */
+int rdq_reserve(ring_deque *const restrict rdq, const size_t n)
+{
+	if (!rdq || (rdq->max_len && n > rdq->max_len))
+		return (0);
+
+	if (n <= rdq->cap)
+		return (1);
+
+	size_t cap = RDQ_CAP_MIN;
+
+	while (cap < n)
+	{
+		if (cap > SIZE_MAX / sizeof(void *) / 2)
+			return (0);
+
+		cap <<= 1;
+	}
+
+	return (rdq_resize(rdq, cap));
+}
+
+/**
+ * rdq_clear - remove all the elements of a `ring_deque`.
+ * @rdq: the `ring_deque` to operate on.
+ * @free_data: pointer to a function that will be called to free the data.
+ *
+ * The buffer is kept for reuse.
+ */
+void rdq_clear(ring_deque *const restrict rdq, free_func *free_data)
+{
+	if (!rdq)
+		return;
+
+	for (intmax_t i = 0; free_data && i < rdq->len; ++i)
+		free_data(*rdq_slot(rdq, (size_t)i));
+
+	rdq->len = 0;
+	rdq->head = 0;
+}
+
+/**
+ * rdq_del - free a `ring_deque` from memory.
+ * @rdq: pointer to the `ring_deque` to delete.
+ * @free_data: pointer to a function that can free data in the deque.
+ *
+ * Return: NULL always.
+ */
+void *rdq_del(ring_deque *const restrict rdq, free_func *free_data)
+{
+	if (!rdq)
+		return (NULL);
+
+	rdq_clear(rdq, free_data);
+	free(rdq->buf);
+	free(rdq);
+	return (NULL);
+}
+
+/**
+ * rdq_push_head - add an element to the head of a `ring_deque`.
+ * @rdq: the `ring_deque` to operate on.
+ * @data: data of the element.
+ * @copy_data: function that returns a separate copy of data,
+ * if NULL a simple copy of the pointer to data is done.
+ *
+ * Return: pointer to the element's slot, valid until the deque is next
+ * modified, NULL on failure.
+ */
+void **rdq_push_head(
+	ring_deque *const restrict rdq, void *const data, dup_func *copy_data
+)
+{
+	if (!rdq || !rdq_reserve(rdq, (size_t)rdq->len + 1))
+		return (NULL);
+
+	void *const d = copy_data ? copy_data(data) : data;
+
+	if (!d && data)
+		return (NULL);
+
+	rdq->head = (rdq->head - 1) & (rdq->cap - 1);
+	++(rdq->len);
+	*rdq_slot(rdq, 0) = d;
+	return (rdq_slot(rdq, 0));
+}
+
+/**
+ * rdq_push_tail - add an element to the tail of a `ring_deque`.
+ * @rdq: the `ring_deque` to operate on.
+ * @data: data of the element.
+ * @copy_data: function that returns a separate copy of data,
+ * if NULL a simple copy of the pointer to data is done.
+ *
+ * Return: pointer to the element's slot, valid until the deque is next
+ * modified, NULL on failure.
+ */
+void **rdq_push_tail(
+	ring_deque *const restrict rdq, void *const data, dup_func *copy_data
+)
+{
+	if (!rdq || !rdq_reserve(rdq, (size_t)rdq->len + 1))
+		return (NULL);
+
+	void *const d = copy_data ? copy_data(data) : data;
+
+	if (!d && data)
+		return (NULL);
+
+	void **const slot = rdq_slot(rdq, (size_t)rdq->len);
+
+	*slot = d;
+	++(rdq->len);
+	return (slot);
+}
+
+/**
+ * rdq_pop_head - pop the head element of a `ring_deque`.
+ * @rdq: the `ring_deque` to operate on.
+ *
+ * Return: the data of the popped element, NULL if the deque is empty.
+ */
+void *rdq_pop_head(ring_deque *const restrict rdq)
+{
+	if (!rdq || rdq->len < 1)
+		return (NULL);
+
+	void *const d = *rdq_slot(rdq, 0);
+
+	rdq->head = (rdq->head + 1) & (rdq->cap - 1);
+	--(rdq->len);
+	return (d);
+}
+
+/**
+ * rdq_pop_tail - pop the tail element of a `ring_deque`.
+ * @rdq: the `ring_deque` to operate on.
+ *
+ * Return: the data of the popped element, NULL if the deque is empty.
+ */
+void *rdq_pop_tail(ring_deque *const restrict rdq)
+{
+	if (!rdq || rdq->len < 1)
+		return (NULL);
+
+	--(rdq->len);
+	return (*rdq_slot(rdq, (size_t)rdq->len));
+}
+
+/**
+ * rdq_get - get the data of an element of a `ring_deque` in O(1).
+ * @rdq: the `ring_deque`.
+ * @i: index of the element from the head, negative indices count back from
+ * the tail with -1 being the tail.
+ *
+ * Return: the data of the element, NULL if the index is out of range.
+ */
+void *rdq_get(const ring_deque *const restrict rdq, const intmax_t i)
+{
+	if (!rdq || i >= rdq->len || i < -rdq->len)
+		return (NULL);
+
+	return (*rdq_slot(rdq, (size_t)(i < 0 ? rdq->len + i : i)));
+}
+
+/**
+ * rdq_to_array - create an array from a `ring_deque`.
+ * @rdq: the `ring_deque`.
+ * @copy_data: optional pointer to a function that will be used to duplicate
+ * the data, if not provided, array will contain pointers to the original data
+ * in the deque.
+ * @free_data: optional pointer to a function that will be used to free data in
+ * the array in case of failure. If `copy_data` is provided this function must
+ * also be provided, otherwise no data duplication will occur.
+ *
+ * Return: pointer to a NULL terminated data array on success, NULL on
+ * failure.
+ */
+void **rdq_to_array(
+	const ring_deque *const restrict rdq, dup_func *copy_data,
+	free_func *free_data
+)
+{
+	if (!rdq || rdq->len < 1)
+		return (NULL);
+
+	const size_t len = (size_t)rdq->len;
+	const size_t first =
+		rdq->cap - rdq->head < len ? rdq->cap - rdq->head : len;
+	void **const restrict data_array = malloc(sizeof(*data_array) * (len + 1));
+
+	if (!data_array)
+		return (NULL);
+
+	memcpy(data_array, rdq->buf + rdq->head, sizeof(*data_array) * first);
+	memcpy(data_array + first, rdq->buf, sizeof(*data_array) * (len - first));
+	data_array[len] = NULL;
+	if (!copy_data || !free_data)
+		return (data_array);
+
+	for (size_t d_i = 0; d_i < len; ++d_i)
+	{
+		void *const data = data_array[d_i];
+
+		data_array[d_i] = copy_data(data);
+		if (!data_array[d_i] && data)
+		{
+			if (d_i < 1)
+			{
+				free(data_array);
+				return (NULL);
+			}
+
+			return (delete_2D_array(data_array, d_i, free_data));
+		}
+	}
+
+	return (data_array);
+}
@@ -0,0 +1,41 @@
+#ifndef DS_RING_DEQUE_TYPE_H
+#define DS_RING_DEQUE_TYPE_H
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* intmax_t */
+
+#include "attribute_macros.h"
+#include "list_type_typedefs.h"
+
+/* alloc and free */
+
+void *rdq_del(ring_deque *const restrict rdq, free_func *free_data);
+ring_deque *rdq_new(void) ATTR_MALLOC ATTR_MALLOC_FREE(rdq_del);
+ring_deque *
+rdq_new_fixed(const size_t capacity) ATTR_MALLOC ATTR_MALLOC_FREE(rdq_del);
+int rdq_reserve(ring_deque *const restrict rdq, const size_t n);
+
+/* manipulate */
+
+void **rdq_push_head(
+	ring_deque *const restrict rdq, void *const data, dup_func *copy_data
+);
+void **rdq_push_tail(
+	ring_deque *const restrict rdq, void *const data, dup_func *copy_data
+);
+void *rdq_pop_head(ring_deque *const restrict rdq);
+void *rdq_pop_tail(ring_deque *const restrict rdq);
+void rdq_clear(ring_deque *const restrict rdq, free_func *free_data);
+
+/* access */
+
+void *rdq_get(const ring_deque *const restrict rdq, const intmax_t i);
+
+/* array conversion */
+
+void **rdq_to_array(
+	const ring_deque *const restrict rdq, dup_func *copy_data,
+	free_func *free_data
+);
+
+#endif /* DS_RING_DEQUE_TYPE_H */
@@ -0,0 +1,249 @@
+#include <stdlib.h> /* *alloc */
+#include <string.h> /* memcpy */
+
+#include "list_type_structs.h"
+#include "spsc_queue.h"
+
+/**
+ * spscq_new - allocate a `spsc_queue`.
+ * @capacity: number of elements the queue must hold, rounded up to a power
+ * of 2.
+ *
+ * Return: pointer to the new queue, NULL on failure.
+ */
+spsc_queue *spscq_new(const size_t capacity)
+{
+	size_t slots = 1;
+
+	if (capacity < 1)
+		return (NULL);
+
+	while (slots < capacity)
+	{
+		if (slots > SIZE_MAX / sizeof(void *) / 2)
+			return (NULL);
+
+		slots <<= 1;
+	}
+
+	spsc_queue *const q = aligned_alloc(LT_CACHE_LINE, sizeof(*q));
+
+	if (!q)
+		return (NULL);
+
+	q->buf = malloc(sizeof(*q->buf) * slots);
+	if (!q->buf)
+	{
+		free(q);
+		return (NULL);
+	}
+
+	atomic_init(&q->head, 0);
+	atomic_init(&q->tail, 0);
+	q->tail_cache = 0;
+	q->head_cache = 0;
+	q->mask = slots - 1;
+	return (q);
+}
+
+/**
+ * spscq_del - free a `spsc_queue`, no thread may be using it.
+ * @q: the queue.
+ * @free_data: optional function that will be called on queued data.
+ *
+ * Return: NULL always.
+ */
+void *spscq_del(spsc_queue *const restrict q, free_func *free_data)
+{
+	if (!q)
+		return (NULL);
+
+	void *data = NULL;
+
+	while (free_data && spscq_pop(q, &data))
+		free_data(data);
+
+	free(q->buf);
+	free(q);
+	return (NULL);
+}
+
+/**
+ * spscq_space - number of free slots as seen by the producer.
+ * @q: the queue.
+ * @tail: the producer's index.
+ * @want: number of slots the producer would like.
+ *
+ * Return: number of free slots.
+ */
+static size_t spscq_space(
+	spsc_queue *const restrict q, const size_t tail, const size_t want
+)
+{
+	size_t space = q->mask + 1 - (tail - q->head_cache);
+
+	if (space < want)
+	{
+		q->head_cache = atomic_load_explicit(&q->head, memory_order_acquire);
+		space = q->mask + 1 - (tail - q->head_cache);
+	}
+
+	return (space);
+}
+
+/**
+ * spscq_ready - number of queued elements as seen by the consumer.
+ * @q: the queue.
+ * @head: the consumer's index.
+ * @want: number of elements the consumer would like.
+ *
+ * Return: number of queued elements.
+ */
+static size_t spscq_ready(
+	spsc_queue *const restrict q, const size_t head, const size_t want
+)
+{
+	size_t ready = q->tail_cache - head;
+
+	if (ready < want)
+	{
+		q->tail_cache = atomic_load_explicit(&q->tail, memory_order_acquire);
+		ready = q->tail_cache - head;
+	}
+
+	return (ready);
+}
+
+/**
+ * spscq_push - add an element, to be called by the producer only.
+ * @q: the queue.
+ * @data: the element.
+ *
+ * Return: 1 on success, 0 if the queue is full.
+ */
+int spscq_push(spsc_queue *const restrict q, void *const data)
+{
+	if (!q)
+		return (0);
+
+	const size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+	if (spscq_space(q, tail, 1) < 1)
+		return (0);
+
+	q->buf[tail & q->mask] = data;
+	atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+	return (1);
+}
+
+/**
+ * spscq_push_n - add several elements at once, to be called by the producer
+ * only.
+ * @q: the queue.
+ * @data: the elements.
+ * @n: number of elements in `data`.
+ *
+ * The elements are published with a single store, so the consumer sees all
+ * of them at once.
+ *
+ * Return: number of elements added, less than `n` if the queue filled up.
+ */
+size_t spscq_push_n(
+	spsc_queue *const restrict q, void *const *const restrict data,
+	const size_t n
+)
+{
+	if (!q || !data)
+		return (0);
+
+	const size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+	const size_t space = spscq_space(q, tail, n);
+	const size_t count = n < space ? n : space;
+	const size_t start = tail & q->mask;
+	const size_t first = q->mask + 1 - start < count ? q->mask + 1 - start
+													  : count;
+
+	memcpy(q->buf + start, data, sizeof(*data) * first);
+	memcpy(q->buf, data + first, sizeof(*data) * (count - first));
+	atomic_store_explicit(&q->tail, tail + count, memory_order_release);
+	return (count);
+}
+
+/**
+ * spscq_pop - remove an element, to be called by the consumer only.
+ * @q: the queue.
+ * @data: out parameter for the element.
+ *
+ * Return: 1 on success, 0 if the queue is empty.
+ */
+int spscq_pop(spsc_queue *const restrict q, void **const restrict data)
+{
+	if (!q || !data)
+		return (0);
+
+	const size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+	if (spscq_ready(q, head, 1) < 1)
+		return (0);
+
+	*data = q->buf[head & q->mask];
+	atomic_store_explicit(&q->head, head + 1, memory_order_release);
+	return (1);
+}
+
+/**
+ * spscq_pop_n - remove several elements at once, to be called by the consumer
+ * only.
+ * @q: the queue.
+ * @data: array receiving the elements.
+ * @n: size of `data`.
+ *
+ * Return: number of elements removed.
+ */
+size_t spscq_pop_n(
+	spsc_queue *const restrict q, void **const restrict data, const size_t n
+)
+{
+	if (!q || !data)
+		return (0);
+
+	const size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+	const size_t ready = spscq_ready(q, head, n);
+	const size_t count = n < ready ? n : ready;
+	const size_t start = head & q->mask;
+	const size_t first = q->mask + 1 - start < count ? q->mask + 1 - start
+													  : count;
+
+	memcpy(data, q->buf + start, sizeof(*data) * first);
+	memcpy(data + first, q->buf, sizeof(*data) * (count - first));
+	atomic_store_explicit(&q->head, head + count, memory_order_release);
+	return (count);
+}
+
+/**
+ * spscq_len - number of elements in a `spsc_queue`.
+ * @q: the queue.
+ *
+ * Return: the number of elements, only a snapshot while both sides run.
+ */
+size_t spscq_len(const spsc_queue *const restrict q)
+{
+	if (!q)
+		return (0);
+
+	const size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+	const size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+	return (tail - head);
+}
+
+/**
+ * spscq_capacity - number of elements a `spsc_queue` can hold.
+ * @q: the queue.
+ *
+ * Return: the capacity.
+ */
+size_t spscq_capacity(const spsc_queue *const restrict q)
+{
+	return (q ? q->mask + 1 : 0);
+}
@@ -0,0 +1,35 @@
+#ifndef DS_SPSC_QUEUE_TYPE_H
+#define DS_SPSC_QUEUE_TYPE_H
+
+#include <stddef.h> /* size_t */
+
+#include "attribute_macros.h"
+#include "list_type_typedefs.h"
+
+/* alloc and free */
+
+void *spscq_del(spsc_queue *const restrict q, free_func *free_data);
+spsc_queue *
+spscq_new(const size_t capacity) ATTR_MALLOC ATTR_MALLOC_FREE(spscq_del);
+
+/* producer */
+
+int spscq_push(spsc_queue *const restrict q, void *const data);
+size_t spscq_push_n(
+	spsc_queue *const restrict q, void *const *const restrict data,
+	const size_t n
+);
+
+/* consumer */
+
+int spscq_pop(spsc_queue *const restrict q, void **const restrict data);
+size_t spscq_pop_n(
+	spsc_queue *const restrict q, void **const restrict data, const size_t n
+);
+
+/* either side */
+
+size_t spscq_len(const spsc_queue *const restrict q);
+size_t spscq_capacity(const spsc_queue *const restrict q);
+
+#endif /* DS_SPSC_QUEUE_TYPE_H */
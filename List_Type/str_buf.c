@@ -0,0 +1,195 @@
+/* vsnprintf */
+#define _ISOC99_SOURCE
+
+#include <stdarg.h> /* va_list */
+#include <stdint.h> /* SIZE_MAX */
+#include <stdio.h>  /* vsnprintf, vfprintf, fwrite */
+#include <stdlib.h> /* *alloc */
+#include <string.h> /* memcpy, strlen */
+
+#include "list_type_structs.h"
+#include "str_buf.h"
+
+/* Smallest allocation made for a string built in memory. */
+#define STRBUF_MIN_CAP ((size_t)64)
+
+/**
+ * strbuf_init - initialise an empty `str_buf`.
+ * @sb: the buffer.
+ * @stream: stream to write to, NULL to build the string in memory.
+ */
+void strbuf_init(str_buf *const restrict sb, FILE *const stream)
+{
+	if (sb)
+		*sb = (str_buf){.stream = stream};
+}
+
+/**
+ * strbuf_free - free the memory of a `str_buf` and reset it.
+ * @sb: the buffer, the stream it writes to is left open.
+ */
+void strbuf_free(str_buf *const restrict sb)
+{
+	if (!sb)
+		return;
+
+	free(sb->str);
+	strbuf_init(sb, sb->stream);
+}
+
+/**
+ * strbuf_release - take the string built by a `str_buf` and reset it.
+ * @sb: the buffer.
+ *
+ * Return: pointer to the NUL terminated string, to be freed by the caller,
+ * NULL if a write failed or the buffer writes to a stream.
+ */
+char *strbuf_release(str_buf *const restrict sb)
+{
+	if (!sb || sb->stream || sb->failed || !strbuf_reserve(sb, 0))
+	{
+		strbuf_free(sb);
+		return (NULL);
+	}
+
+	char *const str = sb->str;
+
+	strbuf_init(sb, NULL);
+	return (str);
+}
+
+/**
+ * strbuf_reserve - make room for more bytes in a `str_buf`.
+ * @sb: the buffer.
+ * @n: number of bytes that will be written, the terminating NUL is
+ * accounted for.
+ *
+ * The allocation at least doubles when it grows, so building a string of
+ * `len` bytes costs O(len) whatever the size of the pieces.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int strbuf_reserve(str_buf *const restrict sb, const size_t n)
+{
+	if (!sb || sb->failed)
+		return (0);
+
+	if (sb->stream || (sb->str && sb->cap - sb->len > n))
+		return (1);
+
+	if (n > SIZE_MAX - sb->len - 1)
+	{
+		sb->failed = 1;
+		return (0);
+	}
+
+	size_t cap = sb->cap > STRBUF_MIN_CAP ? sb->cap : STRBUF_MIN_CAP;
+
+	while (cap < sb->len + n + 1)
+		cap = cap > SIZE_MAX / 2 ? sb->len + n + 1 : cap * 2;
+
+	char *const str = realloc(sb->str, cap);
+
+	if (!str)
+	{
+		sb->failed = 1;
+		return (0);
+	}
+
+	if (!sb->str)
+		str[0] = '\0';
+
+	sb->str = str;
+	sb->cap = cap;
+	return (1);
+}
+
+/**
+ * strbuf_write - append bytes to a `str_buf`.
+ * @sb: the buffer.
+ * @s: the bytes.
+ * @n: number of bytes.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int strbuf_write(
+	str_buf *const restrict sb, const char *const restrict s, const size_t n
+)
+{
+	if (!s || !strbuf_reserve(sb, n))
+		return (0);
+
+	if (sb->stream)
+	{
+		if (fwrite(s, 1, n, sb->stream) != n)
+		{
+			sb->failed = 1;
+			return (0);
+		}
+	}
+	else
+	{
+		memcpy(sb->str + sb->len, s, n);
+		sb->str[sb->len + n] = '\0';
+	}
+
+	sb->len += n;
+	return (1);
+}
+
+/**
+ * strbuf_puts - append a string to a `str_buf`.
+ * @sb: the buffer.
+ * @s: the NUL terminated string.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int strbuf_puts(str_buf *const restrict sb, const char *const restrict s)
+{
+	return (s ? strbuf_write(sb, s, strlen(s)) : 0);
+}
+
+/**
+ * strbuf_printf - append printf style formatted text to a `str_buf`.
+ * @sb: the buffer.
+ * @fmt: pointer to a string with format specifiers.
+ *
+ * In memory the text is formatted straight into the spare capacity, and only
+ * formatted a second time if it did not fit.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+int strbuf_printf(str_buf *const restrict sb, const char *const restrict fmt, ...)
+{
+	if (!fmt || !strbuf_reserve(sb, 0))
+		return (0);
+
+	int size = 0;
+	va_list vars;
+
+	va_start(vars, fmt);
+	if (sb->stream)
+		size = vfprintf(sb->stream, fmt, vars);
+	else
+		size = vsnprintf(sb->str + sb->len, sb->cap - sb->len, fmt, vars);
+
+	va_end(vars);
+	if (size >= 0 && !sb->stream && (size_t)size >= sb->cap - sb->len)
+	{
+		if (!strbuf_reserve(sb, (size_t)size))
+			return (0);
+
+		va_start(vars, fmt);
+		size = vsnprintf(sb->str + sb->len, sb->cap - sb->len, fmt, vars);
+		va_end(vars);
+	}
+
+	if (size < 0)
+	{
+		sb->failed = 1;
+		return (0);
+	}
+
+	sb->len += (size_t)size;
+	return (1);
+}
@@ -0,0 +1,26 @@
+#ifndef DS_STR_BUF_TYPE_H
+#define DS_STR_BUF_TYPE_H
+
+#include <stddef.h> /* size_t */
+#include <stdio.h>  /* FILE */
+
+#include "attribute_macros.h"
+#include "list_type_typedefs.h"
+
+/* init and free */
+
+void strbuf_init(str_buf *const restrict sb, FILE *const stream);
+void strbuf_free(str_buf *const restrict sb);
+char *strbuf_release(str_buf *const restrict sb) ATTR_MALLOC;
+int strbuf_reserve(str_buf *const restrict sb, const size_t n);
+
+/* write */
+
+int strbuf_write(
+	str_buf *const restrict sb, const char *const restrict s, const size_t n
+);
+int strbuf_puts(str_buf *const restrict sb, const char *const restrict s);
+int strbuf_printf(str_buf *const restrict sb, const char *const restrict fmt, ...)
+	ATTR_FORMAT(printf, 2, 3);
+
+#endif /* DS_STR_BUF_TYPE_H */
@@ -0,0 +1,188 @@
+#include <stdlib.h> /* free */
+
+#include "block_deque.h"
+#include "list_type_structs.h"
+#include "tau/tau.h"
+
+#define MANY_ITEMS ((intmax_t)(BDQ_BLOCK_LEN * 5 + 3))
+
+static char n1d[] = "one", n2d[] = "two", n3d[] = "three";
+static int numbers[MANY_ITEMS];
+
+/**
+ * fail_dup - failing duplicating function.
+ * @d: unused.
+ *
+ * Return: NULL.
+ */
+static void *fail_dup(void const *const d)
+{
+	(void)d;
+	return (NULL);
+}
+
+/**
+ * dup_int - make a copy of an int.
+ * @num: pointer to the int.
+ *
+ * Return: pointer to a new int.
+ */
+static void *dup_int(void const *const num)
+{
+	int *const n = malloc(sizeof(*n));
+
+	if (n)
+		*n = *(int const *)num;
+
+	return (n);
+}
+
+TAU_MAIN()
+
+TEST(block_deque_creation, new_returns_empty_bdq)
+{
+	block_deque *const bdq = bdq_new();
+
+	REQUIRE(bdq, "bdq_new() returns non-null");
+	CHECK(bdq->len == 0);
+	CHECK(bdq->map == NULL);
+	CHECK(bdq_pop_head(bdq) == NULL);
+	CHECK(bdq_pop_tail(bdq) == NULL);
+	CHECK(bdq_get(bdq, 0) == NULL);
+	bdq_del(bdq, NULL);
+}
+
+TEST(block_deque_creation, null_bdq_is_rejected)
+{
+	CHECK(bdq_push_head(NULL, n1d, NULL) == NULL);
+	CHECK(bdq_push_tail(NULL, n1d, NULL) == NULL);
+	CHECK(bdq_pop_head(NULL) == NULL);
+	CHECK(bdq_pop_tail(NULL) == NULL);
+	CHECK(bdq_get(NULL, 0) == NULL);
+	CHECK(bdq_del(NULL, NULL) == NULL);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+struct block_ops
+{
+	block_deque *bdq;
+};
+
+TEST_F_SETUP(block_ops)
+{
+	tau->bdq = bdq_new();
+	REQUIRE(tau->bdq, "bdq_new() returns non-null");
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		numbers[i] = (int)i;
+}
+
+TEST_F_TEARDOWN(block_ops) { tau->bdq = bdq_del(tau->bdq, NULL); }
+
+TEST_F(block_ops, push_both_ends_keeps_order)
+{
+	REQUIRE(bdq_push_tail(tau->bdq, n2d, NULL));
+	REQUIRE(bdq_push_head(tau->bdq, n1d, NULL));
+	REQUIRE(bdq_push_tail(tau->bdq, n3d, NULL));
+
+	CHECK(tau->bdq->len == 3);
+	CHECK_PTR_EQ(bdq_get(tau->bdq, 0), n1d);
+	CHECK_PTR_EQ(bdq_get(tau->bdq, 1), n2d);
+	CHECK_PTR_EQ(bdq_get(tau->bdq, 2), n3d);
+	CHECK_PTR_EQ(bdq_get(tau->bdq, -1), n3d);
+	CHECK_PTR_EQ(bdq_get(tau->bdq, -3), n1d);
+	CHECK(bdq_get(tau->bdq, 3) == NULL);
+	CHECK(bdq_get(tau->bdq, -4) == NULL);
+	CHECK_PTR_EQ(bdq_pop_head(tau->bdq), n1d);
+	CHECK_PTR_EQ(bdq_pop_tail(tau->bdq), n3d);
+	CHECK_PTR_EQ(bdq_pop_tail(tau->bdq), n2d);
+	CHECK(tau->bdq->len == 0);
+}
+
+TEST_F(block_ops, push_tail_across_blocks)
+{
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		REQUIRE(bdq_push_tail(tau->bdq, &numbers[i], NULL));
+
+	REQUIRE(tau->bdq->len == MANY_ITEMS);
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		CHECK_PTR_EQ(bdq_get(tau->bdq, i), &numbers[i]);
+
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		CHECK_PTR_EQ(bdq_pop_head(tau->bdq), &numbers[i]);
+
+	CHECK(tau->bdq->len == 0);
+}
+
+TEST_F(block_ops, push_head_across_blocks)
+{
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		REQUIRE(bdq_push_head(tau->bdq, &numbers[i], NULL));
+
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		CHECK_PTR_EQ(bdq_get(tau->bdq, -1 - i), &numbers[i]);
+
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		CHECK_PTR_EQ(bdq_pop_tail(tau->bdq), &numbers[i]);
+
+	CHECK(tau->bdq->len == 0);
+}
+
+TEST_F(block_ops, slots_do_not_move)
+{
+	void **const first = bdq_push_tail(tau->bdq, n1d, NULL);
+
+	REQUIRE(first);
+	for (intmax_t i = 0; i < MANY_ITEMS * 4; ++i)
+	{
+		REQUIRE(bdq_push_tail(tau->bdq, n2d, NULL));
+		REQUIRE(bdq_push_head(tau->bdq, n3d, NULL));
+	}
+
+	CHECK_PTR_EQ(*first, n1d);
+	CHECK_PTR_EQ(bdq_get(tau->bdq, MANY_ITEMS * 4), n1d);
+}
+
+TEST_F(block_ops, queue_wraps_without_growing)
+{
+	for (intmax_t i = 0; i < MANY_ITEMS * 20; ++i)
+	{
+		REQUIRE(bdq_push_tail(tau->bdq, &numbers[i % MANY_ITEMS], NULL));
+		if (i >= 10)
+			CHECK_PTR_EQ(
+				bdq_pop_head(tau->bdq), &numbers[(i - 10) % MANY_ITEMS]
+			);
+	}
+
+	CHECK(tau->bdq->len == 10);
+	CHECK(tau->bdq->map_len == 8);
+}
+
+TEST_F(block_ops, failed_copy_leaves_bdq_unchanged)
+{
+	CHECK(bdq_push_tail(tau->bdq, n1d, fail_dup) == NULL);
+	CHECK(bdq_push_head(tau->bdq, n1d, fail_dup) == NULL);
+	CHECK(tau->bdq->len == 0);
+	REQUIRE(bdq_push_tail(tau->bdq, n2d, NULL));
+	CHECK(bdq_push_head(tau->bdq, n1d, fail_dup) == NULL);
+	CHECK(tau->bdq->len == 1);
+	CHECK_PTR_EQ(bdq_get(tau->bdq, 0), n2d);
+}
+
+TEST_F(block_ops, clear_frees_copies)
+{
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		REQUIRE(bdq_push_tail(tau->bdq, &numbers[i], dup_int));
+
+	CHECK(*(int *)bdq_get(tau->bdq, 7) == 7);
+	bdq_clear(tau->bdq, free);
+	CHECK(tau->bdq->len == 0);
+	CHECK(bdq_get(tau->bdq, 0) == NULL);
+	REQUIRE(bdq_push_head(tau->bdq, &numbers[1], dup_int));
+
+	int *const n = bdq_pop_tail(tau->bdq);
+
+	CHECK(n && *n == 1);
+	free(n);
+}
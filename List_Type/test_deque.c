@@ -3,6 +3,8 @@
 #include "deque.h"
 #include "list_node.h"
 #include "list_type_structs.h"
+#include "node_pool.h"
+#include "str_buf.h"
 #include "tau/tau.h"
 
 #define MAX_STRING_LENGTH 256U
@@ -837,3 +839,695 @@ TEST(dqfa, deque_from_array)
 
 	dq = dq_del(dq, NULL);
 }
+
+TEST(dqfa, nodes_are_contiguous_in_list_order)
+{
+	long long int arr[] = {1, 2, 3, 4, 5};
+	const intmax_t arr_len = (sizeof(arr) / sizeof(*arr));
+	deque *dq = dq_from_array(arr, arr_len, sizeof(*arr), dup_llint, free);
+
+	REQUIRE(dq, "dq_from_array() should return non-null pointer");
+	REQUIRE(dq->pool && dq->owns_pool);
+	for (intmax_t i = 0; i < arr_len; ++i)
+	{
+		list_node *const node = dq->head + i;
+
+		CHECK(*(long long int *)node->data == arr[i]);
+		CHECK(node->next == (i < arr_len - 1 ? node + 1 : NULL));
+	}
+
+	CHECK(dq->tail == dq->head + arr_len - 1);
+	REQUIRE(dq_push_tail(dq, &arr[0], dup_llint));
+	CHECK(dq->len == arr_len + 1);
+	CHECK(dq->pool->n_free == NDPOOL_SLAB_LEN - (size_t)arr_len - 1);
+	dq = dq_del(dq, free);
+}
+
+TEST(dqfa, later_pushes_use_default_slabs)
+{
+	static int many[NDPOOL_SLAB_LEN * 4];
+	deque *dq = dq_from_array(
+		many, NDPOOL_SLAB_LEN * 4, sizeof(*many), NULL, NULL
+	);
+
+	REQUIRE(dq, "dq_from_array() should return non-null pointer");
+	CHECK(dq->pool->n_free == 0);
+	REQUIRE(dq_push_tail(dq, n1d, NULL));
+	CHECK(dq->pool->n_free == NDPOOL_SLAB_LEN - 1);
+	dq = dq_del(dq, NULL);
+}
+
+TEST(dqfa, set_pool_frees_own_pool)
+{
+	long long int arr[] = {1, 2, 3};
+	deque *dq = dq_from_array(arr, 3, sizeof(*arr), NULL, NULL);
+
+	REQUIRE(dq, "dq_from_array() should return non-null pointer");
+	dq_clear(dq, NULL);
+	REQUIRE(dq_set_pool(dq, NULL));
+	CHECK(dq->pool == NULL);
+	CHECK(dq->owns_pool == 0);
+	REQUIRE(dq_push_head(dq, &arr[1], NULL));
+	CHECK_PTR_EQ(dq_pop_tail(dq), &arr[1]);
+	dq = dq_del(dq, NULL);
+}
+
+TEST(dqta, to_array_into_fills_caller_buffer)
+{
+	deque *dq = dq_new();
+	void *buf[4] = {NULL};
+
+	REQUIRE(dq, "dq_new() should return non-null pointer");
+	CHECK(dq_to_array_into(dq, buf, 4) == 0);
+	REQUIRE(dq_push_tail(dq, n1d, NULL));
+	REQUIRE(dq_push_tail(dq, n2d, NULL));
+	REQUIRE(dq_push_tail(dq, n3d, NULL));
+	CHECK(dq_to_array_into(NULL, buf, 4) == 0);
+	CHECK(dq_to_array_into(dq, NULL, 4) == 0);
+	CHECK(dq_to_array_into(dq, buf, 2) == 2);
+	CHECK(buf[2] == NULL);
+	CHECK(dq_to_array_into(dq, buf, 4) == 3);
+	CHECK_PTR_EQ(buf[0], n1d);
+	CHECK_PTR_EQ(buf[1], n2d);
+	CHECK_PTR_EQ(buf[2], n3d);
+	CHECK(buf[3] == NULL);
+	dq = dq_del(dq, NULL);
+}
+
+TEST(dqta, to_flat_array_packs_records)
+{
+	long long int arr[] = {1, 2, 3, 4, 5};
+	const intmax_t arr_len = (sizeof(arr) / sizeof(*arr));
+	deque *dq = dq_from_array(arr, arr_len, sizeof(*arr), NULL, NULL);
+
+	REQUIRE(dq, "dq_from_array() should return non-null pointer");
+	CHECK(dq_to_flat_array(dq, 0) == NULL);
+	CHECK(dq_to_flat_array(NULL, sizeof(*arr)) == NULL);
+	REQUIRE(dq_push_head(dq, NULL, NULL));
+
+	long long int *const flat = dq_to_flat_array(dq, sizeof(*arr));
+
+	REQUIRE(flat);
+	CHECK(flat[0] == 0);
+	for (intmax_t i = 0; i < arr_len; ++i)
+		CHECK(flat[i + 1] == arr[i]);
+
+	free(flat);
+	dq_clear(dq, NULL);
+	CHECK(dq_to_flat_array(dq, sizeof(*arr)) == NULL);
+	dq = dq_del(dq, NULL);
+}
+
+/* ###################################################################### */
+/* ############################## pooled ################################ */
+/* ###################################################################### */
+
+struct pooled_deque
+{
+	node_pool *pool;
+	deque *dq;
+};
+
+TEST_F_SETUP(pooled_deque)
+{
+	tau->pool = ndpool_new(2);
+	tau->dq = dq_new();
+	REQUIRE(tau->pool && tau->dq);
+	REQUIRE(dq_set_pool(tau->dq, tau->pool));
+}
+
+TEST_F_TEARDOWN(pooled_deque)
+{
+	tau->dq = dq_del(tau->dq, NULL);
+	tau->pool = ndpool_del(tau->pool);
+}
+
+TEST_F(pooled_deque, set_pool_needs_empty_deque)
+{
+	CHECK(dq_set_pool(NULL, tau->pool) == 0);
+	REQUIRE(dq_push_tail(tau->dq, n1d, NULL));
+	CHECK(dq_set_pool(tau->dq, NULL) == 0);
+	CHECK_PTR_EQ(tau->dq->pool, tau->pool);
+}
+
+TEST_F(pooled_deque, pop_recycles_nodes)
+{
+	list_node *const n1 = dq_push_tail(tau->dq, n1d, NULL);
+
+	REQUIRE(n1);
+	CHECK_PTR_EQ(dq_pop_head(tau->dq), n1d);
+	CHECK_PTR_EQ(dq_push_head(tau->dq, n2d, NULL), n1);
+	CHECK_PTR_EQ(dq_pop_tail(tau->dq), n2d);
+	CHECK(tau->dq->len == 0);
+	CHECK(tau->dq->head == NULL);
+	CHECK(tau->dq->tail == NULL);
+}
+
+TEST_F(pooled_deque, clear_returns_all_nodes)
+{
+	REQUIRE(dq_push_tail(tau->dq, n1d, dup_str));
+	REQUIRE(dq_push_tail(tau->dq, n2d, dup_str));
+	REQUIRE(dq_push_head(tau->dq, n3d, dup_str));
+
+	const size_t n_free = tau->pool->n_free;
+
+	dq_clear(tau->dq, free);
+	CHECK(tau->dq->len == 0);
+	CHECK(tau->dq->head == NULL);
+	CHECK(tau->dq->tail == NULL);
+	CHECK(tau->pool->n_free == n_free + 3);
+	REQUIRE(dq_push_tail(tau->dq, n1d, NULL));
+	CHECK(tau->pool->n_free == n_free + 2);
+}
+
+TEST_F(pooled_deque, pool_is_shared_between_deques)
+{
+	deque *const other = dq_new();
+
+	REQUIRE(other);
+	REQUIRE(dq_set_pool(other, tau->pool));
+	REQUIRE(dq_push_tail(tau->dq, n1d, NULL));
+	REQUIRE(dq_push_tail(other, n2d, NULL));
+	REQUIRE(dq_push_tail(other, n3d, NULL));
+	CHECK_PTR_EQ(dq_pop_head(other), n2d);
+	CHECK_PTR_EQ(dq_pop_head(tau->dq), n1d);
+	CHECK_PTR_EQ(dq_pop_head(other), n3d);
+	dq_del(other, NULL);
+}
+
+/* ###################################################################### */
+/* ############################### bulk ################################# */
+/* ###################################################################### */
+
+static int dups_left;
+
+/**
+ * dup_str_limited - copy strings until `dups_left` runs out.
+ * @str: pointer to the string.
+ *
+ * Return: pointer to the new string, NULL once `dups_left` is 0.
+ */
+static void *dup_str_limited(void const *const str)
+{
+	if (dups_left < 1)
+		return (NULL);
+
+	--dups_left;
+	return (dup_str(str));
+}
+
+struct bulk_items
+{
+	node_pool *pool;
+	deque *dq;
+	deque *pooled;
+};
+
+TEST_F_SETUP(bulk_items)
+{
+	tau->pool = ndpool_new(2);
+	tau->dq = dq_new();
+	tau->pooled = dq_new();
+	REQUIRE(tau->pool && tau->dq && tau->pooled);
+	REQUIRE(dq_set_pool(tau->pooled, tau->pool));
+}
+
+TEST_F_TEARDOWN(bulk_items)
+{
+	tau->dq = dq_del(tau->dq, NULL);
+	tau->pooled = dq_del(tau->pooled, NULL);
+	tau->pool = ndpool_del(tau->pool);
+}
+
+TEST_F(bulk_items, push_n_matches_single_pushes)
+{
+	void *const data[] = {n1d, n2d, n3d};
+	void *out[4] = {NULL};
+
+	REQUIRE(dq_push_tail_n(tau->dq, data, 3, NULL, NULL));
+	REQUIRE(dq_push_head_n(tau->dq, data, 2, NULL, NULL));
+	CHECK(tau->dq->len == 5);
+	CHECK(dq_pop_head_n(tau->dq, out, 2) == 2);
+	CHECK_PTR_EQ(out[0], n2d);
+	CHECK_PTR_EQ(out[1], n1d);
+	CHECK(dq_pop_head_n(tau->dq, out, 4) == 3);
+	CHECK_PTR_EQ(out[0], n1d);
+	CHECK_PTR_EQ(out[1], n2d);
+	CHECK_PTR_EQ(out[2], n3d);
+	CHECK(tau->dq->len == 0);
+	CHECK(tau->dq->head == NULL);
+	CHECK(tau->dq->tail == NULL);
+}
+
+TEST_F(bulk_items, pop_tail_n_keeps_the_rest_linked)
+{
+	void *const data[] = {n1d, n2d, n3d, n1d};
+	void *out[2] = {NULL};
+
+	REQUIRE(dq_push_tail_n(tau->dq, data, 4, NULL, NULL));
+	CHECK(dq_pop_tail_n(tau->dq, out, 2) == 2);
+	CHECK_PTR_EQ(out[0], n1d);
+	CHECK_PTR_EQ(out[1], n3d);
+	CHECK(tau->dq->len == 2);
+	CHECK_PTR_EQ(tau->dq->tail->data, n2d);
+	CHECK(tau->dq->tail->next == NULL);
+	CHECK_PTR_EQ(dq_pop_tail(tau->dq), n2d);
+	CHECK_PTR_EQ(dq_pop_tail(tau->dq), n1d);
+	CHECK(dq_pop_tail_n(tau->dq, out, 2) == 0);
+}
+
+TEST_F(bulk_items, invalid_arguments_are_rejected)
+{
+	void *const data[] = {n1d};
+	void *out[1] = {NULL};
+
+	CHECK(dq_push_tail_n(NULL, data, 1, NULL, NULL) == 0);
+	CHECK(dq_push_head_n(tau->dq, NULL, 1, NULL, NULL) == 0);
+	CHECK(dq_push_tail_n(tau->dq, data, 1, dup_str, NULL) == 0);
+	CHECK(dq_push_tail_n(tau->dq, NULL, 0, NULL, NULL) == 1);
+	CHECK(dq_pop_head_n(NULL, out, 1) == 0);
+	CHECK(dq_pop_tail_n(tau->dq, NULL, 1) == 0);
+	CHECK(tau->dq->len == 0);
+}
+
+TEST_F(bulk_items, failed_copy_leaves_deque_unchanged)
+{
+	void *const data[] = {n1d, n2d, n3d, n1d};
+
+	REQUIRE(dq_push_tail(tau->dq, n1d, NULL));
+	dups_left = 2;
+	CHECK(dq_push_tail_n(tau->dq, data, 4, dup_str_limited, free) == 0);
+	dups_left = 3;
+	CHECK(dq_push_head_n(tau->pooled, data, 4, dup_str_limited, free) == 0);
+	CHECK(tau->dq->len == 1);
+	CHECK(tau->dq->head == tau->dq->tail);
+	CHECK(tau->pooled->len == 0);
+	CHECK(tau->pool->n_free == 4);
+}
+
+TEST_F(bulk_items, pooled_push_n_reserves_once)
+{
+	void *data[8];
+	void *out[8] = {NULL};
+
+	for (int i = 0; i < 8; ++i)
+		data[i] = &data[i];
+
+	REQUIRE(dq_push_tail_n(tau->pooled, data, 8, NULL, NULL));
+	CHECK(tau->pool->n_free == 0);
+	CHECK(tau->pooled->head + 7 == tau->pooled->tail);
+	CHECK(dq_pop_tail_n(tau->pooled, out, 5) == 5);
+	CHECK(tau->pool->n_free == 5);
+	for (int i = 0; i < 5; ++i)
+		CHECK_PTR_EQ(out[i], data[7 - i]);
+
+	CHECK(dq_pop_head_n(tau->pooled, out, 8) == 3);
+	CHECK(tau->pool->n_free == 8);
+	CHECK_PTR_EQ(out[2], data[2]);
+}
+
+/* ###################################################################### */
+/* ############################### write ################################ */
+/* ###################################################################### */
+
+/**
+ * write_str - write a string to a `str_buf`.
+ * @sb: the buffer.
+ * @str: pointer to the string.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int write_str(str_buf *const sb, void const *const str)
+{
+	return (strbuf_puts(sb, str));
+}
+
+TEST(dq_write, write_both_directions)
+{
+	deque *dq = dq_new();
+	str_buf sb;
+
+	REQUIRE(dq, "dq_new() should return non-null pointer");
+	strbuf_init(&sb, NULL);
+	CHECK(dq_write(NULL, &sb, write_str) == 0);
+	CHECK(dq_write(dq, NULL, write_str) == 0);
+	REQUIRE(dq_write(dq, &sb, write_str));
+	REQUIRE(dq_push_tail(dq, n1d, NULL));
+	REQUIRE(dq_push_tail(dq, n2d, NULL));
+	REQUIRE(dq_push_tail(dq, n3d, NULL));
+	REQUIRE(strbuf_puts(&sb, "\n"));
+	REQUIRE(dq_write(dq, &sb, write_str));
+	REQUIRE(strbuf_puts(&sb, "\n"));
+	REQUIRE(dq_write_reversed(dq, &sb, write_str));
+
+	char *const out = strbuf_release(&sb);
+
+	REQUIRE(out);
+	CHECK_STREQ(
+		out, "(NULL)\none <--> two <--> three\nthree <--> two <--> one"
+	);
+	free(out);
+	dq = dq_del(dq, NULL);
+}
+
+/* ###################################################################### */
+/* ############################## indexed ############################### */
+/* ###################################################################### */
+
+#define N_INDEXED ((intmax_t)50)
+
+static intmax_t indexed[N_INDEXED];
+
+struct indexed_items
+{
+	deque *dq;
+};
+
+TEST_F_SETUP(indexed_items)
+{
+	tau->dq = dq_new();
+	REQUIRE(tau->dq);
+	for (intmax_t i = 0; i < N_INDEXED; ++i)
+	{
+		indexed[i] = i;
+		REQUIRE(dq_push_tail(tau->dq, &indexed[i], NULL));
+	}
+}
+
+TEST_F_TEARDOWN(indexed_items) { tau->dq = dq_del(tau->dq, NULL); }
+
+TEST_F(indexed_items, get_any_index)
+{
+	CHECK(dq_get(NULL, 0) == NULL);
+	CHECK(dq_get(tau->dq, N_INDEXED) == NULL);
+	CHECK(dq_get(tau->dq, -N_INDEXED - 1) == NULL);
+	CHECK_PTR_EQ(dq_get(tau->dq, -1), &indexed[N_INDEXED - 1]);
+	CHECK_PTR_EQ(dq_get(tau->dq, -N_INDEXED), &indexed[0]);
+	for (intmax_t i = 0; i < N_INDEXED; i += 7)
+		CHECK_PTR_EQ(dq_get(tau->dq, i), &indexed[i]);
+
+	for (intmax_t i = N_INDEXED - 1; i >= 0; i -= 3)
+		CHECK_PTR_EQ(dq_get(tau->dq, i), &indexed[i]);
+}
+
+TEST_F(indexed_items, sliding_window_keeps_indices_right)
+{
+	for (intmax_t i = 0; i < 10; ++i)
+	{
+		CHECK_PTR_EQ(dq_get(tau->dq, 20), &indexed[20 + i]);
+		CHECK_PTR_EQ(dq_pop_head(tau->dq), &indexed[i]);
+		REQUIRE(dq_push_tail(tau->dq, &indexed[i], NULL));
+	}
+
+	REQUIRE(dq_push_head(tau->dq, n1d, NULL));
+	CHECK_PTR_EQ(dq_get(tau->dq, 21), &indexed[30]);
+	CHECK_PTR_EQ(dq_pop_tail(tau->dq), &indexed[9]);
+	CHECK_PTR_EQ(dq_get(tau->dq, -1), &indexed[8]);
+	CHECK(dq_pop_tail(tau->dq) == &indexed[8]);
+	CHECK_PTR_EQ(dq_get(tau->dq, -1), &indexed[7]);
+}
+
+TEST_F(indexed_items, insert_and_remove_in_the_middle)
+{
+	REQUIRE(dq_insert_at(tau->dq, 10, n1d, NULL));
+	REQUIRE(dq_insert_at(tau->dq, 0, n2d, NULL));
+	REQUIRE(dq_insert_at(tau->dq, -1, n3d, NULL));
+	CHECK(dq_insert_at(tau->dq, N_INDEXED + 4, n3d, NULL) == NULL);
+	CHECK(dq_insert_at(tau->dq, 5, n3d, fail_dup) == NULL);
+	CHECK(tau->dq->len == N_INDEXED + 3);
+	CHECK_PTR_EQ(dq_get(tau->dq, 0), n2d);
+	CHECK_PTR_EQ(dq_get(tau->dq, 11), n1d);
+	CHECK_PTR_EQ(dq_get(tau->dq, 12), &indexed[10]);
+	CHECK_PTR_EQ(dq_get(tau->dq, -1), n3d);
+
+	CHECK_PTR_EQ(dq_remove_at(tau->dq, 11), n1d);
+	CHECK_PTR_EQ(dq_get(tau->dq, 11), &indexed[10]);
+	CHECK_PTR_EQ(dq_remove_at(tau->dq, 0), n2d);
+	CHECK_PTR_EQ(dq_remove_at(tau->dq, -1), n3d);
+	CHECK(dq_remove_at(tau->dq, N_INDEXED) == NULL);
+	CHECK(tau->dq->len == N_INDEXED);
+	for (intmax_t i = 0; i < N_INDEXED; ++i)
+		CHECK_PTR_EQ(dq_get(tau->dq, i), &indexed[i]);
+
+	CHECK_PTR_EQ(dq_remove_at(tau->dq, 25), &indexed[25]);
+	CHECK_PTR_EQ(dq_remove_at(tau->dq, 25), &indexed[26]);
+	CHECK_PTR_EQ(dq_get(tau->dq, 24), &indexed[24]);
+	CHECK_PTR_EQ(dq_get(tau->dq, 25), &indexed[27]);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+/**
+ * cmp_intmax_desc - compare two intmax_t in descending order.
+ * @a: pointer to the first number.
+ * @b: pointer to the second number.
+ *
+ * Return: negative if `a` is greater, positive if it is smaller, else 0.
+ */
+static int cmp_intmax_desc(void const *const a, void const *const b)
+{
+	const intmax_t x = *(intmax_t const *)a, y = *(intmax_t const *)b;
+
+	return ((x < y) - (x > y));
+}
+
+TEST_F(indexed_items, sort_relinks_nodes)
+{
+	list_node *const old_head = tau->dq->head;
+
+	CHECK_PTR_EQ(dq_get(tau->dq, 10), &indexed[10]);
+	dq_sort(tau->dq, cmp_intmax_desc);
+	CHECK(tau->dq->len == N_INDEXED);
+	CHECK(tau->dq->tail == old_head);
+	CHECK(tau->dq->head->prev == NULL);
+	CHECK(tau->dq->tail->next == NULL);
+	CHECK_PTR_EQ(dq_get(tau->dq, 10), &indexed[N_INDEXED - 11]);
+	for (intmax_t i = 0; i < N_INDEXED; ++i)
+		CHECK_PTR_EQ(dq_pop_tail(tau->dq), &indexed[i]);
+
+	dq_sort(tau->dq, cmp_intmax_desc);
+	dq_sort(NULL, cmp_intmax_desc);
+	CHECK(tau->dq->head == NULL);
+}
+
+TEST_F(indexed_items, split_and_concat_relink_nodes)
+{
+	list_node *const mid = tau->dq->head->next->next;
+	deque *const back = dq_split_at(tau->dq, mid);
+
+	REQUIRE(back);
+	CHECK(tau->dq->len == 2);
+	CHECK(back->len == N_INDEXED - 2);
+	CHECK(back->head == mid);
+	CHECK(mid->prev == NULL);
+	CHECK(tau->dq->tail->next == NULL);
+	CHECK_PTR_EQ(dq_get(tau->dq, -1), &indexed[1]);
+	CHECK_PTR_EQ(dq_get(back, 0), &indexed[2]);
+
+	deque *const last = dq_split_at(back, back->tail);
+
+	REQUIRE(last);
+	CHECK(last->len == 1);
+	CHECK(back->len == N_INDEXED - 3);
+	CHECK(dq_concat(last, back) == 1);
+	CHECK(back->len == 0 && back->head == NULL && back->tail == NULL);
+	CHECK(dq_concat(tau->dq, last) == 1);
+	CHECK(tau->dq->len == N_INDEXED);
+	CHECK_PTR_EQ(dq_get(tau->dq, 2), &indexed[N_INDEXED - 1]);
+	CHECK_PTR_EQ(dq_get(tau->dq, 3), &indexed[2]);
+	CHECK_PTR_EQ(dq_get(tau->dq, -1), &indexed[N_INDEXED - 2]);
+	CHECK(tau->dq->tail->prev->next == tau->dq->tail);
+	dq_del(last, NULL);
+	dq_del(back, NULL);
+}
+
+TEST_F(indexed_items, split_at_head_empties_deque)
+{
+	deque *const all = dq_split_at(tau->dq, tau->dq->head);
+
+	REQUIRE(all);
+	CHECK(all->len == N_INDEXED);
+	CHECK(tau->dq->len == 0);
+	CHECK(tau->dq->head == NULL && tau->dq->tail == NULL);
+	CHECK(dq_split_at(tau->dq, all->head) == NULL);
+	CHECK(dq_concat(tau->dq, all) == 1);
+	for (intmax_t i = 0; i < N_INDEXED; ++i)
+		CHECK_PTR_EQ(dq_get(tau->dq, i), &indexed[i]);
+
+	dq_del(all, NULL);
+}
+
+TEST_F(indexed_items, splice_in_the_middle)
+{
+	deque *const other = dq_new();
+
+	REQUIRE(other);
+	REQUIRE(dq_push_tail(other, n1d, NULL));
+	REQUIRE(dq_push_tail(other, n2d, NULL));
+	CHECK_PTR_EQ(dq_get(tau->dq, 30), &indexed[30]);
+	CHECK(dq_splice(tau->dq, tau->dq->head->next, other) == 1);
+	CHECK(other->len == 0 && other->head == NULL);
+	CHECK(tau->dq->len == N_INDEXED + 2);
+	CHECK_PTR_EQ(dq_get(tau->dq, 2), n1d);
+	CHECK_PTR_EQ(dq_get(tau->dq, 3), n2d);
+	CHECK_PTR_EQ(dq_get(tau->dq, 30), &indexed[28]);
+
+	REQUIRE(dq_push_tail(other, n3d, NULL));
+	CHECK(dq_splice(tau->dq, NULL, other) == 1);
+	CHECK_PTR_EQ(dq_pop_head(tau->dq), n3d);
+	CHECK(dq_splice(tau->dq, NULL, other) == 1);
+	CHECK(dq_splice(NULL, NULL, other) == 0);
+	CHECK(dq_concat(tau->dq, NULL) == 0);
+	dq_del(other, NULL);
+}
+
+TEST(pooled_splice, different_pools_move_the_data)
+{
+	node_pool *const pool = ndpool_new(0);
+	deque *const pooled = dq_new(), *const plain = dq_new();
+	char *strs[] = {n1d, n2d, n3d};
+
+	REQUIRE(pool && pooled && plain);
+	REQUIRE(dq_set_pool(pooled, pool));
+	REQUIRE(dq_push_tail(pooled, n3d, NULL));
+	REQUIRE(dq_push_tail(plain, n1d, NULL));
+	REQUIRE(dq_push_tail(plain, n2d, NULL));
+	CHECK(dq_splice(pooled, NULL, plain) == 1);
+	CHECK(plain->len == 0 && plain->head == NULL);
+	CHECK(pooled->len == 3);
+	CHECK(pool->n_free == NDPOOL_SLAB_LEN - 3);
+	CHECK_PTR_EQ(dq_get(pooled, 0), n1d);
+	CHECK_PTR_EQ(dq_get(pooled, 1), n2d);
+	CHECK_PTR_EQ(dq_get(pooled, 2), n3d);
+
+	deque *const one = dq_from_array(strs, 3, sizeof(*strs), NULL, NULL);
+	deque *const two = dq_from_array(strs, 2, sizeof(*strs), NULL, NULL);
+
+	REQUIRE(one && two);
+	CHECK(dq_concat(one, two) == 1);
+	CHECK(one->len == 5 && two->len == 0);
+	CHECK(two->owns_pool == 1);
+	CHECK(dq_concat(plain, one) == 1);
+	CHECK(plain->len == 5 && plain->pool == NULL);
+	CHECK(dq_concat(pooled, NULL) == 0);
+	dq_del(one, NULL);
+	dq_del(two, NULL);
+	dq_del(plain, NULL);
+	dq_del(pooled, NULL);
+	ndpool_del(pool);
+}
+
+TEST(pooled_splice, owned_pool_is_shared)
+{
+	char *strs[] = {n1d, n2d, n3d};
+	deque *const owner = dq_from_array(strs, 3, sizeof(*strs), NULL, NULL);
+	deque *const plain = dq_new();
+
+	REQUIRE(owner && owner->owns_pool && plain);
+	REQUIRE(dq_set_pool(plain, owner->pool));
+	CHECK(dq_concat(plain, owner) == 1);
+	CHECK(plain->owns_pool == 1);
+	CHECK(owner->owns_pool == 0 && owner->pool == NULL);
+	CHECK(plain->len == 3);
+	dq_del(owner, NULL);
+
+	deque *const back = dq_split_at(plain, plain->head->next);
+
+	REQUIRE(back);
+	CHECK(back->owns_pool == 1 && back->pool == plain->pool);
+	CHECK(plain->pool->n_owners == 2);
+	dq_del(plain, NULL);
+	CHECK(back->len == 2);
+	REQUIRE(dq_push_tail(back, n1d, NULL));
+	CHECK(back->pool->n_owners == 1);
+
+	deque *const front = dq_split_at(back, back->tail);
+
+	REQUIRE(front);
+	CHECK(dq_concat(back, front) == 1);
+	CHECK(back->pool->n_owners == 1);
+	CHECK(front->owns_pool == 0);
+	dq_del(front, NULL);
+	dq_del(back, NULL);
+}
+
+/**
+ * add_intmax - add a number to a sum.
+ * @data: pointer to the number.
+ * @sum: pointer to the sum.
+ */
+static void add_intmax(void *const data, void *const sum)
+{
+	*(intmax_t *)sum += *(intmax_t *)data;
+}
+
+TEST_F(indexed_items, foreach_visits_head_to_tail)
+{
+	intmax_t sum = 0;
+
+	dq_foreach(NULL, add_intmax, &sum);
+	dq_foreach(tau->dq, NULL, &sum);
+	CHECK(sum == 0);
+	dq_foreach(tau->dq, add_intmax, &sum);
+	CHECK(sum == N_INDEXED * (N_INDEXED - 1) / 2);
+	CHECK(tau->dq->len == N_INDEXED);
+}
+
+/**
+ * next_item - map an item of `indexed` to the one after it.
+ * @data: pointer into `indexed`.
+ * @arg: unused.
+ *
+ * Return: pointer to the next item, wrapping around.
+ */
+static void *next_item(void *const data, void *const arg)
+{
+	(void)arg;
+	return (&indexed[(*(intmax_t *)data + 1) % N_INDEXED]);
+}
+
+/**
+ * is_multiple - test whether a number is a multiple of another.
+ * @data: pointer to the number.
+ * @divisor: pointer to the divisor.
+ *
+ * Return: 1 if it is, else 0.
+ */
+static int is_multiple(void const *const data, void *const divisor)
+{
+	return (*(intmax_t const *)data % *(intmax_t *)divisor == 0);
+}
+
+/**
+ * fold_sum - add a number to a sum.
+ * @sum: pointer to the sum.
+ * @data: pointer to the number.
+ * @arg: unused.
+ */
+static void fold_sum(void *const sum, void const *const data, void *const arg)
+{
+	(void)arg;
+	*(intmax_t *)sum += *(intmax_t const *)data;
+}
+
+TEST_F(indexed_items, map_filter_reduce)
+{
+	intmax_t three = 3, sum = 0;
+
+	dq_map(tau->dq, next_item, NULL);
+	CHECK_PTR_EQ(dq_get(tau->dq, 0), &indexed[1]);
+	CHECK_PTR_EQ(dq_get(tau->dq, -1), &indexed[0]);
+
+	CHECK(dq_filter(tau->dq, is_multiple, &three, NULL) == N_INDEXED - 17);
+	CHECK(tau->dq->len == 17);
+	CHECK_PTR_EQ(dq_get(tau->dq, 0), &indexed[3]);
+	CHECK_PTR_EQ(dq_get(tau->dq, -1), &indexed[0]);
+	CHECK(tau->dq->tail->prev->next == tau->dq->tail);
+
+	dq_reduce(tau->dq, &sum, fold_sum, NULL);
+	CHECK(sum == 3 * 16 * 17 / 2);
+	dq_reduce(NULL, &sum, fold_sum, NULL);
+	dq_map(NULL, next_item, NULL);
+	CHECK(dq_filter(tau->dq, NULL, NULL, NULL) == 0);
+}
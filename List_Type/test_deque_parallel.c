@@ -0,0 +1,256 @@
+#include "deque.h"
+#include "deque_parallel.h"
+#include "list_type_structs.h"
+#include "node_pool.h"
+#include "tau/tau.h"
+
+#define N_RECORDS ((intmax_t)100000)
+
+/**
+ * struct keyed - a record sorted by key.
+ * @key: the sort key.
+ * @order: position before sorting.
+ */
+struct keyed
+{
+	int key;
+	intmax_t order;
+};
+
+static struct keyed records[N_RECORDS];
+
+/**
+ * cmp_key - compare two records by key.
+ * @a: the first record.
+ * @b: the second record.
+ *
+ * Return: the difference between the keys.
+ */
+static int cmp_key(void const *const a, void const *const b)
+{
+	return (((struct keyed const *)a)->key - ((struct keyed const *)b)->key);
+}
+
+/**
+ * double_key - double the key of a record in place.
+ * @data: the record.
+ * @arg: unused.
+ *
+ * Return: the record.
+ */
+static void *double_key(void *const data, void *const arg)
+{
+	(void)arg;
+	((struct keyed *)data)->key *= 2;
+	return (data);
+}
+
+/**
+ * key_below - test whether the key of a record is below a limit.
+ * @data: the record.
+ * @limit: pointer to the limit.
+ *
+ * Return: 1 if it is, else 0.
+ */
+static int key_below(void const *const data, void *const limit)
+{
+	return (((struct keyed const *)data)->key < *(int *)limit);
+}
+
+/**
+ * struct checksum - a checksum that depends on the order of the records.
+ * @count: number of records folded.
+ * @hash: the checksum.
+ */
+struct checksum
+{
+	uintmax_t count;
+	uintmax_t hash;
+};
+
+/**
+ * fold_order - fold the order of a record into a checksum.
+ * @acc: pointer to a `struct checksum`.
+ * @data: the record.
+ * @arg: unused.
+ */
+static void
+fold_order(void *const acc, void const *const data, void *const arg)
+{
+	struct checksum *const sum = acc;
+
+	(void)arg;
+	sum->hash = sum->hash * 31 + (uintmax_t)((struct keyed const *)data)->order;
+	++(sum->count);
+}
+
+/**
+ * merge_order - merge two checksums made by `fold_order`.
+ * @acc: the first checksum, updated.
+ * @other: the checksum of the records that come after.
+ * @arg: unused.
+ */
+static void
+merge_order(void *const acc, void const *const other, void *const arg)
+{
+	struct checksum *const a = acc;
+	struct checksum const *const b = other;
+	uintmax_t shift = 1;
+
+	(void)arg;
+	for (uintmax_t i = 0; i < b->count; ++i)
+		shift *= 31;
+
+	a->hash = a->hash * shift + b->hash;
+	a->count += b->count;
+}
+
+TAU_MAIN()
+
+struct sort_items
+{
+	deque *dq;
+	thread_pool *pool;
+};
+
+TEST_F_SETUP(sort_items)
+{
+	unsigned int seed = 42;
+
+	tau->pool = tpool_new(4);
+	tau->dq = dq_new();
+	REQUIRE(tau->pool && tau->dq);
+	for (intmax_t i = 0; i < N_RECORDS; ++i)
+	{
+		seed = seed * 1103515245U + 12345U;
+		records[i].key = (int)((seed >> 8) % 1000);
+		records[i].order = i;
+		REQUIRE(dq_push_tail(tau->dq, &records[i], NULL));
+	}
+}
+
+TEST_F_TEARDOWN(sort_items)
+{
+	tau->dq = dq_del(tau->dq, NULL);
+	tau->pool = tpool_del(tau->pool);
+}
+
+TEST_F(sort_items, parallel_sort_is_stable)
+{
+	dq_sort_parallel(tau->dq, cmp_key, tau->pool);
+	REQUIRE(tau->dq->len == N_RECORDS);
+	CHECK(tau->dq->head->prev == NULL);
+	CHECK(tau->dq->tail->next == NULL);
+
+	intmax_t count = 1;
+
+	for (list_node *node = tau->dq->head; node->next; node = node->next)
+	{
+		struct keyed const *const a = node->data, *const b = node->next->data;
+
+		++count;
+		REQUIRE(node->next->prev == node);
+		REQUIRE(
+			a->key < b->key || (a->key == b->key && a->order < b->order)
+		);
+	}
+
+	CHECK(count == N_RECORDS);
+	CHECK_PTR_EQ(dq_get(tau->dq, -1), tau->dq->tail->data);
+}
+
+TEST_F(sort_items, matches_sequential_sort)
+{
+	deque *const copy = dq_new();
+
+	REQUIRE(copy);
+	for (list_node *node = tau->dq->head; node; node = node->next)
+		REQUIRE(dq_push_tail(copy, node->data, NULL));
+
+	dq_sort(copy, cmp_key);
+	dq_sort_parallel(tau->dq, cmp_key, tau->pool);
+	for (intmax_t i = 0; i < N_RECORDS; ++i)
+		REQUIRE(dq_pop_head(copy) == dq_pop_head(tau->dq));
+
+	dq_del(copy, NULL);
+}
+
+TEST_F(sort_items, null_pool_sorts_on_caller)
+{
+	dq_sort_parallel(tau->dq, cmp_key, NULL);
+	dq_sort_parallel(NULL, cmp_key, tau->pool);
+	dq_sort_parallel(tau->dq, NULL, tau->pool);
+	CHECK(tau->dq->len == N_RECORDS);
+	for (intmax_t i = 1; i < N_RECORDS; ++i)
+		REQUIRE(cmp_key(dq_pop_head(tau->dq), tau->dq->head->data) <= 0);
+}
+
+TEST_F(sort_items, parallel_map_filter_reduce)
+{
+	struct checksum seq = {3, 7}, par = {3, 7};
+	struct checksum const identity = {0, 0};
+	int limit = 1000;
+
+	dq_reduce(tau->dq, &seq, fold_order, NULL);
+	dq_reduce_parallel(
+		tau->dq, &par, &identity, sizeof(par), fold_order, merge_order, NULL,
+		tau->pool
+	);
+	CHECK(par.count == N_RECORDS + 3);
+	CHECK(par.hash == seq.hash);
+
+	dq_map_parallel(tau->dq, double_key, NULL, tau->pool);
+	CHECK(tau->dq->len == N_RECORDS);
+
+	intmax_t expected = 0;
+
+	for (intmax_t i = 0; i < N_RECORDS; ++i)
+		expected += records[i].key < limit;
+
+	const size_t removed =
+		dq_filter_parallel(tau->dq, key_below, &limit, NULL, tau->pool);
+
+	CHECK(removed == (size_t)(N_RECORDS - expected));
+	REQUIRE(tau->dq->len == expected);
+	CHECK(tau->dq->head->prev == NULL);
+	CHECK(tau->dq->tail->next == NULL);
+
+	intmax_t count = 0;
+
+	for (list_node *node = tau->dq->head; node; node = node->next, ++count)
+	{
+		struct keyed const *const rec = node->data;
+
+		REQUIRE(rec->key < limit && rec->key % 2 == 0);
+		if (node->next)
+		{
+			REQUIRE(node->next->prev == node);
+			REQUIRE(rec->order < ((struct keyed *)node->next->data)->order);
+		}
+	}
+
+	CHECK(count == expected);
+}
+
+TEST_F(sort_items, parallel_filter_returns_nodes_to_pool)
+{
+	node_pool *const nodes = ndpool_new(0);
+	deque *const pooled = dq_new();
+	int limit = 500;
+
+	REQUIRE(nodes && pooled);
+	REQUIRE(dq_set_pool(pooled, nodes));
+	for (list_node *node = tau->dq->head; node; node = node->next)
+		REQUIRE(dq_push_tail(pooled, node->data, NULL));
+
+	const size_t n_free = nodes->n_free;
+	const size_t removed =
+		dq_filter_parallel(pooled, key_below, &limit, NULL, tau->pool);
+
+	CHECK(removed > 0);
+	CHECK(nodes->n_free == n_free + removed);
+	CHECK((size_t)pooled->len + removed == (size_t)N_RECORDS);
+	dq_del(pooled, NULL);
+	CHECK(nodes->n_free == n_free + (size_t)N_RECORDS);
+	ndpool_del(nodes);
+}
@@ -0,0 +1,219 @@
+#include <stdlib.h> /* *alloc */
+#include <string.h> /* memcmp, memcpy */
+
+#include "index_list.h"
+#include "list_type_structs.h"
+#include "tau/tau.h"
+
+#define MANY_ITEMS ((uint32_t)1000)
+
+/**
+ * struct point - a small payload stored inline.
+ * @x: first coordinate.
+ * @y: second coordinate.
+ */
+struct point
+{
+	int x;
+	int y;
+};
+
+TAU_MAIN()
+
+TEST(index_list_creation, new_returns_empty_list)
+{
+	index_list *const ixl = ixl_new(sizeof(struct point));
+
+	REQUIRE(ixl, "ixl_new() returns non-null");
+	CHECK(ixl->len == 0);
+	CHECK(ixl->head == IXL_NIL);
+	CHECK(ixl->tail == IXL_NIL);
+	CHECK(ixl->cap == 0);
+	CHECK(ixl_new(0) == NULL);
+	CHECK(ixl_pop_head(ixl, NULL) == 0);
+	CHECK(ixl_pop_tail(ixl, NULL) == 0);
+	CHECK(ixl_at(ixl, 0) == NULL);
+	CHECK(ixl_next(ixl, 0) == IXL_NIL);
+	ixl_del(ixl);
+}
+
+TEST(index_list_creation, null_list_is_rejected)
+{
+	struct point p = {1, 2};
+
+	CHECK(ixl_push_head(NULL, &p) == IXL_NIL);
+	CHECK(ixl_push_tail(NULL, &p) == IXL_NIL);
+	CHECK(ixl_insert_after(NULL, IXL_NIL, &p) == IXL_NIL);
+	CHECK(ixl_remove(NULL, 0, &p) == 0);
+	CHECK(ixl_reserve(NULL, 1) == 0);
+	CHECK(ixl_at(NULL, 0) == NULL);
+	CHECK(ixl_prev(NULL, 0) == IXL_NIL);
+	CHECK(ixl_del(NULL) == NULL);
+	ixl_clear(NULL);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+struct points
+{
+	index_list *ixl;
+};
+
+TEST_F_SETUP(points)
+{
+	tau->ixl = ixl_new(sizeof(struct point));
+	REQUIRE(tau->ixl, "ixl_new() returns non-null");
+}
+
+TEST_F_TEARDOWN(points) { tau->ixl = ixl_del(tau->ixl); }
+
+TEST_F(points, push_both_ends_keeps_order)
+{
+	struct point p1 = {1, 1}, p2 = {2, 2}, p3 = {3, 3}, out = {0, 0};
+	const uint32_t i2 = ixl_push_tail(tau->ixl, &p2);
+	const uint32_t i1 = ixl_push_head(tau->ixl, &p1);
+	const uint32_t i3 = ixl_push_tail(tau->ixl, &p3);
+
+	REQUIRE(i1 != IXL_NIL && i2 != IXL_NIL && i3 != IXL_NIL);
+	CHECK(tau->ixl->len == 3);
+	CHECK(tau->ixl->head == i1);
+	CHECK(ixl_next(tau->ixl, i1) == i2);
+	CHECK(ixl_next(tau->ixl, i2) == i3);
+	CHECK(ixl_next(tau->ixl, i3) == IXL_NIL);
+	CHECK(ixl_prev(tau->ixl, i3) == i2);
+	CHECK(memcmp(ixl_at(tau->ixl, i2), &p2, sizeof(p2)) == 0);
+
+	CHECK(ixl_pop_tail(tau->ixl, &out) == 1);
+	CHECK(out.x == 3);
+	CHECK(ixl_pop_head(tau->ixl, &out) == 1);
+	CHECK(out.x == 1);
+	CHECK(tau->ixl->head == i2 && tau->ixl->tail == i2);
+	CHECK(ixl_pop_head(tau->ixl, NULL) == 1);
+	CHECK(tau->ixl->head == IXL_NIL && tau->ixl->tail == IXL_NIL);
+}
+
+TEST_F(points, freed_slots_are_reused)
+{
+	uint32_t idx[MANY_ITEMS];
+
+	for (uint32_t i = 0; i < MANY_ITEMS; ++i)
+	{
+		struct point p = {(int)i, -(int)i};
+
+		idx[i] = ixl_push_tail(tau->ixl, &p);
+		REQUIRE(idx[i] == i);
+	}
+
+	const uint32_t cap = tau->ixl->cap;
+
+	CHECK(cap >= MANY_ITEMS);
+	for (uint32_t i = 0; i < MANY_ITEMS; i += 2)
+		REQUIRE(ixl_remove(tau->ixl, idx[i], NULL));
+
+	CHECK(tau->ixl->len == MANY_ITEMS / 2);
+	for (uint32_t i = 0; i < MANY_ITEMS / 2; ++i)
+		REQUIRE(ixl_push_head(tau->ixl, NULL) != IXL_NIL);
+
+	CHECK(tau->ixl->cap == cap);
+	CHECK(tau->ixl->n_used == MANY_ITEMS);
+	CHECK(tau->ixl->len == MANY_ITEMS);
+
+	uint32_t n = 0;
+	int zeroed = 0;
+
+	for (uint32_t i = tau->ixl->head; i != IXL_NIL; i = ixl_next(tau->ixl, i))
+	{
+		struct point const *const p = ixl_at(tau->ixl, i);
+
+		if (n < MANY_ITEMS / 2)
+			zeroed += p->x == 0 && p->y == 0;
+		else
+			CHECK(p->x % 2 == 1 && p->y == -p->x);
+
+		++n;
+	}
+
+	CHECK(n == MANY_ITEMS);
+	CHECK(zeroed == MANY_ITEMS / 2);
+}
+
+TEST_F(points, insert_after_links_in_the_middle)
+{
+	struct point p = {7, 7};
+	const uint32_t a = ixl_push_tail(tau->ixl, &p);
+	const uint32_t c = ixl_push_tail(tau->ixl, &p);
+	const uint32_t b = ixl_insert_after(tau->ixl, a, &p);
+
+	REQUIRE(b != IXL_NIL);
+	CHECK(ixl_next(tau->ixl, a) == b);
+	CHECK(ixl_next(tau->ixl, b) == c);
+	CHECK(ixl_prev(tau->ixl, c) == b);
+	CHECK(ixl_insert_after(tau->ixl, 99, &p) == IXL_NIL);
+	CHECK(ixl_remove(tau->ixl, b, NULL) == 1);
+	CHECK(ixl_next(tau->ixl, a) == c);
+	CHECK(ixl_prev(tau->ixl, c) == a);
+	CHECK(ixl_remove(tau->ixl, 99, NULL) == 0);
+}
+
+TEST_F(points, clear_keeps_arrays_and_copy_relocates)
+{
+	for (uint32_t i = 0; i < MANY_ITEMS; ++i)
+	{
+		struct point p = {(int)i, (int)i};
+
+		REQUIRE(ixl_push_tail(tau->ixl, &p) != IXL_NIL);
+	}
+
+	index_list copy = *tau->ixl;
+	struct ixl_link *const links = malloc(sizeof(*links) * copy.cap);
+	unsigned char *const data = malloc(copy.elem_size * copy.cap);
+
+	REQUIRE(links && data);
+	memcpy(links, copy.links, sizeof(*links) * copy.n_used);
+	memcpy(data, copy.data, copy.elem_size * copy.n_used);
+	copy.links = links;
+	copy.data = data;
+
+	struct point out = {0, 0};
+
+	CHECK(ixl_pop_tail(&copy, &out) == 1);
+	CHECK(out.x == (int)MANY_ITEMS - 1);
+	free(links);
+	free(data);
+
+	const uint32_t cap = tau->ixl->cap;
+
+	ixl_clear(tau->ixl);
+	CHECK(tau->ixl->len == 0);
+	CHECK(tau->ixl->cap == cap);
+	CHECK(ixl_push_tail(tau->ixl, &out) == 0);
+	CHECK(ixl_reserve(tau->ixl, cap * 2) == 1);
+	CHECK(tau->ixl->cap == cap * 2);
+}
+
+TEST_F(points, freed_slots_are_not_elements)
+{
+	struct point p = {4, 4};
+	const uint32_t a = ixl_push_tail(tau->ixl, &p);
+	const uint32_t b = ixl_push_tail(tau->ixl, &p);
+
+	REQUIRE(a != IXL_NIL && b != IXL_NIL);
+	CHECK(ixl_remove(tau->ixl, a, NULL) == 1);
+	CHECK(ixl_remove(tau->ixl, a, NULL) == 0);
+	CHECK(tau->ixl->len == 1);
+	CHECK(tau->ixl->head == b && tau->ixl->tail == b);
+	CHECK(ixl_at(tau->ixl, a) == NULL);
+	CHECK(ixl_next(tau->ixl, a) == IXL_NIL);
+	CHECK(ixl_prev(tau->ixl, a) == IXL_NIL);
+	CHECK(ixl_insert_after(tau->ixl, a, &p) == IXL_NIL);
+
+	const uint32_t c = ixl_push_tail(tau->ixl, &p);
+	const uint32_t d = ixl_push_tail(tau->ixl, &p);
+
+	CHECK(c == a);
+	CHECK(d != a && d != b);
+	CHECK(tau->ixl->len == 3);
+	CHECK(ixl_next(tau->ixl, b) == c);
+	CHECK(ixl_next(tau->ixl, c) == d);
+}
@@ -0,0 +1,157 @@
+#include <stdlib.h> /* free */
+
+#include "intrusive_list.h"
+#include "list_type_structs.h"
+#include "tau/tau.h"
+
+/**
+ * struct timer - an object with an embedded link.
+ * @deadline: payload before the link.
+ * @link: the link.
+ * @id: payload after the link.
+ */
+struct timer
+{
+	long deadline;
+	ilink link;
+	int id;
+};
+
+TAU_MAIN()
+
+TEST(ilink, container_of_recovers_object)
+{
+	struct timer t = {.deadline = 5, .id = 1};
+
+	CHECK_PTR_EQ(container_of(&t.link, struct timer, link), &t);
+	CHECK_PTR_EQ(ilink_entry(&t.link, struct timer, link), &t);
+	CHECK(ilink_entry((ilink *)NULL, struct timer, link) == NULL);
+}
+
+TEST(ilink, insert_and_pop)
+{
+	struct timer t[3] = {{.id = 0}, {.id = 1}, {.id = 2}};
+
+	for (int i = 0; i < 3; ++i)
+		ilink_init(&t[i].link);
+
+	CHECK_PTR_EQ(ilink_insert_after(&t[0].link, &t[2].link), &t[2].link);
+	CHECK_PTR_EQ(ilink_insert_before(&t[2].link, &t[1].link), &t[1].link);
+	CHECK_PTR_EQ(t[0].link.next, &t[1].link);
+	CHECK_PTR_EQ(t[1].link.next, &t[2].link);
+	CHECK_PTR_EQ(t[2].link.prev, &t[1].link);
+	CHECK_PTR_EQ(t[1].link.prev, &t[0].link);
+
+	CHECK_PTR_EQ(ilink_pop(&t[1].link), &t[1].link);
+	CHECK_PTR_EQ(t[0].link.next, &t[2].link);
+	CHECK_PTR_EQ(t[2].link.prev, &t[0].link);
+	CHECK(t[1].link.next == NULL);
+	CHECK(t[1].link.prev == NULL);
+	CHECK(ilink_pop(NULL) == NULL);
+}
+
+TEST(ilink, splice_chain)
+{
+	struct timer t[4];
+
+	for (int i = 0; i < 4; ++i)
+		ilink_init(&t[i].link);
+
+	ilink_insert_after(&t[0].link, &t[3].link);
+	ilink_insert_after(&t[1].link, &t[2].link);
+	CHECK_PTR_EQ(
+		ilink_splice_after(&t[0].link, &t[1].link, &t[2].link), &t[2].link
+	);
+	for (int i = 0; i < 3; ++i)
+	{
+		CHECK_PTR_EQ(t[i].link.next, &t[i + 1].link);
+		CHECK_PTR_EQ(t[i + 1].link.prev, &t[i].link);
+	}
+
+	CHECK(ilink_splice_after(&t[0].link, NULL, NULL) == NULL);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+struct idq_ops
+{
+	intrusive_deque idq;
+	struct timer t[5];
+};
+
+TEST_F_SETUP(idq_ops)
+{
+	idq_init(&tau->idq);
+	for (int i = 0; i < 5; ++i)
+		tau->t[i].id = i;
+}
+
+TEST_F_TEARDOWN(idq_ops) { (void)tau; }
+
+TEST_F(idq_ops, push_and_pop_both_ends)
+{
+	REQUIRE(idq_push_tail(&tau->idq, &tau->t[1].link));
+	REQUIRE(idq_push_head(&tau->idq, &tau->t[0].link));
+	REQUIRE(idq_push_tail(&tau->idq, &tau->t[2].link));
+	CHECK(tau->idq.len == 3);
+	CHECK(ilink_entry(tau->idq.head, struct timer, link)->id == 0);
+	CHECK(ilink_entry(tau->idq.tail, struct timer, link)->id == 2);
+
+	CHECK_PTR_EQ(idq_pop_tail(&tau->idq), &tau->t[2].link);
+	CHECK_PTR_EQ(idq_pop_head(&tau->idq), &tau->t[0].link);
+	CHECK_PTR_EQ(idq_pop_head(&tau->idq), &tau->t[1].link);
+	CHECK(idq_pop_head(&tau->idq) == NULL);
+	CHECK(idq_pop_tail(&tau->idq) == NULL);
+	CHECK(tau->idq.len == 0);
+	CHECK(tau->idq.head == NULL);
+	CHECK(tau->idq.tail == NULL);
+}
+
+TEST_F(idq_ops, insert_and_remove_in_middle)
+{
+	REQUIRE(idq_push_tail(&tau->idq, &tau->t[0].link));
+	REQUIRE(idq_push_tail(&tau->idq, &tau->t[3].link));
+	REQUIRE(idq_insert_after(&tau->idq, &tau->t[0].link, &tau->t[1].link));
+	REQUIRE(idq_insert_before(&tau->idq, &tau->t[3].link, &tau->t[2].link));
+	REQUIRE(idq_insert_after(&tau->idq, &tau->t[3].link, &tau->t[4].link));
+	CHECK(tau->idq.len == 5);
+	CHECK_PTR_EQ(tau->idq.tail, &tau->t[4].link);
+
+	int i = 0;
+
+	for (ilink *l = tau->idq.head; l; l = l->next, ++i)
+		CHECK(ilink_entry(l, struct timer, link)->id == i);
+
+	CHECK(i == 5);
+	CHECK_PTR_EQ(idq_remove(&tau->idq, &tau->t[4].link), &tau->t[4].link);
+	CHECK_PTR_EQ(tau->idq.tail, &tau->t[3].link);
+	CHECK_PTR_EQ(idq_remove(&tau->idq, &tau->t[0].link), &tau->t[0].link);
+	CHECK_PTR_EQ(tau->idq.head, &tau->t[1].link);
+	CHECK_PTR_EQ(idq_remove(&tau->idq, &tau->t[2].link), &tau->t[2].link);
+	CHECK_PTR_EQ(tau->t[1].link.next, &tau->t[3].link);
+	CHECK(tau->idq.len == 2);
+}
+
+TEST_F(idq_ops, splice_tail_moves_everything)
+{
+	intrusive_deque other;
+
+	idq_init(&other);
+	REQUIRE(idq_push_tail(&tau->idq, &tau->t[0].link));
+	REQUIRE(idq_push_tail(&other, &tau->t[1].link));
+	REQUIRE(idq_push_tail(&other, &tau->t[2].link));
+	idq_splice_tail(&tau->idq, &other);
+	CHECK(tau->idq.len == 3);
+	CHECK_PTR_EQ(tau->idq.tail, &tau->t[2].link);
+	CHECK_PTR_EQ(tau->t[0].link.next, &tau->t[1].link);
+	CHECK_PTR_EQ(tau->t[1].link.prev, &tau->t[0].link);
+	CHECK(other.len == 0);
+	CHECK(other.head == NULL);
+
+	idq_splice_tail(&other, &tau->idq);
+	CHECK(other.len == 3);
+	CHECK_PTR_EQ(other.head, &tau->t[0].link);
+	CHECK_PTR_EQ(other.tail, &tau->t[2].link);
+	CHECK(tau->idq.len == 0);
+}
@@ -3,6 +3,7 @@
 
 #include "list_node.h"
 #include "list_type_structs.h"
+#include "str_buf.h"
 #include "tau/tau.h"
 
 #define MAX_STRING_LENGTH ((unsigned int)256)
@@ -524,6 +525,32 @@ static char *format_string(void const *const str)
 	return (out_str);
 }
 
+/**
+ * write_string - write a string to a `str_buf`.
+ * @sb: the buffer.
+ * @str: pointer to the string.
+ *
+ * Return: 1 on success, 0 on failure.
+ */
+static int write_string(str_buf *const sb, void const *const str)
+{
+	return (strbuf_puts(sb, str ? str : "NULL"));
+}
+
+/**
+ * fail_write - failing write function.
+ * @sb: unused.
+ * @str: unused.
+ *
+ * Return: 0.
+ */
+static int fail_write(str_buf *const sb, void const *const str)
+{
+	(void)sb;
+	(void)str;
+	return (0);
+}
+
 struct print_ll
 {
 	list_node *restrict n1, *restrict n2, *restrict n3;
@@ -734,3 +761,187 @@ TEST_F(print_ll, printrev_three_nodes)
 	REQUIRE_PTR_NE(tau->output, NULL);
 	CHECK_STREQ(tau->output, expected);
 }
+
+TEST_F(print_ll, write_three_nodes)
+{
+	str_buf sb;
+
+	strbuf_init(&sb, NULL);
+	lstnode_insert_after(lstnode_insert_after(tau->n1, tau->n2), tau->n3);
+	CHECK(linked_list_write(NULL, &sb, write_string) == 0);
+	CHECK(linked_list_write(tau->n1, NULL, write_string) == 0);
+	REQUIRE(linked_list_write(tau->n1, &sb, write_string));
+	REQUIRE(strbuf_puts(&sb, " | "));
+	REQUIRE(linked_list_write_reversed(tau->n3, &sb, write_string));
+	tau->output = strbuf_release(&sb);
+	REQUIRE_PTR_NE(tau->output, NULL);
+	CHECK_STREQ(
+		tau->output, "one <--> two <--> three | three <--> two <--> one"
+	);
+}
+
+TEST_F(print_ll, write_failure_is_reported)
+{
+	str_buf sb;
+
+	strbuf_init(&sb, NULL);
+	lstnode_insert_after(tau->n1, tau->n2);
+	CHECK(linked_list_write(tau->n1, &sb, fail_write) == 0);
+	strbuf_free(&sb);
+}
+
+TEST(print_ll, tostr_long_list)
+{
+	const int n_nodes = 100000;
+	list_node *head = NULL, *tail = NULL;
+
+	for (int i = 0; i < n_nodes; ++i)
+	{
+		list_node *const nw = lstnode_new(n1d, NULL);
+
+		REQUIRE(nw);
+		tail = lstnode_insert_after(tail, nw);
+		if (!head)
+			head = tail;
+	}
+
+	char *const output = linked_list_tostr(head, format_string);
+
+	REQUIRE(output);
+	CHECK(strlen(output) == (size_t)n_nodes * 9 - 6);
+	free(output);
+	linked_list_del(head, NULL);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+#define N_SORTED 1000
+
+/**
+ * struct keyed - a record sorted by key.
+ * @key: the sort key.
+ * @order: position before sorting.
+ */
+struct keyed
+{
+	int key;
+	int order;
+};
+
+static struct keyed records[N_SORTED];
+
+/**
+ * cmp_key - compare two records by key.
+ * @a: the first record.
+ * @b: the second record.
+ *
+ * Return: the difference between the keys.
+ */
+static int cmp_key(void const *const a, void const *const b)
+{
+	return (((struct keyed const *)a)->key - ((struct keyed const *)b)->key);
+}
+
+TEST(sort_ll, null_and_single_node)
+{
+	list_node *const node = lstnode_new(n1d, NULL);
+	list_node *tail = node;
+
+	REQUIRE(node);
+	CHECK(linked_list_sort(NULL, cmp_key, &tail) == NULL);
+	CHECK(tail == NULL);
+	CHECK(linked_list_sort(node, cmp_key, &tail) == node);
+	CHECK(tail == node);
+	CHECK(linked_list_merge(node, NULL, cmp_key) == node);
+	CHECK(linked_list_merge(NULL, node, cmp_key) == node);
+	lstnode_del(node);
+}
+
+TEST(sort_ll, sort_is_stable_and_relinks)
+{
+	list_node *head = NULL, *tail = NULL;
+	unsigned int seed = 12345;
+
+	for (int i = 0; i < N_SORTED; ++i)
+	{
+		seed = seed * 1103515245U + 12345U;
+		records[i].key = (int)((seed >> 16) % 50);
+		records[i].order = i;
+		tail = lstnode_insert_after(tail, lstnode_new(&records[i], NULL));
+		REQUIRE(tail);
+		if (!head)
+			head = tail;
+	}
+
+	list_node *const first_node = head;
+
+	head = linked_list_sort(head, cmp_key, &tail);
+	REQUIRE(head);
+	CHECK(head->prev == NULL);
+	CHECK(tail->next == NULL);
+
+	int count = 1;
+
+	for (list_node *node = head; node->next; node = node->next, ++count)
+	{
+		struct keyed const *const a = node->data, *const b = node->next->data;
+
+		CHECK(node->next->prev == node);
+		CHECK(a->key < b->key || (a->key == b->key && a->order < b->order));
+	}
+
+	CHECK(count == N_SORTED);
+	CHECK_PTR_EQ(first_node->data, &records[0]);
+	linked_list_del(head, NULL);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+/**
+ * add_key - add the key of a record to a sum.
+ * @data: the record.
+ * @sum: pointer to the sum.
+ */
+static void add_key(void *const data, void *const sum)
+{
+	*(long *)sum += ((struct keyed *)data)->key;
+}
+
+TEST(walk_ll, foreach_visits_every_node)
+{
+	list_node *head = NULL, *tail = NULL;
+	long sum = 0;
+
+	for (int i = 0; i < N_SORTED; ++i)
+	{
+		records[i].key = i;
+		tail = lstnode_insert_after(tail, lstnode_new(&records[i], NULL));
+		REQUIRE(tail);
+		if (!head)
+			head = tail;
+	}
+
+	linked_list_foreach(NULL, add_key, &sum);
+	linked_list_foreach(head, NULL, &sum);
+	CHECK(sum == 0);
+	linked_list_foreach(head, add_key, &sum);
+	CHECK(sum == (long)N_SORTED * (N_SORTED - 1) / 2);
+	linked_list_del(head, NULL);
+}
+
+TEST(walk_ll, del_cuts_the_list_before_head)
+{
+	list_node *const n1 = lstnode_new(n1d, NULL);
+	list_node *const n2 = lstnode_new(n2d, dup_str);
+	list_node *const n3 = lstnode_new(n3d, dup_str);
+
+	REQUIRE(n1 && n2 && n3);
+	lstnode_insert_after(n1, n2);
+	lstnode_insert_after(n2, n3);
+	CHECK(linked_list_del(n2, free) == NULL);
+	CHECK(n1->next == NULL);
+	CHECK(n1->prev == NULL);
+	lstnode_del(n1);
+}
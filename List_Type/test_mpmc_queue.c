@@ -0,0 +1,193 @@
+#include <pthread.h>
+#include <stdint.h> /* uintptr_t */
+#include <stdlib.h> /* free */
+
+#include "list_type_structs.h"
+#include "mpmc_queue.h"
+#include "tau/tau.h"
+
+#define N_THREADS (4)
+#define N_MESSAGES ((uintptr_t)50000)
+
+static char n1d[] = "one", n2d[] = "two", n3d[] = "three";
+
+/**
+ * struct mpmc_run - state of a multi-threaded test.
+ * @q: the queue.
+ * @id: number of the next producer to start.
+ * @out_of_order: number of messages received out of order.
+ * @sum: sum of all received messages.
+ */
+struct mpmc_run
+{
+	mpmc_queue *q;
+	atomic_uint id;
+	atomic_uintptr_t out_of_order;
+	atomic_uintptr_t sum;
+};
+
+/**
+ * produce - push `N_MESSAGES` messages tagged with the producer's number.
+ * @arg: the test state.
+ *
+ * Return: NULL.
+ */
+static void *produce(void *arg)
+{
+	struct mpmc_run *const run = arg;
+	const uintptr_t id = atomic_fetch_add(&run->id, 1);
+
+	for (uintptr_t i = 1; i <= N_MESSAGES; ++i)
+		mpmcq_push(run->q, (void *)(i * N_THREADS + id));
+
+	return (NULL);
+}
+
+/**
+ * consume - pop `N_MESSAGES` messages, checking that each producer's
+ * messages arrive in order.
+ * @arg: the test state.
+ *
+ * Return: NULL.
+ */
+static void *consume(void *arg)
+{
+	struct mpmc_run *const run = arg;
+	uintptr_t last[N_THREADS] = {0}, sum = 0, out_of_order = 0;
+	void *d = NULL;
+
+	for (uintptr_t i = 0; i < N_MESSAGES; ++i)
+	{
+		mpmcq_pop(run->q, &d);
+
+		const uintptr_t msg = (uintptr_t)d;
+
+		if (msg / N_THREADS <= last[msg % N_THREADS])
+			++out_of_order;
+
+		last[msg % N_THREADS] = msg / N_THREADS;
+		sum += msg / N_THREADS;
+	}
+
+	atomic_fetch_add(&run->out_of_order, out_of_order);
+	atomic_fetch_add(&run->sum, sum);
+	return (NULL);
+}
+
+TAU_MAIN()
+
+TEST(mpmc_creation, capacity_is_rounded_up)
+{
+	mpmc_queue *const q = mpmcq_new(1);
+
+	REQUIRE(q, "mpmcq_new() returns non-null");
+	CHECK(mpmcq_capacity(q) == 2);
+	CHECK(mpmcq_len(q) == 0);
+	CHECK(mpmcq_new(0) == NULL);
+	mpmcq_del(q, NULL);
+}
+
+TEST(mpmc_creation, null_queue_is_rejected)
+{
+	void *d = NULL;
+
+	CHECK(mpmcq_try_push(NULL, n1d) == 0);
+	CHECK(mpmcq_try_pop(NULL, &d) == 0);
+	CHECK(mpmcq_push(NULL, n1d) == 0);
+	CHECK(mpmcq_pop(NULL, &d) == 0);
+	CHECK(mpmcq_len(NULL) == 0);
+	CHECK(mpmcq_del(NULL, NULL) == NULL);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+struct mpmc_ops
+{
+	mpmc_queue *q;
+};
+
+TEST_F_SETUP(mpmc_ops)
+{
+	tau->q = mpmcq_new(3);
+	REQUIRE(tau->q, "mpmcq_new() returns non-null");
+}
+
+TEST_F_TEARDOWN(mpmc_ops) { tau->q = mpmcq_del(tau->q, NULL); }
+
+TEST_F(mpmc_ops, fifo_order_and_full_queue)
+{
+	void *d = NULL;
+
+	CHECK(mpmcq_try_pop(tau->q, &d) == 0);
+	REQUIRE(mpmcq_try_push(tau->q, n1d));
+	REQUIRE(mpmcq_try_push(tau->q, n2d));
+	REQUIRE(mpmcq_push(tau->q, n3d));
+	REQUIRE(mpmcq_try_push(tau->q, NULL));
+	CHECK(mpmcq_try_push(tau->q, n1d) == 0);
+	CHECK(mpmcq_len(tau->q) == 4);
+
+	REQUIRE(mpmcq_try_pop(tau->q, &d));
+	CHECK_PTR_EQ(d, n1d);
+	REQUIRE(mpmcq_pop(tau->q, &d));
+	CHECK_PTR_EQ(d, n2d);
+	REQUIRE(mpmcq_try_pop(tau->q, &d));
+	CHECK_PTR_EQ(d, n3d);
+	REQUIRE(mpmcq_try_pop(tau->q, &d));
+	CHECK(d == NULL);
+	CHECK(mpmcq_try_pop(tau->q, &d) == 0);
+}
+
+TEST_F(mpmc_ops, slots_are_reused_across_laps)
+{
+	void *d = NULL;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		REQUIRE(mpmcq_try_push(tau->q, n1d));
+		REQUIRE(mpmcq_try_push(tau->q, n2d));
+		REQUIRE(mpmcq_try_pop(tau->q, &d));
+		CHECK_PTR_EQ(d, n1d);
+		REQUIRE(mpmcq_try_pop(tau->q, &d));
+		CHECK_PTR_EQ(d, n2d);
+	}
+
+	CHECK(mpmcq_len(tau->q) == 0);
+}
+
+TEST_F(mpmc_ops, del_frees_remaining_data)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		int *const n = malloc(sizeof(*n));
+
+		REQUIRE(n);
+		REQUIRE(mpmcq_try_push(tau->q, n));
+	}
+
+	tau->q = mpmcq_del(tau->q, free);
+}
+
+TEST(mpmc_threads, every_message_arrives_once)
+{
+	struct mpmc_run run = {.q = mpmcq_new(64)};
+	pthread_t producers[N_THREADS], consumers[N_THREADS];
+
+	REQUIRE(run.q, "mpmcq_new() returns non-null");
+	for (int i = 0; i < N_THREADS; ++i)
+	{
+		REQUIRE(pthread_create(&producers[i], NULL, produce, &run) == 0);
+		REQUIRE(pthread_create(&consumers[i], NULL, consume, &run) == 0);
+	}
+
+	for (int i = 0; i < N_THREADS; ++i)
+	{
+		pthread_join(producers[i], NULL);
+		pthread_join(consumers[i], NULL);
+	}
+
+	CHECK(run.out_of_order == 0);
+	CHECK(run.sum == N_THREADS * (N_MESSAGES * (N_MESSAGES + 1) / 2));
+	CHECK(mpmcq_len(run.q) == 0);
+	mpmcq_del(run.q, NULL);
+}
@@ -0,0 +1,120 @@
+#include <stdlib.h> /* free */
+
+#include "list_node.h"
+#include "list_type_structs.h"
+#include "node_pool.h"
+#include "tau/tau.h"
+
+static char n1d[] = "one", n2d[] = "two", n3d[] = "three";
+
+/**
+ * fail_dup - failing duplicating function.
+ * @d: unused.
+ *
+ * Return: NULL.
+ */
+static void *fail_dup(void const *const d)
+{
+	(void)d;
+	return (NULL);
+}
+
+TAU_MAIN()
+
+TEST(node_pool_creation, new_uses_default_slab_len)
+{
+	node_pool *const pool = ndpool_new(0);
+
+	REQUIRE(pool, "ndpool_new() returns non-null");
+	CHECK(pool->slab_len == NDPOOL_SLAB_LEN);
+	CHECK(pool->n_free == 0);
+	CHECK(pool->free_list == NULL);
+	ndpool_del(pool);
+}
+
+TEST(node_pool_creation, null_pool_is_rejected)
+{
+	CHECK(ndpool_alloc(NULL, n1d, NULL) == NULL);
+	CHECK(ndpool_free(NULL, NULL) == NULL);
+	CHECK(ndpool_reserve(NULL, 1) == 0);
+	CHECK(ndpool_del(NULL) == NULL);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+struct pool_ops
+{
+	node_pool *pool;
+};
+
+TEST_F_SETUP(pool_ops)
+{
+	tau->pool = ndpool_new(2);
+	REQUIRE(tau->pool, "ndpool_new() returns non-null");
+}
+
+TEST_F_TEARDOWN(pool_ops) { tau->pool = ndpool_del(tau->pool); }
+
+TEST_F(pool_ops, alloc_returns_clean_nodes)
+{
+	list_node *const n1 = ndpool_alloc(tau->pool, n1d, NULL);
+
+	REQUIRE(n1);
+	CHECK(tau->pool->n_free == 1);
+	CHECK(lstnode_get_next(n1) == NULL);
+	CHECK(lstnode_get_prev(n1) == NULL);
+	CHECK_PTR_EQ(lstnode_get_data(n1), n1d);
+	CHECK(ndpool_alloc(tau->pool, n2d, fail_dup) == NULL);
+	CHECK(tau->pool->n_free == 1);
+}
+
+TEST_F(pool_ops, free_unlinks_and_recycles)
+{
+	list_node *const n1 = ndpool_alloc(tau->pool, n1d, NULL);
+	list_node *const n2 = ndpool_alloc(tau->pool, n2d, NULL);
+	list_node *const n3 = ndpool_alloc(tau->pool, n3d, NULL);
+
+	REQUIRE(n1 && n2 && n3);
+	lstnode_insert_after(n1, n2);
+	lstnode_insert_after(n2, n3);
+	CHECK_PTR_EQ(ndpool_free(tau->pool, n2), n2d);
+	CHECK_PTR_EQ(lstnode_get_next(n1), n3);
+	CHECK_PTR_EQ(lstnode_get_prev(n3), n1);
+	CHECK_PTR_EQ(ndpool_alloc(tau->pool, n3d, NULL), n2);
+}
+
+TEST_F(pool_ops, free_chain_returns_nodes_at_once)
+{
+	list_node *const n1 = ndpool_alloc(tau->pool, n1d, NULL);
+	list_node *const n2 = ndpool_alloc(tau->pool, n2d, NULL);
+	list_node *const n3 = ndpool_alloc(tau->pool, n3d, NULL);
+
+	REQUIRE(n1 && n2 && n3);
+	lstnode_insert_after(n1, n2);
+	lstnode_insert_after(n2, n3);
+
+	const size_t n_free = tau->pool->n_free;
+
+	ndpool_free_chain(tau->pool, n1, n3, 3);
+	CHECK(tau->pool->n_free == n_free + 3);
+	CHECK_PTR_EQ(ndpool_alloc(tau->pool, NULL, NULL), n1);
+	CHECK_PTR_EQ(ndpool_alloc(tau->pool, NULL, NULL), n2);
+	CHECK_PTR_EQ(ndpool_alloc(tau->pool, NULL, NULL), n3);
+}
+
+TEST_F(pool_ops, reserve_allocates_once)
+{
+	REQUIRE(ndpool_reserve(tau->pool, 10));
+	CHECK(tau->pool->n_free == 10);
+	CHECK(ndpool_reserve(tau->pool, 5));
+	CHECK(tau->pool->n_free == 10);
+
+	struct ndpool_slab *const slabs = tau->pool->slabs;
+
+	for (int i = 0; i < 10; ++i)
+		REQUIRE(ndpool_alloc(tau->pool, NULL, NULL));
+
+	CHECK_PTR_EQ(tau->pool->slabs, slabs);
+	CHECK(tau->pool->n_free == 0);
+}
@@ -0,0 +1,203 @@
+#include <stdlib.h> /* free */
+
+#include "list_type_structs.h"
+#include "ring_deque.h"
+#include "tau/tau.h"
+
+#define MANY_ITEMS ((intmax_t)100)
+
+static char n1d[] = "one", n2d[] = "two", n3d[] = "three";
+static int numbers[MANY_ITEMS];
+
+/**
+ * fail_dup - failing duplicating function.
+ * @d: unused.
+ *
+ * Return: NULL.
+ */
+static void *fail_dup(void const *const d)
+{
+	(void)d;
+	return (NULL);
+}
+
+/**
+ * dup_int - make a copy of an int.
+ * @num: pointer to the int.
+ *
+ * Return: pointer to a new int.
+ */
+static void *dup_int(void const *const num)
+{
+	int *const n = malloc(sizeof(*n));
+
+	if (n)
+		*n = *(int const *)num;
+
+	return (n);
+}
+
+TAU_MAIN()
+
+TEST(ring_deque_creation, new_returns_empty_rdq)
+{
+	ring_deque *const rdq = rdq_new();
+
+	REQUIRE(rdq, "rdq_new() returns non-null");
+	CHECK(rdq->len == 0);
+	CHECK(rdq->cap == 0);
+	CHECK(rdq->buf == NULL);
+	CHECK(rdq_pop_head(rdq) == NULL);
+	CHECK(rdq_pop_tail(rdq) == NULL);
+	CHECK(rdq_to_array(rdq, NULL, NULL) == NULL);
+	rdq_del(rdq, NULL);
+}
+
+TEST(ring_deque_creation, new_fixed_allocates_up_front)
+{
+	ring_deque *const rdq = rdq_new_fixed(3);
+
+	REQUIRE(rdq, "rdq_new_fixed() returns non-null");
+	CHECK(rdq->cap >= 3);
+	CHECK(rdq->max_len == 3);
+	CHECK(rdq_new_fixed(0) == NULL);
+	REQUIRE(rdq_push_tail(rdq, n1d, NULL));
+	REQUIRE(rdq_push_head(rdq, n2d, NULL));
+	REQUIRE(rdq_push_tail(rdq, n3d, NULL));
+	CHECK(rdq_push_tail(rdq, n1d, NULL) == NULL);
+	CHECK(rdq_push_head(rdq, n1d, NULL) == NULL);
+	CHECK(rdq_reserve(rdq, 4) == 0);
+	CHECK(rdq->len == 3);
+	CHECK_PTR_EQ(rdq_pop_head(rdq), n2d);
+	REQUIRE(rdq_push_tail(rdq, n2d, NULL));
+	CHECK_PTR_EQ(rdq_get(rdq, -1), n2d);
+	rdq_del(rdq, NULL);
+}
+
+TEST(ring_deque_creation, null_rdq_is_rejected)
+{
+	CHECK(rdq_push_head(NULL, n1d, NULL) == NULL);
+	CHECK(rdq_push_tail(NULL, n1d, NULL) == NULL);
+	CHECK(rdq_pop_head(NULL) == NULL);
+	CHECK(rdq_pop_tail(NULL) == NULL);
+	CHECK(rdq_get(NULL, 0) == NULL);
+	CHECK(rdq_reserve(NULL, 1) == 0);
+	CHECK(rdq_del(NULL, NULL) == NULL);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+struct ring_ops
+{
+	ring_deque *rdq;
+};
+
+TEST_F_SETUP(ring_ops)
+{
+	tau->rdq = rdq_new();
+	REQUIRE(tau->rdq, "rdq_new() returns non-null");
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		numbers[i] = (int)i;
+}
+
+TEST_F_TEARDOWN(ring_ops) { tau->rdq = rdq_del(tau->rdq, NULL); }
+
+TEST_F(ring_ops, push_both_ends_keeps_order)
+{
+	REQUIRE(rdq_push_tail(tau->rdq, n2d, NULL));
+	REQUIRE(rdq_push_head(tau->rdq, n1d, NULL));
+	REQUIRE(rdq_push_tail(tau->rdq, n3d, NULL));
+
+	CHECK(tau->rdq->len == 3);
+	CHECK_PTR_EQ(rdq_get(tau->rdq, 0), n1d);
+	CHECK_PTR_EQ(rdq_get(tau->rdq, 1), n2d);
+	CHECK_PTR_EQ(rdq_get(tau->rdq, -1), n3d);
+	CHECK(rdq_get(tau->rdq, 3) == NULL);
+	CHECK(rdq_get(tau->rdq, -4) == NULL);
+	CHECK_PTR_EQ(rdq_pop_tail(tau->rdq), n3d);
+	CHECK_PTR_EQ(rdq_pop_head(tau->rdq), n1d);
+	CHECK_PTR_EQ(rdq_pop_head(tau->rdq), n2d);
+	CHECK(tau->rdq->len == 0);
+}
+
+TEST_F(ring_ops, growth_unwraps_elements)
+{
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+	{
+		if (i % 2)
+			REQUIRE(rdq_push_tail(tau->rdq, &numbers[i], NULL));
+		else
+			REQUIRE(rdq_push_head(tau->rdq, &numbers[i], NULL));
+	}
+
+	CHECK(tau->rdq->cap == 128);
+	for (intmax_t i = 0; i < MANY_ITEMS / 2; ++i)
+	{
+		CHECK_PTR_EQ(rdq_get(tau->rdq, i), &numbers[MANY_ITEMS - 2 - 2 * i]);
+		CHECK_PTR_EQ(rdq_get(tau->rdq, -1 - i), &numbers[MANY_ITEMS - 1 - 2 * i]);
+	}
+}
+
+TEST_F(ring_ops, fifo_reuses_buffer)
+{
+	for (intmax_t i = 0; i < MANY_ITEMS * 10; ++i)
+	{
+		REQUIRE(rdq_push_tail(tau->rdq, &numbers[i % MANY_ITEMS], NULL));
+		if (i >= 5)
+			CHECK_PTR_EQ(
+				rdq_pop_head(tau->rdq), &numbers[(i - 5) % MANY_ITEMS]
+			);
+	}
+
+	CHECK(tau->rdq->len == 5);
+	CHECK(tau->rdq->cap == 8);
+}
+
+TEST_F(ring_ops, failed_copy_leaves_rdq_unchanged)
+{
+	REQUIRE(rdq_push_tail(tau->rdq, n1d, NULL));
+	CHECK(rdq_push_tail(tau->rdq, n2d, fail_dup) == NULL);
+	CHECK(rdq_push_head(tau->rdq, n2d, fail_dup) == NULL);
+	CHECK(tau->rdq->len == 1);
+	CHECK_PTR_EQ(rdq_get(tau->rdq, 0), n1d);
+}
+
+TEST_F(ring_ops, to_array_copies_in_order)
+{
+	for (intmax_t i = 0; i < 6; ++i)
+		REQUIRE(rdq_push_tail(tau->rdq, &numbers[i], NULL));
+
+	for (intmax_t i = 0; i < 4; ++i)
+		rdq_pop_head(tau->rdq);
+
+	for (intmax_t i = 6; i < 12; ++i)
+		REQUIRE(rdq_push_tail(tau->rdq, &numbers[i], NULL));
+
+	void **const shallow = rdq_to_array(tau->rdq, NULL, NULL);
+	int **const deep = (int **)rdq_to_array(tau->rdq, dup_int, free);
+
+	REQUIRE(shallow && deep);
+	for (intmax_t i = 0; i < 8; ++i)
+	{
+		CHECK_PTR_EQ(shallow[i], &numbers[i + 4]);
+		CHECK(*deep[i] == i + 4);
+		free(deep[i]);
+	}
+
+	CHECK(shallow[8] == NULL);
+	CHECK(deep[8] == NULL);
+	free(shallow);
+	free(deep);
+}
+
+TEST_F(ring_ops, clear_frees_copies)
+{
+	for (intmax_t i = 0; i < MANY_ITEMS; ++i)
+		REQUIRE(rdq_push_head(tau->rdq, &numbers[i], dup_int));
+
+	rdq_clear(tau->rdq, free);
+	CHECK(tau->rdq->len == 0);
+	CHECK(tau->rdq->cap == 128);
+	CHECK(rdq_get(tau->rdq, 0) == NULL);
+}
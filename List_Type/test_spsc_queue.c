@@ -0,0 +1,151 @@
+#include <pthread.h>
+#include <stdint.h> /* uintptr_t */
+#include <stdlib.h> /* free */
+
+#include "list_type_structs.h"
+#include "spsc_queue.h"
+#include "tau/tau.h"
+
+#define N_MESSAGES ((uintptr_t)200000)
+
+static char n1d[] = "one", n2d[] = "two", n3d[] = "three";
+
+/**
+ * produce - push the numbers 1 to `N_MESSAGES` in batches of varying size.
+ * @arg: the queue.
+ *
+ * Return: NULL.
+ */
+static void *produce(void *arg)
+{
+	spsc_queue *const q = arg;
+	void *batch[7];
+	uintptr_t next = 1;
+
+	while (next <= N_MESSAGES)
+	{
+		size_t n = 0;
+
+		while (n < 1 + next % 7 && next + n <= N_MESSAGES)
+		{
+			batch[n] = (void *)(next + n);
+			++n;
+		}
+
+		size_t done = 0;
+
+		while (done < n)
+			done += spscq_push_n(q, batch + done, n - done);
+
+		next += n;
+	}
+
+	return (NULL);
+}
+
+TAU_MAIN()
+
+TEST(spsc_creation, capacity_is_rounded_up)
+{
+	spsc_queue *const q = spscq_new(5);
+
+	REQUIRE(q, "spscq_new() returns non-null");
+	CHECK(spscq_capacity(q) == 8);
+	CHECK(spscq_len(q) == 0);
+	CHECK(spscq_new(0) == NULL);
+	spscq_del(q, NULL);
+}
+
+TEST(spsc_creation, null_queue_is_rejected)
+{
+	void *d = NULL;
+
+	CHECK(spscq_push(NULL, n1d) == 0);
+	CHECK(spscq_pop(NULL, &d) == 0);
+	CHECK(spscq_push_n(NULL, &d, 1) == 0);
+	CHECK(spscq_pop_n(NULL, &d, 1) == 0);
+	CHECK(spscq_len(NULL) == 0);
+	CHECK(spscq_del(NULL, NULL) == NULL);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+struct spsc_ops
+{
+	spsc_queue *q;
+};
+
+TEST_F_SETUP(spsc_ops)
+{
+	tau->q = spscq_new(4);
+	REQUIRE(tau->q, "spscq_new() returns non-null");
+}
+
+TEST_F_TEARDOWN(spsc_ops) { tau->q = spscq_del(tau->q, NULL); }
+
+TEST_F(spsc_ops, fifo_order_and_full_queue)
+{
+	void *d = NULL;
+
+	CHECK(spscq_pop(tau->q, &d) == 0);
+	REQUIRE(spscq_push(tau->q, n1d));
+	REQUIRE(spscq_push(tau->q, n2d));
+	REQUIRE(spscq_push(tau->q, n3d));
+	REQUIRE(spscq_push(tau->q, NULL));
+	CHECK(spscq_push(tau->q, n1d) == 0);
+	CHECK(spscq_len(tau->q) == 4);
+
+	REQUIRE(spscq_pop(tau->q, &d));
+	CHECK_PTR_EQ(d, n1d);
+	REQUIRE(spscq_pop(tau->q, &d));
+	CHECK_PTR_EQ(d, n2d);
+	REQUIRE(spscq_pop(tau->q, &d));
+	CHECK_PTR_EQ(d, n3d);
+	REQUIRE(spscq_pop(tau->q, &d));
+	CHECK(d == NULL);
+	CHECK(spscq_pop(tau->q, &d) == 0);
+}
+
+TEST_F(spsc_ops, batches_wrap_around)
+{
+	void *in[] = {n1d, n2d, n3d, n1d, n2d}, *out[5] = {NULL};
+
+	CHECK(spscq_push_n(tau->q, in, 3) == 3);
+	CHECK(spscq_pop_n(tau->q, out, 2) == 2);
+	CHECK(spscq_push_n(tau->q, in + 1, 4) == 3);
+	CHECK(spscq_len(tau->q) == 4);
+	CHECK(spscq_pop_n(tau->q, out, 5) == 4);
+	CHECK_PTR_EQ(out[0], n3d);
+	CHECK_PTR_EQ(out[1], n2d);
+	CHECK_PTR_EQ(out[2], n3d);
+	CHECK_PTR_EQ(out[3], n1d);
+	CHECK(spscq_pop_n(tau->q, out, 5) == 0);
+}
+
+TEST(spsc_threads, messages_arrive_in_order)
+{
+	spsc_queue *const q = spscq_new(64);
+	pthread_t producer;
+	void *batch[5];
+	uintptr_t expect = 1, out_of_order = 0;
+
+	REQUIRE(q, "spscq_new() returns non-null");
+	REQUIRE(pthread_create(&producer, NULL, produce, q) == 0);
+	while (expect <= N_MESSAGES)
+	{
+		const size_t n = spscq_pop_n(q, batch, 1 + expect % 5);
+
+		for (size_t i = 0; i < n; ++i, ++expect)
+		{
+			if ((uintptr_t)batch[i] != expect)
+				++out_of_order;
+		}
+	}
+
+	pthread_join(producer, NULL);
+	CHECK(expect == N_MESSAGES + 1);
+	CHECK(out_of_order == 0);
+	CHECK(spscq_len(q) == 0);
+	spscq_del(q, NULL);
+}
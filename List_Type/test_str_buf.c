@@ -0,0 +1,100 @@
+#include <stdlib.h> /* free */
+#include <string.h> /* memset, strlen */
+
+#include "list_type_structs.h"
+#include "str_buf.h"
+#include "tau/tau.h"
+
+#define LONG_LEN (1000)
+
+TAU_MAIN()
+
+TEST(str_buf_memory, empty_buffer_releases_empty_string)
+{
+	str_buf sb;
+
+	strbuf_init(&sb, NULL);
+	CHECK(sb.str == NULL);
+	CHECK(sb.len == 0);
+
+	char *const s = strbuf_release(&sb);
+
+	REQUIRE(s);
+	CHECK_STREQ(s, "");
+	CHECK(sb.str == NULL);
+	free(s);
+}
+
+TEST(str_buf_memory, writes_are_appended)
+{
+	str_buf sb;
+
+	strbuf_init(&sb, NULL);
+	REQUIRE(strbuf_puts(&sb, "one"));
+	REQUIRE(strbuf_write(&sb, " <--> two", 6));
+	REQUIRE(strbuf_printf(&sb, "%s%d", "two", 2));
+	CHECK(sb.len == strlen("one <--> two2"));
+	CHECK_STREQ(sb.str, "one <--> two2");
+	strbuf_free(&sb);
+	CHECK(sb.str == NULL);
+	CHECK(sb.len == 0);
+}
+
+TEST(str_buf_memory, capacity_grows_geometrically)
+{
+	char long_str[LONG_LEN + 1];
+	str_buf sb;
+
+	memset(long_str, 'x', LONG_LEN);
+	long_str[LONG_LEN] = '\0';
+	strbuf_init(&sb, NULL);
+	REQUIRE(strbuf_puts(&sb, "a"));
+
+	const size_t first_cap = sb.cap;
+
+	REQUIRE(strbuf_printf(&sb, "%s", long_str));
+	CHECK(sb.len == LONG_LEN + 1);
+	CHECK(sb.cap > LONG_LEN + 1);
+	CHECK(sb.cap / first_cap * first_cap == sb.cap);
+	CHECK(sb.str[LONG_LEN + 1] == '\0');
+	CHECK(sb.str[LONG_LEN] == 'x');
+
+	char *const s = strbuf_release(&sb);
+
+	REQUIRE(s);
+	CHECK(strlen(s) == LONG_LEN + 1);
+	free(s);
+}
+
+TEST(str_buf_memory, null_arguments_fail)
+{
+	str_buf sb;
+
+	strbuf_init(&sb, NULL);
+	CHECK(strbuf_puts(NULL, "a") == 0);
+	CHECK(strbuf_puts(&sb, NULL) == 0);
+	CHECK(strbuf_write(&sb, NULL, 1) == 0);
+	CHECK(strbuf_printf(NULL, "%d", 1) == 0);
+	CHECK(strbuf_release(NULL) == NULL);
+	CHECK(sb.failed == 0);
+	strbuf_free(&sb);
+}
+
+TEST(str_buf_stream, writes_go_to_the_stream)
+{
+	FILE *const stream = tmpfile();
+	char out[32] = {'\0'};
+	str_buf sb;
+
+	REQUIRE(stream);
+	strbuf_init(&sb, stream);
+	REQUIRE(strbuf_puts(&sb, "one"));
+	REQUIRE(strbuf_printf(&sb, " %d", 2));
+	CHECK(sb.len == 5);
+	CHECK(sb.str == NULL);
+	CHECK(strbuf_release(&sb) == NULL);
+	rewind(stream);
+	REQUIRE(fgets(out, sizeof(out), stream));
+	CHECK_STREQ(out, "one 2");
+	fclose(stream);
+}
@@ -0,0 +1,176 @@
+#include <pthread.h>
+#include <stdint.h> /* uintptr_t */
+#include <stdlib.h> /* free */
+
+#include "list_type_structs.h"
+#include "tau/tau.h"
+#include "ws_deque.h"
+
+#define N_THIEVES (3)
+#define N_ITEMS ((uintptr_t)100000)
+
+static char n1d[] = "one", n2d[] = "two", n3d[] = "three";
+
+/**
+ * struct ws_run - state of a multi-threaded test.
+ * @wsdq: the deque.
+ * @done: set by the owner once it has nothing left to push.
+ * @seen: number of times each item was taken.
+ */
+struct ws_run
+{
+	ws_deque *wsdq;
+	atomic_int done;
+	atomic_uchar seen[N_ITEMS];
+};
+
+/**
+ * steal - steal items until the owner is done and the deque is empty.
+ * @arg: the test state.
+ *
+ * Return: NULL.
+ */
+static void *steal(void *arg)
+{
+	struct ws_run *const run = arg;
+	void *d = NULL;
+
+	for (;;)
+	{
+		const int done = atomic_load(&run->done);
+		const int got = wsdq_steal_head(run->wsdq, &d);
+
+		if (got == 1)
+			atomic_fetch_add(&run->seen[(uintptr_t)d], 1);
+		else if (got == 0 && done)
+			break;
+	}
+
+	return (NULL);
+}
+
+TAU_MAIN()
+
+TEST(ws_deque_creation, null_wsdq_is_rejected)
+{
+	void *d = NULL;
+
+	CHECK(wsdq_push_tail(NULL, n1d) == 0);
+	CHECK(wsdq_pop_tail(NULL, &d) == 0);
+	CHECK(wsdq_steal_head(NULL, &d) == 0);
+	CHECK(wsdq_len(NULL) == 0);
+	CHECK(wsdq_del(NULL, NULL) == NULL);
+}
+
+TEST(ws_deque_creation, del_frees_remaining_data)
+{
+	ws_deque *const wsdq = wsdq_new(0);
+
+	REQUIRE(wsdq, "wsdq_new() returns non-null");
+	for (int i = 0; i < 5; ++i)
+	{
+		int *const n = malloc(sizeof(*n));
+
+		REQUIRE(n);
+		REQUIRE(wsdq_push_tail(wsdq, n));
+	}
+
+	wsdq_del(wsdq, free);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+struct ws_ops
+{
+	ws_deque *wsdq;
+};
+
+TEST_F_SETUP(ws_ops)
+{
+	tau->wsdq = wsdq_new(2);
+	REQUIRE(tau->wsdq, "wsdq_new() returns non-null");
+}
+
+TEST_F_TEARDOWN(ws_ops) { tau->wsdq = wsdq_del(tau->wsdq, NULL); }
+
+TEST_F(ws_ops, owner_is_lifo_thief_is_fifo)
+{
+	void *d = NULL;
+
+	CHECK(wsdq_pop_tail(tau->wsdq, &d) == 0);
+	CHECK(wsdq_steal_head(tau->wsdq, &d) == 0);
+	REQUIRE(wsdq_push_tail(tau->wsdq, n1d));
+	REQUIRE(wsdq_push_tail(tau->wsdq, n2d));
+	REQUIRE(wsdq_push_tail(tau->wsdq, n3d));
+	CHECK(wsdq_len(tau->wsdq) == 3);
+
+	REQUIRE(wsdq_steal_head(tau->wsdq, &d) == 1);
+	CHECK_PTR_EQ(d, n1d);
+	REQUIRE(wsdq_pop_tail(tau->wsdq, &d));
+	CHECK_PTR_EQ(d, n3d);
+	REQUIRE(wsdq_pop_tail(tau->wsdq, &d));
+	CHECK_PTR_EQ(d, n2d);
+	CHECK(wsdq_pop_tail(tau->wsdq, &d) == 0);
+	CHECK(wsdq_steal_head(tau->wsdq, &d) == 0);
+	CHECK(wsdq_len(tau->wsdq) == 0);
+}
+
+TEST_F(ws_ops, growth_keeps_wrapped_elements)
+{
+	void *d = NULL;
+
+	for (uintptr_t i = 1; i <= 3; ++i)
+		REQUIRE(wsdq_push_tail(tau->wsdq, (void *)i));
+
+	for (uintptr_t i = 1; i <= 2; ++i)
+		REQUIRE(wsdq_steal_head(tau->wsdq, &d) == 1);
+
+	for (uintptr_t i = 4; i <= 100; ++i)
+		REQUIRE(wsdq_push_tail(tau->wsdq, (void *)i));
+
+	CHECK(wsdq_len(tau->wsdq) == 98);
+	REQUIRE(wsdq_steal_head(tau->wsdq, &d) == 1);
+	CHECK(d == (void *)3);
+	for (uintptr_t i = 100; i > 3; --i)
+	{
+		REQUIRE(wsdq_pop_tail(tau->wsdq, &d));
+		CHECK(d == (void *)i);
+	}
+
+	CHECK(wsdq_len(tau->wsdq) == 0);
+}
+
+TEST(ws_deque_threads, every_item_is_taken_once)
+{
+	static struct ws_run run;
+	pthread_t thieves[N_THIEVES];
+	void *d = NULL;
+
+	run.wsdq = wsdq_new(16);
+	REQUIRE(run.wsdq, "wsdq_new() returns non-null");
+	for (int i = 0; i < N_THIEVES; ++i)
+		REQUIRE(pthread_create(&thieves[i], NULL, steal, &run) == 0);
+
+	for (uintptr_t i = 0; i < N_ITEMS; ++i)
+	{
+		REQUIRE(wsdq_push_tail(run.wsdq, (void *)i));
+		if (i % 3 == 0 && wsdq_pop_tail(run.wsdq, &d))
+			atomic_fetch_add(&run.seen[(uintptr_t)d], 1);
+	}
+
+	while (wsdq_pop_tail(run.wsdq, &d))
+		atomic_fetch_add(&run.seen[(uintptr_t)d], 1);
+
+	atomic_store(&run.done, 1);
+	for (int i = 0; i < N_THIEVES; ++i)
+		pthread_join(thieves[i], NULL);
+
+	uintptr_t wrong = 0;
+
+	for (uintptr_t i = 0; i < N_ITEMS; ++i)
+		wrong += run.seen[i] != 1;
+
+	CHECK(wrong == 0);
+	run.wsdq = wsdq_del(run.wsdq, NULL);
+}
@@ -0,0 +1,288 @@
+#include <stdint.h> /* SIZE_MAX */
+#include <stdlib.h> /* *alloc */
+
+#include "list_type_structs.h"
+#include "ws_deque.h"
+
+/**
+ * struct wsdq_buffer - a ring of slots of a `ws_deque`.
+ * @mask: number of slots minus 1, the number of slots is a power of 2.
+ * @next: the next retired ring.
+ * @slots: the slots, indexed by the deque's indices masked with `mask`.
+ */
+struct wsdq_buffer
+{
+	size_t mask;
+	struct wsdq_buffer *next;
+	_Atomic(void *) slots[];
+};
+
+/**
+ * wsdq_buffer_new - allocate a ring of slots.
+ * @len: number of slots, a power of 2.
+ *
+ * Return: pointer to the ring, NULL on failure.
+ */
+static struct wsdq_buffer *wsdq_buffer_new(const size_t len)
+{
+	if (len > (SIZE_MAX - sizeof(struct wsdq_buffer)) / sizeof(void *))
+		return (NULL);
+
+	struct wsdq_buffer *const buf =
+		malloc(sizeof(*buf) + sizeof(*buf->slots) * len);
+
+	if (buf)
+	{
+		buf->mask = len - 1;
+		buf->next = NULL;
+	}
+
+	return (buf);
+}
+
+/**
+ * wsdq_grow - move the elements of a `ws_deque` to a ring twice as big.
+ * @wsdq: the deque.
+ * @old: the current ring.
+ * @head: index of the oldest element.
+ * @tail: index one past the newest element.
+ *
+ * The old ring stays readable for thieves that loaded it before the switch.
+ *
+ * Return: pointer to the new ring, NULL on failure.
+ */
+static struct wsdq_buffer *wsdq_grow(
+	ws_deque *const restrict wsdq, struct wsdq_buffer *const old,
+	const intmax_t head, const intmax_t tail
+)
+{
+	if (old->mask + 1 > SIZE_MAX / 2)
+		return (NULL);
+
+	struct wsdq_buffer *const buf = wsdq_buffer_new((old->mask + 1) * 2);
+
+	if (!buf)
+		return (NULL);
+
+	for (intmax_t i = head; i < tail; ++i)
+	{
+		atomic_store_explicit(
+			&buf->slots[(size_t)i & buf->mask],
+			atomic_load_explicit(
+				&old->slots[(size_t)i & old->mask], memory_order_relaxed
+			),
+			memory_order_relaxed
+		);
+	}
+
+	old->next = wsdq->retired;
+	wsdq->retired = old;
+	atomic_store_explicit(&wsdq->buf, buf, memory_order_release);
+	return (buf);
+}
+
+/**
+ * wsdq_new - allocate a `ws_deque`.
+ * @capacity: initial number of slots, rounded up to a power of 2. The deque
+ * grows as needed.
+ *
+ * Return: pointer to the new deque, NULL on failure.
+ */
+ws_deque *wsdq_new(const size_t capacity)
+{
+	size_t slots = 2;
+
+	while (slots < capacity)
+	{
+		if (slots > SIZE_MAX / 2)
+			return (NULL);
+
+		slots <<= 1;
+	}
+
+	ws_deque *const wsdq = aligned_alloc(LT_CACHE_LINE, sizeof(*wsdq));
+	struct wsdq_buffer *const buf = wsdq_buffer_new(slots);
+
+	if (!wsdq || !buf)
+	{
+		free(wsdq);
+		free(buf);
+		return (NULL);
+	}
+
+	atomic_init(&wsdq->head, 0);
+	atomic_init(&wsdq->tail, 0);
+	atomic_init(&wsdq->buf, buf);
+	wsdq->retired = NULL;
+	return (wsdq);
+}
+
+/**
+ * wsdq_del - free a `ws_deque`, no thread may be using it.
+ * @wsdq: the deque.
+ * @free_data: optional function that will be called on the remaining data.
+ *
+ * Return: NULL always.
+ */
+void *wsdq_del(ws_deque *const restrict wsdq, free_func *free_data)
+{
+	if (!wsdq)
+		return (NULL);
+
+	void *data = NULL;
+
+	while (free_data && wsdq_pop_tail(wsdq, &data))
+		free_data(data);
+
+	while (wsdq->retired)
+	{
+		struct wsdq_buffer *const next = wsdq->retired->next;
+
+		free(wsdq->retired);
+		wsdq->retired = next;
+	}
+
+	free(atomic_load_explicit(&wsdq->buf, memory_order_relaxed));
+	free(wsdq);
+	return (NULL);
+}
+
+/**
+ * wsdq_push_tail - add an element to the tail, to be called by the owner
+ * only.
+ * @wsdq: the deque.
+ * @data: the element.
+ *
+ * Only plain loads and stores are used, no read-modify-write.
+ *
+ * Return: 1 on success, 0 if the deque had to grow and allocation failed.
+ */
+int wsdq_push_tail(ws_deque *const restrict wsdq, void *const data)
+{
+	if (!wsdq)
+		return (0);
+
+	const intmax_t tail =
+		atomic_load_explicit(&wsdq->tail, memory_order_relaxed);
+	const intmax_t head =
+		atomic_load_explicit(&wsdq->head, memory_order_acquire);
+	struct wsdq_buffer *buf =
+		atomic_load_explicit(&wsdq->buf, memory_order_relaxed);
+
+	if ((size_t)(tail - head) > buf->mask)
+	{
+		buf = wsdq_grow(wsdq, buf, head, tail);
+		if (!buf)
+			return (0);
+	}
+
+	atomic_store_explicit(
+		&buf->slots[(size_t)tail & buf->mask], data, memory_order_relaxed
+	);
+	atomic_store_explicit(&wsdq->tail, tail + 1, memory_order_release);
+	return (1);
+}
+
+/**
+ * wsdq_pop_tail - remove the newest element, to be called by the owner only.
+ * @wsdq: the deque.
+ * @data: out parameter for the element.
+ *
+ * A CAS is only needed when a thief could be taking the same element, that
+ * is when a single element is left.
+ *
+ * Return: 1 on success, 0 if the deque is empty.
+ */
+int wsdq_pop_tail(ws_deque *const restrict wsdq, void **const restrict data)
+{
+	if (!wsdq || !data)
+		return (0);
+
+	const intmax_t tail =
+		atomic_load_explicit(&wsdq->tail, memory_order_relaxed) - 1;
+	struct wsdq_buffer *const buf =
+		atomic_load_explicit(&wsdq->buf, memory_order_relaxed);
+
+	atomic_store_explicit(&wsdq->tail, tail, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+
+	intmax_t head = atomic_load_explicit(&wsdq->head, memory_order_relaxed);
+
+	if (head > tail)
+	{
+		atomic_store_explicit(&wsdq->tail, tail + 1, memory_order_relaxed);
+		return (0);
+	}
+
+	*data = atomic_load_explicit(
+		&buf->slots[(size_t)tail & buf->mask], memory_order_relaxed
+	);
+	if (head < tail)
+		return (1);
+
+	const int won = atomic_compare_exchange_strong_explicit(
+		&wsdq->head, &head, head + 1, memory_order_seq_cst,
+		memory_order_relaxed
+	);
+
+	atomic_store_explicit(&wsdq->tail, tail + 1, memory_order_relaxed);
+	return (won);
+}
+
+/**
+ * wsdq_steal_head - remove the oldest element, may be called by any thread.
+ * @wsdq: the deque.
+ * @data: out parameter for the element.
+ *
+ * Return: 1 on success, 0 if the deque is empty, -1 if another thread took
+ * the element first, in which case the deque may still have elements.
+ */
+int wsdq_steal_head(ws_deque *const restrict wsdq, void **const restrict data)
+{
+	if (!wsdq || !data)
+		return (0);
+
+	intmax_t head = atomic_load_explicit(&wsdq->head, memory_order_acquire);
+
+	atomic_thread_fence(memory_order_seq_cst);
+
+	const intmax_t tail =
+		atomic_load_explicit(&wsdq->tail, memory_order_acquire);
+
+	if (head >= tail)
+		return (0);
+
+	struct wsdq_buffer *const buf =
+		atomic_load_explicit(&wsdq->buf, memory_order_acquire);
+	void *const d = atomic_load_explicit(
+		&buf->slots[(size_t)head & buf->mask], memory_order_relaxed
+	);
+
+	if (!atomic_compare_exchange_strong_explicit(
+			&wsdq->head, &head, head + 1, memory_order_seq_cst,
+			memory_order_relaxed
+		))
+		return (-1);
+
+	*data = d;
+	return (1);
+}
+
+/**
+ * wsdq_len - number of elements in a `ws_deque`.
+ * @wsdq: the deque.
+ *
+ * Return: the number of elements, only a snapshot while thieves run.
+ */
+intmax_t wsdq_len(const ws_deque *const restrict wsdq)
+{
+	if (!wsdq)
+		return (0);
+
+	const intmax_t head =
+		atomic_load_explicit(&wsdq->head, memory_order_acquire);
+	const intmax_t tail =
+		atomic_load_explicit(&wsdq->tail, memory_order_acquire);
+
+	return (tail > head ? tail - head : 0);
+}
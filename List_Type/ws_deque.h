@@ -0,0 +1,29 @@
+#ifndef DS_WS_DEQUE_TYPE_H
+#define DS_WS_DEQUE_TYPE_H
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* intmax_t */
+
+#include "attribute_macros.h"
+#include "list_type_typedefs.h"
+
+/* alloc and free */
+
+void *wsdq_del(ws_deque *const restrict wsdq, free_func *free_data);
+ws_deque *
+wsdq_new(const size_t capacity) ATTR_MALLOC ATTR_MALLOC_FREE(wsdq_del);
+
+/* owner */
+
+int wsdq_push_tail(ws_deque *const restrict wsdq, void *const data);
+int wsdq_pop_tail(ws_deque *const restrict wsdq, void **const restrict data);
+
+/* thieves */
+
+int wsdq_steal_head(ws_deque *const restrict wsdq, void **const restrict data);
+
+/* info */
+
+intmax_t wsdq_len(const ws_deque *const restrict wsdq);
+
+#endif /* DS_WS_DEQUE_TYPE_H */
@@ -0,0 +1,245 @@
+/* clock_gettime, nanosleep */
+#define _GNU_SOURCE
+
+#include <sched.h>  /* sched_yield */
+#include <stdint.h> /* uintptr_t */
+#include <time.h>   /* clock_gettime, nanosleep */
+#include <unistd.h> /* sysconf */
+
+#include "thread_pool.h"
+#include "tau/tau.h"
+
+#define N_TASKS (5000)
+#define SUM_LEN ((size_t)1 << 16)
+#define SUM_CUTOFF ((size_t)256)
+
+static atomic_int counter;
+static thread_pool *fib_pool;
+static long numbers[SUM_LEN];
+
+/**
+ * count - increment the shared counter.
+ * @arg: unused.
+ */
+static void count(void *arg)
+{
+	(void)arg;
+	atomic_fetch_add(&counter, 1);
+}
+
+/**
+ * nap - sleep for a tenth of a second.
+ * @arg: an `atomic_int` set once the task has started.
+ */
+static void nap(void *arg)
+{
+	const struct timespec tenth = {.tv_nsec = 100000000L};
+
+	atomic_store((atomic_int *)arg, 1);
+	nanosleep(&tenth, NULL);
+}
+
+/**
+ * cpu_ms - CPU time used by the calling thread.
+ *
+ * Return: the time in milliseconds.
+ */
+static long cpu_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (ts.tv_sec * 1000L + ts.tv_nsec / 1000000L);
+}
+
+/**
+ * struct fib_arg - argument of a fibonacci task.
+ * @n: the index of the number to compute.
+ * @result: the computed number.
+ */
+struct fib_arg
+{
+	int n;
+	long result;
+};
+
+/**
+ * fib - compute a fibonacci number, forking one task per call.
+ * @arg: the `fib_arg`.
+ */
+static void fib(void *arg)
+{
+	struct fib_arg *const f = arg;
+
+	if (f->n < 2)
+	{
+		f->result = f->n;
+		return;
+	}
+
+	struct fib_arg left = {.n = f->n - 1}, right = {.n = f->n - 2};
+	tp_group group;
+
+	tpool_group_init(&group);
+	tpool_spawn(fib_pool, &group, fib, &left);
+	fib(&right);
+	tpool_sync(fib_pool, &group);
+	f->result = left.result + right.result;
+}
+
+/**
+ * struct sum_arg - argument of a summing task.
+ * @pool: the pool to fork on.
+ * @start: first number to add.
+ * @len: number of numbers to add.
+ * @result: the sum.
+ */
+struct sum_arg
+{
+	thread_pool *pool;
+	const long *start;
+	size_t len;
+	long result;
+};
+
+/**
+ * sum - add numbers, splitting the range in two until it is small.
+ * @arg: the `sum_arg`.
+ */
+static void sum(void *arg)
+{
+	struct sum_arg *const s = arg;
+
+	s->result = 0;
+	if (s->len <= SUM_CUTOFF)
+	{
+		for (size_t i = 0; i < s->len; ++i)
+			s->result += s->start[i];
+
+		return;
+	}
+
+	struct sum_arg halves[2] = {
+		{.pool = s->pool, .start = s->start, .len = s->len / 2},
+		{.pool = s->pool,
+		 .start = s->start + s->len / 2,
+		 .len = s->len - s->len / 2},
+	};
+	tp_group group;
+
+	tpool_group_init(&group);
+	tpool_spawn(s->pool, &group, sum, &halves[0]);
+	tpool_spawn(s->pool, &group, sum, &halves[1]);
+	tpool_sync(s->pool, &group);
+	s->result = halves[0].result + halves[1].result;
+}
+
+TAU_MAIN()
+
+TEST(thread_pool_creation, default_size_is_cpu_count)
+{
+	thread_pool *const pool = tpool_new(0);
+
+	REQUIRE(pool, "tpool_new() returns non-null");
+	CHECK(tpool_size(pool) == (size_t)sysconf(_SC_NPROCESSORS_ONLN));
+	tpool_del(pool);
+}
+
+TEST(thread_pool_creation, null_arguments_are_rejected)
+{
+	thread_pool *const pool = tpool_new(1);
+	tp_group group;
+
+	REQUIRE(pool, "tpool_new() returns non-null");
+	tpool_group_init(&group);
+	CHECK(tpool_spawn(NULL, &group, count, NULL) == 0);
+	CHECK(tpool_spawn(pool, NULL, count, NULL) == 0);
+	CHECK(tpool_spawn(pool, &group, NULL, NULL) == 0);
+	CHECK(tpool_size(NULL) == 0);
+	CHECK(tpool_del(NULL) == NULL);
+	tpool_sync(pool, &group);
+	tpool_del(pool);
+}
+
+/* ###################################################################### */
+/* ###################################################################### */
+
+struct thread_pool_ops
+{
+	thread_pool *pool;
+};
+
+TEST_F_SETUP(thread_pool_ops)
+{
+	tau->pool = tpool_new(4);
+	REQUIRE(tau->pool, "tpool_new() returns non-null");
+	atomic_store(&counter, 0);
+}
+
+TEST_F_TEARDOWN(thread_pool_ops) { tau->pool = tpool_del(tau->pool); }
+
+TEST_F(thread_pool_ops, sync_waits_for_external_spawns)
+{
+	tp_group group;
+
+	tpool_group_init(&group);
+	for (int i = 0; i < N_TASKS; ++i)
+		REQUIRE(tpool_spawn(tau->pool, &group, count, NULL));
+
+	tpool_sync(tau->pool, &group);
+	CHECK(atomic_load(&counter) == N_TASKS);
+	CHECK(atomic_load(&group.pending) == 0);
+}
+
+TEST_F(thread_pool_ops, external_sync_sleeps_on_long_tasks)
+{
+	tp_group group;
+	atomic_int started = 0;
+	long start = 0;
+
+	tpool_group_init(&group);
+	REQUIRE(tpool_spawn(tau->pool, &group, nap, &started));
+	/* A worker runs the task, the syncing thread has nothing to steal. */
+	while (!atomic_load(&started))
+		sched_yield();
+
+	start = cpu_ms();
+	tpool_sync(tau->pool, &group);
+	CHECK(atomic_load(&group.pending) == 0);
+	CHECK(cpu_ms() - start < 50, "a thread waiting in sync should park");
+}
+
+TEST_F(thread_pool_ops, del_runs_spawned_tasks)
+{
+	tp_group group;
+
+	tpool_group_init(&group);
+	for (int i = 0; i < 100; ++i)
+		REQUIRE(tpool_spawn(tau->pool, &group, count, NULL));
+
+	tau->pool = tpool_del(tau->pool);
+	CHECK(atomic_load(&counter) == 100);
+}
+
+TEST_F(thread_pool_ops, nested_fork_join)
+{
+	struct fib_arg f = {.n = 20};
+
+	fib_pool = tau->pool;
+	fib(&f);
+	CHECK(f.result == 6765);
+}
+
+TEST_F(thread_pool_ops, divide_and_conquer_sum)
+{
+	struct sum_arg s = {.pool = tau->pool, .start = numbers, .len = SUM_LEN};
+	tp_group group;
+
+	for (size_t i = 0; i < SUM_LEN; ++i)
+		numbers[i] = (long)i;
+
+	tpool_group_init(&group);
+	REQUIRE(tpool_spawn(tau->pool, &group, sum, &s));
+	tpool_sync(tau->pool, &group);
+	CHECK(s.result == (long)(SUM_LEN * (SUM_LEN - 1) / 2));
+}
@@ -0,0 +1,556 @@
+/* syscall */
+#define _GNU_SOURCE
+
+#include <limits.h>        /* INT_MAX */
+#include <linux/futex.h>   /* FUTEX_* */
+#include <pthread.h>       /* pthread_* */
+#include <sched.h>         /* sched_yield */
+#include <stdint.h>        /* uint32_t */
+#include <stdlib.h>        /* *alloc */
+#include <sys/syscall.h>   /* SYS_futex */
+#include <unistd.h>        /* syscall, sysconf */
+
+#include "list_type_structs.h"
+#include "mpmc_queue.h"
+#include "thread_pool.h"
+#include "ws_deque.h"
+
+/* Size of the queue of tasks spawned from outside the pool. */
+#define TPOOL_INJECT_LEN ((size_t)1024)
+/* Rounds of stealing an idle worker tries before parking. */
+#define TPOOL_SPINS (64U)
+/* Finished tasks a worker keeps for reuse. */
+#define TPOOL_TASK_CACHE (256U)
+
+/**
+ * struct tp_task - a spawned task.
+ * @func: the function to run.
+ * @arg: argument to `func`.
+ * @group: the group to signal once `func` returns.
+ * @next: next task in a worker's cache of free tasks.
+ */
+struct tp_task
+{
+	tp_task_func *func;
+	void *arg;
+	tp_group *group;
+	struct tp_task *next;
+};
+
+/**
+ * struct tp_worker - a worker thread and its deque of tasks.
+ * @tasks: the worker's deque, pushed and popped by the worker only.
+ * @pool: the pool the worker belongs to.
+ * @free_tasks: finished tasks kept for reuse.
+ * @n_free: number of tasks in `free_tasks`.
+ * @rng: state of the random generator used to pick victims.
+ * @thread: the thread.
+ */
+struct tp_worker
+{
+	ws_deque *tasks;
+	thread_pool *pool;
+	struct tp_task *free_tasks;
+	size_t n_free;
+	uint64_t rng;
+	pthread_t thread;
+};
+
+/**
+ * struct thread_pool - a fixed set of work-stealing workers.
+ * @inject: tasks spawned by threads that are not workers of the pool.
+ * @epoch: futex word, bumped every time parked workers should wake up.
+ * @n_parked: number of workers that are parked or about to park.
+ * @sync_epoch: futex word, bumped every time a group's last task finishes
+ * while other threads are waiting in `tpool_sync`.
+ * @n_syncing: number of such threads that are parked or about to park.
+ * @stop: set when the pool is being deleted.
+ * @n_workers: number of workers.
+ * @n_started: number of worker threads that were started.
+ * @workers: the workers.
+ */
+struct thread_pool
+{
+	mpmc_queue *inject;
+	_Alignas(LT_CACHE_LINE) atomic_uint epoch;
+	atomic_uint n_parked;
+	_Alignas(LT_CACHE_LINE) atomic_uint sync_epoch;
+	atomic_uint n_syncing;
+	atomic_int stop;
+	size_t n_workers;
+	size_t n_started;
+	struct tp_worker *workers;
+};
+
+/* The worker running on this thread, NULL outside of any pool. */
+static _Thread_local struct tp_worker *tp_self;
+
+/**
+ * tp_rand - xorshift random generator.
+ * @state: the generator's state, must not be 0.
+ *
+ * Return: the next random number.
+ */
+static uint64_t tp_rand(uint64_t *const restrict state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+	return (*state);
+}
+
+/**
+ * tp_worker_of - get the worker of the calling thread.
+ * @pool: the pool.
+ *
+ * Return: the worker, NULL if the calling thread is not a worker of `pool`.
+ */
+static struct tp_worker *tp_worker_of(const thread_pool *const restrict pool)
+{
+	return (tp_self && tp_self->pool == pool ? tp_self : NULL);
+}
+
+/**
+ * tp_wake - wake a parked worker if there is one.
+ * @pool: the pool.
+ *
+ * The caller must have published the work the worker should find.
+ */
+static void tp_wake(thread_pool *const restrict pool)
+{
+	atomic_thread_fence(memory_order_seq_cst);
+	if (!atomic_load_explicit(&pool->n_parked, memory_order_relaxed))
+		return;
+
+	atomic_fetch_add_explicit(&pool->epoch, 1, memory_order_seq_cst);
+	syscall(SYS_futex, &pool->epoch, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+/**
+ * tp_wake_syncers - wake the threads parked in `tpool_sync`.
+ * @pool: the pool.
+ *
+ * The caller must have published the end of the group they wait on. Every
+ * parked thread is woken as they may wait on different groups, those whose
+ * group is not done yet park again.
+ */
+static void tp_wake_syncers(thread_pool *const restrict pool)
+{
+	atomic_thread_fence(memory_order_seq_cst);
+	if (!atomic_load_explicit(&pool->n_syncing, memory_order_relaxed))
+		return;
+
+	atomic_fetch_add_explicit(&pool->sync_epoch, 1, memory_order_seq_cst);
+	syscall(
+		SYS_futex, &pool->sync_epoch, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL,
+		0
+	);
+}
+
+/**
+ * tp_task_new - get a task from the calling worker's cache or the heap.
+ * @self: the calling worker, NULL for other threads.
+ *
+ * Return: pointer to the task, NULL on failure.
+ */
+static struct tp_task *tp_task_new(struct tp_worker *const restrict self)
+{
+	if (!self || !self->free_tasks)
+		return (malloc(sizeof(struct tp_task)));
+
+	struct tp_task *const task = self->free_tasks;
+
+	self->free_tasks = task->next;
+	--(self->n_free);
+	return (task);
+}
+
+/**
+ * tp_task_run - run a task, signal its group and recycle it.
+ * @pool: the pool.
+ * @self: the calling worker, NULL for other threads.
+ * @task: the task.
+ *
+ * The group may go out of scope as soon as its count reaches 0, so the
+ * waiters are woken through the pool rather than the group.
+ */
+static void tp_task_run(
+	thread_pool *const restrict pool, struct tp_worker *const restrict self,
+	struct tp_task *const task
+)
+{
+	tp_group *const group = task->group;
+
+	task->func(task->arg);
+	if (self && self->n_free < TPOOL_TASK_CACHE)
+	{
+		task->next = self->free_tasks;
+		self->free_tasks = task;
+		++(self->n_free);
+	}
+	else
+		free(task);
+
+	if (atomic_fetch_sub_explicit(&group->pending, 1, memory_order_release) ==
+		1)
+		tp_wake_syncers(pool);
+}
+
+/**
+ * tp_find_task - look for a task to run.
+ * @pool: the pool.
+ * @self: the calling worker, NULL for other threads.
+ *
+ * The worker's own deque comes first, then the injection queue, then the
+ * other workers' deques starting from a random one.
+ *
+ * Return: pointer to a task, NULL if none was found.
+ */
+static struct tp_task *tp_find_task(
+	thread_pool *const restrict pool, struct tp_worker *const restrict self
+)
+{
+	void *task = NULL;
+
+	if (self && wsdq_pop_tail(self->tasks, &task))
+		return (task);
+
+	if (mpmcq_try_pop(pool->inject, &task))
+		return (task);
+
+	uint64_t seed = (uintptr_t)&task | 1;
+	const size_t start =
+		(size_t)tp_rand(self ? &self->rng : &seed) % pool->n_workers;
+
+	for (size_t i = 0; i < pool->n_workers; ++i)
+	{
+		struct tp_worker *const victim =
+			&pool->workers[(start + i) % pool->n_workers];
+		int stolen = -1;
+
+		if (victim == self)
+			continue;
+
+		while (stolen < 0)
+			stolen = wsdq_steal_head(victim->tasks, &task);
+
+		if (stolen)
+			return (task);
+	}
+
+	return (NULL);
+}
+
+/**
+ * tp_has_work - check whether any task is waiting to be run.
+ * @pool: the pool.
+ *
+ * Return: 1 if there is a task, 0 otherwise.
+ */
+static int tp_has_work(const thread_pool *const restrict pool)
+{
+	if (mpmcq_len(pool->inject))
+		return (1);
+
+	for (size_t i = 0; i < pool->n_workers; ++i)
+	{
+		if (wsdq_len(pool->workers[i].tasks))
+			return (1);
+	}
+
+	return (0);
+}
+
+/**
+ * tp_park - put an idle worker to sleep until work is spawned.
+ * @pool: the pool.
+ *
+ * The epoch is read before announcing the worker as parked, a spawn that
+ * happens after the last check bumps it and makes the wait return at once.
+ */
+static void tp_park(thread_pool *const restrict pool)
+{
+	const unsigned int epoch =
+		atomic_load_explicit(&pool->epoch, memory_order_seq_cst);
+
+	atomic_fetch_add_explicit(&pool->n_parked, 1, memory_order_seq_cst);
+	atomic_thread_fence(memory_order_seq_cst);
+	if (!atomic_load_explicit(&pool->stop, memory_order_seq_cst) &&
+		!tp_has_work(pool))
+		syscall(
+			SYS_futex, &pool->epoch, FUTEX_WAIT_PRIVATE, epoch, NULL, NULL, 0
+		);
+
+	atomic_fetch_sub_explicit(&pool->n_parked, 1, memory_order_relaxed);
+}
+
+/**
+ * tp_sync_park - put a thread waiting on a group to sleep until it is done.
+ * @pool: the pool the tasks of the group were spawned on.
+ * @group: the group.
+ *
+ * Only threads that are not workers park here, workers must keep running
+ * the tasks that parked workers would not be woken for.
+ */
+static void
+tp_sync_park(thread_pool *const restrict pool, tp_group *const restrict group)
+{
+	const unsigned int epoch =
+		atomic_load_explicit(&pool->sync_epoch, memory_order_seq_cst);
+
+	atomic_fetch_add_explicit(&pool->n_syncing, 1, memory_order_seq_cst);
+	atomic_thread_fence(memory_order_seq_cst);
+	if (atomic_load_explicit(&group->pending, memory_order_relaxed))
+		syscall(
+			SYS_futex, &pool->sync_epoch, FUTEX_WAIT_PRIVATE, epoch, NULL,
+			NULL, 0
+		);
+
+	atomic_fetch_sub_explicit(&pool->n_syncing, 1, memory_order_relaxed);
+}
+
+/**
+ * tp_worker_main - run tasks until the pool is deleted.
+ * @arg: the worker.
+ *
+ * Return: NULL.
+ */
+static void *tp_worker_main(void *arg)
+{
+	struct tp_worker *const self = arg;
+	thread_pool *const pool = self->pool;
+	unsigned int idle = 0;
+
+	tp_self = self;
+	for (;;)
+	{
+		struct tp_task *const task = tp_find_task(pool, self);
+
+		if (task)
+		{
+			tp_task_run(pool, self, task);
+			idle = 0;
+		}
+		else if (atomic_load_explicit(&pool->stop, memory_order_acquire))
+			break;
+		else if (++idle < TPOOL_SPINS)
+			sched_yield();
+		else
+		{
+			tp_park(pool);
+			idle = 0;
+		}
+	}
+
+	while (self->free_tasks)
+	{
+		struct tp_task *const next = self->free_tasks->next;
+
+		free(self->free_tasks);
+		self->free_tasks = next;
+	}
+
+	tp_self = NULL;
+	return (NULL);
+}
+
+/**
+ * tp_shutdown - stop the started workers of a pool and free it.
+ * @pool: the pool, possibly only partly built by `tpool_new`.
+ */
+static void tp_shutdown(thread_pool *const restrict pool)
+{
+	atomic_store_explicit(&pool->stop, 1, memory_order_seq_cst);
+	atomic_fetch_add_explicit(&pool->epoch, 1, memory_order_seq_cst);
+	syscall(
+		SYS_futex, &pool->epoch, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0
+	);
+	for (size_t i = 0; i < pool->n_started; ++i)
+		pthread_join(pool->workers[i].thread, NULL);
+
+	for (size_t i = 0; i < pool->n_workers; ++i)
+		wsdq_del(pool->workers[i].tasks, NULL);
+
+	free(pool->workers);
+	mpmcq_del(pool->inject, NULL);
+	free(pool);
+}
+
+/**
+ * tpool_new - start a pool of worker threads.
+ * @n_workers: number of workers, 0 for one per online cpu.
+ *
+ * Return: pointer to the new pool, NULL on failure.
+ */
+thread_pool *tpool_new(size_t n_workers)
+{
+	if (!n_workers)
+	{
+		const long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+		n_workers = n_cpus > 0 ? (size_t)n_cpus : 1;
+	}
+
+	thread_pool *const pool = aligned_alloc(LT_CACHE_LINE, sizeof(*pool));
+
+	if (!pool)
+		return (NULL);
+
+	atomic_init(&pool->epoch, 0);
+	atomic_init(&pool->n_parked, 0);
+	atomic_init(&pool->sync_epoch, 0);
+	atomic_init(&pool->n_syncing, 0);
+	atomic_init(&pool->stop, 0);
+	pool->n_started = 0;
+	pool->inject = mpmcq_new(TPOOL_INJECT_LEN);
+	pool->workers = calloc(n_workers, sizeof(*pool->workers));
+	pool->n_workers = pool->workers ? n_workers : 0;
+	if (!pool->inject || !pool->workers)
+	{
+		tp_shutdown(pool);
+		return (NULL);
+	}
+
+	for (size_t i = 0; i < n_workers; ++i)
+	{
+		pool->workers[i].pool = pool;
+		pool->workers[i].rng = (uint64_t)i * 0x9E3779B97F4A7C15ULL + 1;
+		pool->workers[i].tasks = wsdq_new(0);
+		if (!pool->workers[i].tasks)
+		{
+			tp_shutdown(pool);
+			return (NULL);
+		}
+	}
+
+	for (; pool->n_started < n_workers; ++(pool->n_started))
+	{
+		struct tp_worker *const w = &pool->workers[pool->n_started];
+
+		if (pthread_create(&w->thread, NULL, tp_worker_main, w))
+		{
+			tp_shutdown(pool);
+			return (NULL);
+		}
+	}
+
+	return (pool);
+}
+
+/**
+ * tpool_del - stop the workers of a pool and free it.
+ * @pool: the pool, tasks that were already spawned are run first.
+ *
+ * Must not be called from a task of the pool.
+ *
+ * Return: NULL always.
+ */
+void *tpool_del(thread_pool *const restrict pool)
+{
+	if (pool)
+		tp_shutdown(pool);
+
+	return (NULL);
+}
+
+/**
+ * tpool_group_init - initialise an empty group of tasks.
+ * @group: the group.
+ */
+void tpool_group_init(tp_group *const restrict group)
+{
+	if (group)
+		atomic_init(&group->pending, 0);
+}
+
+/**
+ * tpool_spawn - schedule a function to be run by the pool.
+ * @pool: the pool.
+ * @group: the group the task is added to.
+ * @func: the function.
+ * @arg: argument to `func`.
+ *
+ * Tasks spawned by a worker go to the tail of its own deque, where idle
+ * workers can steal them. Tasks spawned by other threads go through a shared
+ * queue. If the task cannot be queued it is run before returning.
+ *
+ * Return: 1 on success, 0 if an argument is NULL.
+ */
+int tpool_spawn(
+	thread_pool *const restrict pool, tp_group *const restrict group,
+	tp_task_func *func, void *const arg
+)
+{
+	if (!pool || !group || !func)
+		return (0);
+
+	struct tp_worker *const self = tp_worker_of(pool);
+	struct tp_task *const task = tp_task_new(self);
+
+	if (!task)
+	{
+		func(arg);
+		return (1);
+	}
+
+	*task = (struct tp_task){.func = func, .arg = arg, .group = group};
+	atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+	if (self ? !wsdq_push_tail(self->tasks, task)
+			 : !mpmcq_try_push(pool->inject, task))
+	{
+		tp_task_run(pool, self, task);
+		return (1);
+	}
+
+	tp_wake(pool);
+	return (1);
+}
+
+/**
+ * tpool_sync - wait for all the tasks of a group to finish.
+ * @pool: the pool the tasks were spawned on.
+ * @group: the group.
+ *
+ * The calling thread runs tasks of the pool while it waits, so a task may
+ * spawn subtasks and sync on them without tying up its worker. Other threads
+ * park once they run out of tasks, until the group's last task finishes.
+ */
+void tpool_sync(
+	thread_pool *const restrict pool, tp_group *const restrict group
+)
+{
+	if (!pool || !group)
+		return;
+
+	struct tp_worker *const self = tp_worker_of(pool);
+	unsigned int idle = 0;
+
+	while (atomic_load_explicit(&group->pending, memory_order_acquire))
+	{
+		struct tp_task *const task = tp_find_task(pool, self);
+
+		if (task)
+		{
+			tp_task_run(pool, self, task);
+			idle = 0;
+		}
+		else if (++idle > TPOOL_SPINS && self)
+			sched_yield();
+		else if (idle > TPOOL_SPINS)
+		{
+			tp_sync_park(pool, group);
+			idle = 0;
+		}
+	}
+}
+
+/**
+ * tpool_size - number of workers of a pool.
+ * @pool: the pool.
+ *
+ * Return: the number of workers.
+ */
+size_t tpool_size(const thread_pool *const restrict pool)
+{
+	return (pool ? pool->n_workers : 0);
+}
@@ -0,0 +1,51 @@
+#ifndef DS_THREAD_POOL_H
+#define DS_THREAD_POOL_H
+
+#include <stdatomic.h> /* atomic_size_t */
+#include <stddef.h>    /* size_t */
+
+#include "attribute_macros.h"
+
+typedef struct thread_pool thread_pool;
+
+/**
+ * tp_task_func - a function run by the pool.
+ * @arg: the argument given to `tpool_spawn`.
+ */
+typedef void(tp_task_func)(void *arg);
+
+/**
+ * struct tp_group - a set of tasks that can be waited on together.
+ * @pending: number of spawned tasks that have not finished yet.
+ *
+ * Groups are usually local variables of the function that spawns the tasks,
+ * initialise them with `tpool_group_init` and wait on them with `tpool_sync`
+ * before they go out of scope.
+ */
+typedef struct tp_group
+{
+	atomic_size_t pending;
+} tp_group;
+
+/* alloc and free */
+
+void *tpool_del(thread_pool *const restrict pool);
+thread_pool *
+tpool_new(const size_t n_workers) ATTR_MALLOC ATTR_MALLOC_FREE(tpool_del);
+
+/* fork-join */
+
+void tpool_group_init(tp_group *const restrict group);
+int tpool_spawn(
+	thread_pool *const restrict pool, tp_group *const restrict group,
+	tp_task_func *func, void *const arg
+);
+void tpool_sync(
+	thread_pool *const restrict pool, tp_group *const restrict group
+);
+
+/* info */
+
+size_t tpool_size(const thread_pool *const restrict pool);
+
+#endif /* DS_THREAD_POOL_H */